@@ -40,6 +40,16 @@
 
 char * video_screen8 = NULL;
 
+#ifndef __ARM__
+/* the PC screen is 32 bit: the emulator draws its picture in 0xRRGGBB
+   in video_screen32 too, see dump_video32() */
+unsigned * video_screen32 = NULL;
+static Uint32 palette32[256];
+/* per line, the columns the menus have drawn over since the last frame
+   drawn, see video_overlay() */
+static short overlay_x0[240], overlay_x1[240];
+#endif
+
 SDL_Surface * screen = NULL ;
 SDL_Joystick * joy = NULL;
 
@@ -65,7 +75,12 @@ void set_palette(palette_t palette){
 		sdlpalette[i].g = palette[i].g;
 		sdlpalette[i].b = palette[i].b;
 	}
+#ifdef __ARM__
 	SDL_SetColors( screen, sdlpalette, 0, 256 );
+#else
+	for(i=0;i < 256;i++)
+		palette32[i] = SDL_MapRGB( screen->format, sdlpalette[i].r, sdlpalette[i].g, sdlpalette[i].b );
+#endif
 }
 
 unsigned long getTicks(){
@@ -316,7 +331,7 @@ void microlib_init()
 #ifdef __ARM__
         screen = SDL_SetVideoMode( 320, 240, 8, SDL_HWPALETTE | SDL_DOUBLEBUF | SDL_HWSURFACE );
 #else
-        screen = SDL_SetVideoMode( 640, 480, 8, SDL_HWPALETTE | SDL_DOUBLEBUF | SDL_HWSURFACE );
+        screen = SDL_SetVideoMode( 640, 480, 32, SDL_DOUBLEBUF | SDL_HWSURFACE );
 #endif
         if ( !screen ) return;
         SDL_ShowCursor( 0 ) ;
@@ -331,6 +346,9 @@ void microlib_init()
         SDL_JoystickUpdate() ;
 
         video_screen8 = malloc( 320 * 240 );
+#ifndef __ARM__
+        video_screen32 = malloc( 320 * 240 * sizeof(unsigned) );
+#endif
 
     	mixerfd  = open("/dev/mixer", O_RDWR);
 
@@ -340,6 +358,42 @@ void microlib_init()
 }
 
 
+#ifndef __ARM__
+/* video_screen8 at twice its size through the palette, or outside what
+   the menus have drawn over the frame, video_screen32 */
+static void double_video(int picture32)
+{
+    int x, y, i = 0, x0, x1;
+    int rs = screen->format->Rshift, gs = screen->format->Gshift, bs = screen->format->Bshift;
+    Uint32 a = screen->format->Amask, v, c;
+    Uint32 * p, * q;
+
+    if ( SDL_MUSTLOCK( screen ) ) SDL_LockSurface( screen ) ;
+
+    for ( y = 0; y < 240; y++ )
+    {
+        p = (Uint32 *)((char *)screen->pixels + 2 * y * screen->pitch);
+        q = (Uint32 *)((char *)p + screen->pitch);
+        x0 = picture32 ? overlay_x0[y] : 0;
+        x1 = picture32 ? overlay_x1[y] : 320;
+        for ( x = 0; x < 320; x++, i++ )
+        {
+            if ( x < x0 || x >= x1 )
+            {
+                v = video_screen32[i];
+                c = (v >> 16) << rs | (v >> 8 & 0xFF) << gs | (v & 0xFF) << bs | a;
+            }
+            else
+                c = palette32[(unsigned char)video_screen8[i]];
+            *(q++) = *(p++) = c;
+            *(q++) = *(p++) = c;
+        }
+    }
+    if ( SDL_MUSTLOCK( screen ) ) SDL_UnlockSurface( screen ) ;
+    SDL_Flip( screen ) ;
+}
+#endif
+
 void dump_video()
 {
 #ifdef __ARM__
@@ -348,33 +402,47 @@ void dump_video()
     if ( SDL_MUSTLOCK( screen ) ) SDL_UnlockSurface( screen ) ;
     SDL_Flip( screen ) ;
 #else
-    int height = 240, width = 320, w;
-    int incr = width * 2;
-    char * q, *p, *s;
+    double_video( 0 );
+#endif
+}
 
-    if ( SDL_MUSTLOCK( screen ) ) SDL_LockSurface( screen ) ;
+#ifndef __ARM__
+/* the emulator has just drawn a frame: nothing is over it yet */
+void video_frame_drawn(void)
+{
+    int y;
 
-    s = video_screen8;
-    p = screen->pixels;
-    q = p + incr;
+    for ( y = 0; y < 240; y++ ) overlay_x0[y] = overlay_x1[y] = 0;
+}
 
-    while ( height-- )
+/* the menus draw in palette indices over video_screen8 and say where,
+   dump_video32() shows those lines' columns from x to x+w-1 (and any
+   in between) through the palette */
+void video_overlay(int x, int y, int w, int h)
+{
+    if ( x < 0 ) w += x, x = 0;
+    if ( y < 0 ) h += y, y = 0;
+    if ( x + w > 320 ) w = 320 - x;
+    if ( y + h > 240 ) h = 240 - y;
+    for ( ; h > 0 && w > 0; h--, y++ )
     {
-        int w = width;
-        while ( w-- )
+        if ( overlay_x0[y] == overlay_x1[y] ) overlay_x0[y] = x, overlay_x1[y] = x + w;
+        else
         {
-            *(q++) = *(p++) = *s;
-            *(q++) = *(p++) = *s;
-            s++;
+            if ( x < overlay_x0[y] ) overlay_x0[y] = x;
+            if ( x + w > overlay_x1[y] ) overlay_x1[y] = x + w;
         }
-        q += incr ;
-        p += incr ;
     }
-    if ( SDL_MUSTLOCK( screen ) ) SDL_UnlockSurface( screen ) ;
-    SDL_Flip( screen ) ;
-#endif
 }
 
+/* the frame in 32 bit colour, so ULAplus palette changes show from the
+   line they were made on, under what the menus have drawn over it */
+void dump_video32(void)
+{
+    double_video( 1 );
+}
+#endif
+
 long joystick_read()
 {
     int i;
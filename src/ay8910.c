@@ -423,6 +423,28 @@ int rng=1;
 int noise_toggle=0;
 int env_first=1,env_rev=0,env_counter=15;
 
+/* AY and beeper state of the selected machine, see ZX_SelectMachine;
+   the change lists only hold the frame being run, the output side
+   (buffers, stereo, levels) belongs to the host */
+MachineVar ay_vars[] =
+{
+  MACHINE_VAR(ay_is_in_use),
+  MACHINE_VAR(sound_oldpos), MACHINE_VAR(sound_fillpos),
+  MACHINE_VAR(sound_oldval), MACHINE_VAR(sound_oldval_orig),
+  MACHINE_VAR(ay_tone_tick), MACHINE_VAR(ay_tone_high),
+  MACHINE_VAR(ay_noise_tick),
+  MACHINE_VAR(ay_tone_subcycles), MACHINE_VAR(ay_env_subcycles),
+  MACHINE_VAR(ay_env_internal_tick), MACHINE_VAR(ay_env_tick),
+  MACHINE_VAR(ay_tone_period), MACHINE_VAR(ay_noise_period),
+  MACHINE_VAR(ay_env_period),
+  MACHINE_VAR(beeper_last_subpos),
+  MACHINE_VAR(sound_ay_registers),
+  MACHINE_VAR(ay_change_count), MACHINE_VAR(beep_change_count),
+  MACHINE_VAR(rng), MACHINE_VAR(noise_toggle),
+  MACHINE_VAR(env_first), MACHINE_VAR(env_rev), MACHINE_VAR(env_counter),
+  { NULL, 0 }
+};
+
 
 void sound_ay_overlay(void)
 {
@@ -815,6 +837,7 @@ void inline sound_beeper_0(int on, unsigned long tstates/*1, unsigned long tstat
 //////
 
   if(!sound_enabled) return ;
+  if(beep_change_count>=AY_CHANGE_MAX) return;
      
   if(beep_change_count>0)//???
   {
@@ -839,6 +862,7 @@ void inline sound_beeper_1(int on, unsigned long tstates)
 {
   
   if(!sound_enabled) return ;
+  if(beep_change_count>=AY_CHANGE_MAX) return;
 	
   beep_change[beep_change_count].tstates=tstates;
   int newpos=(tstates*sound_framesiz)/tsmax;
@@ -0,0 +1,413 @@
+/*
+ * Headless Z80 core throughput benchmark.
+ *
+ * Loads each snapshot given on the command line through ZX_LoadGame
+ * (LoadZ80/LoadSNA), runs it for a number of frames through JustRun with
+ * rendering skipped and prints the per-core counters gathered by the
+ * Z80_PROFILE build of cpu/z80.c as JSON on stdout.  Without arguments
+ * the 48K and 128K ROMs are benchmarked from reset.  With -m every one
+ * is run on several machines (ZX_NewMachine) stepped in turn, which have
+ * to end up in the same state, -s checks that a run replays the same
+ * from an in-memory state (ZX_StateSave) and times packing the state
+ * with zxlz.c against bzip2, -r that it replays the same after going
+ * back through the rewind buffer.  With -a every frame is run through
+ * ZX_RunAhead, which has to leave the same state as running it alone.
+ * With -p every frame is drawn too, in the window, full screen or the
+ * window in 32 bit colour, and a hash of all the pictures is printed.
+ * -t and -x run the core conformance
+ * checks of bench/conform.c instead.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "microlib.h"
+#include "shared.h"
+#include "conform.h"
+#include "zxlz.h"
+#include "bzip/bzlib.h"
+
+#ifndef Z80_PROFILE
+#error "the benchmark needs cpu/z80.c built with -DZ80_PROFILE"
+#endif
+
+/* host side of the emulator, normally provided by main.c/microlib */
+MCONFIG mconfig;
+static unsigned char screen[320 * 240];
+static unsigned screen32[320 * 240];
+unsigned char *Picture = screen;
+extern int full_screen;
+extern unsigned *Picture32;
+
+void set_emupalette() {}
+int sound_send(void *samples, int nsamples) { return nsamples; }
+
+#define MAX_MACHINES 64
+
+static const char *core_names[Z80_CORES] = { "Z80Run", "Z80Run_NC", "Z80Run_NCNI" };
+
+static unsigned long long clock_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* FNV-1a over RAM and CPU state, to tell whether a core change altered
+   what the emulated machine did and not just how fast it did it */
+static unsigned state_hash(void)
+{
+    Z80Regs *r = spectrumZ80;
+    unsigned h = 2166136261u;
+    unsigned v[] = { r->AF.W, r->BC.W, r->DE.W, r->HL.W, r->IX.W, r->IY.W,
+                     r->SP.W, r->PC.W, r->AFs.W, r->BCs.W, r->DEs.W, r->HLs.W,
+                     r->I, r->R, r->IFF1, r->IFF2, r->IM, r->halted, r->ICount };
+    int n;
+
+    for (n = 0; n < 16384 * 8; n++)
+        h = (h ^ RAM_pages[n]) * 16777619u;
+    for (n = 0; n < (int)(sizeof(v) / sizeof(v[0])); n++)
+        h = (h ^ v[n]) * 16777619u;
+    return h;
+}
+
+static void load_one(const char *name, int rom_model)
+{
+    if (name)
+    {
+        if (!LoadGameFile(name))    /* mapped as GAME, as load_game does */
+        {
+            fprintf(stderr, "bench: can't load %s\n", name);
+            exit(1);
+        }
+        ZX_LoadGame(ZX_128, 0, 0);
+    }
+    else
+        ZX_Reset(rom_model);
+}
+
+/* saves a state after every frame, then goes back to the one of the
+   middle frame and runs the second half again, which has to end the same */
+static int check_states(int frames, double *save_us, double *load_us)
+{
+    static unsigned char state[ZX_STATE_MAX], middle[ZX_STATE_MAX];
+    unsigned long long t0, save_ns = 0;
+    unsigned hash;
+    int n, size, middle_size = 0, ok;
+
+    for (n = 0; n < frames; n++)
+    {
+        ZX_Frame(1);
+        t0 = clock_ns();
+        size = ZX_StateSave(state, sizeof(state), ZX_CHUNK_ALL);
+        save_ns += clock_ns() - t0;
+        if (n == frames / 2)
+        {
+            memcpy(middle, state, size);
+            middle_size = size;
+        }
+    }
+    hash = state_hash();
+
+    t0 = clock_ns();
+    ok = ZX_StateLoad(middle, middle_size);
+    *load_us = (clock_ns() - t0) / 1e3;
+    *save_us = save_ns / 1e3 / frames;
+
+    for (n = frames / 2 + 1; n < frames; n++)
+        ZX_Frame(1);
+    return ok && state_hash() == hash;
+}
+
+/* packs the machine's state with zxlz and with bzip2 at the level .sav
+   files used, the zxlz one has to unpack to the same bytes */
+static int check_packing(int *size, int *zxlz_size, double *zxlz_us, double *unpack_us,
+                         int *bzip2_size, double *bzip2_us)
+{
+    static unsigned char state[ZX_STATE_MAX], back[ZX_STATE_MAX];
+    static unsigned char packed[ZXLZ_BOUND(ZX_STATE_MAX)];
+    unsigned long long t0;
+    unsigned length = sizeof(packed);
+    int n;
+
+    *size = ZX_StateSave(state, sizeof(state), ZX_CHUNK_ALL);
+
+    t0 = clock_ns();
+    *zxlz_size = zxlz_compress(packed, state, *size);
+    *zxlz_us = (clock_ns() - t0) / 1e3;
+    t0 = clock_ns();
+    n = zxlz_uncompress(back, sizeof(back), packed, *zxlz_size);
+    *unpack_us = (clock_ns() - t0) / 1e3;
+    if (n != *size || memcmp(back, state, n)) return 0;
+
+    t0 = clock_ns();
+    BZ2_bzBuffToBuffCompress((char *)packed, &length, (char *)state, *size, 4, 0, 30);
+    *bzip2_us = (clock_ns() - t0) / 1e3;
+    *bzip2_size = length;
+    return 1;
+}
+
+/* pushes every frame into the rewind buffer, seeks to frames all over
+   what it kept, then goes on from the middle one and runs the second
+   half again, which has to end the same */
+static int check_rewind(int frames, double *push_us, double *frame_bytes, int *kept)
+{
+    unsigned *hash = malloc(frames * sizeof(unsigned));
+    unsigned long long t0, push_ns = 0;
+    int n, back, middle, ok = 1;
+
+    rewind_reset();
+    for (n = 0; n < frames; n++)
+    {
+        ZX_Frame(1);
+        t0 = clock_ns();
+        rewind_push();
+        push_ns += clock_ns() - t0;
+        hash[n] = state_hash();
+    }
+    *push_us = push_ns / 1e3 / frames;
+    *kept = rewind_frames();
+    *frame_bytes = (double)rewind_used() / (*kept + 1);
+
+    for (back = *kept; back >= 0; back -= 37)
+        ok &= rewind_seek(back) == back && state_hash() == hash[frames - 1 - back];
+    ok &= rewind_seek(0) == 0 && state_hash() == hash[frames - 1];
+
+    middle = frames - 1 - *kept / 2;
+    rewind_seek(frames - 1 - middle);
+    for (n = middle + 1; n < frames; n++)
+    {
+        ZX_Frame(1);
+        rewind_push();
+    }
+    ok &= state_hash() == hash[frames - 1];
+    free(hash);
+    return ok;
+}
+
+static void bench_one(const char *name, int rom_model, int frames, int machines, int ahead, int states, int rewind, int picture, int first)
+{
+    ZXMachine *machine[MAX_MACHINES];
+    unsigned long long t0, t1, ns, tstates = 0;
+    unsigned hash, picture_hash = 2166136261u;
+    int n, m, i, agree = 1;
+
+    load_one(name, rom_model);
+    machine[0] = ZX_SelectMachine(NULL);
+    for (m = 1; m < machines; m++)
+    {
+        machine[m] = ZX_NewMachine(ZX_48);
+        if (machine[m] == NULL)
+        {
+            fprintf(stderr, "bench: out of memory for machine %d\n", m);
+            exit(1);
+        }
+        load_one(name, rom_model);
+    }
+
+    memset(z80_profile, 0, sizeof(z80_profile));
+
+    if (picture >= 0)
+    {
+        full_screen = picture == 1;
+        Picture32 = picture == 2 ? screen32 : NULL;
+    }
+    t0 = clock_ns();
+    for (n = 0; n < frames; n++)
+        for (m = 0; m < machines; m++)
+        {
+            ZX_SelectMachine(machine[m]);
+            ZX_RunAhead(ahead, picture < 0);
+            if (picture >= 0)
+            {
+                t1 = clock_ns();
+                if (picture == 2)
+                    for (i = 0; i < 320 * 240; i++)
+                        picture_hash = (picture_hash ^ screen32[i]) * 16777619u;
+                else
+                    for (i = 0; i < (int)sizeof(screen); i++)
+                        picture_hash = (picture_hash ^ screen[i]) * 16777619u;
+                t0 += clock_ns() - t1;  /* not part of the timing */
+            }
+        }
+    ns = clock_ns() - t0;
+
+    ZX_SelectMachine(NULL);
+    hash = state_hash();
+    for (m = 1; m < machines; m++)
+    {
+        ZX_SelectMachine(machine[m]);
+        agree &= state_hash() == hash;
+        ZX_FreeMachine(machine[m]);
+    }
+
+    for (n = 0; n < Z80_CORES; n++)
+        tstates += z80_profile[n].tstates;
+
+    printf("%s    {\n", first ? "" : ",\n");
+    printf("      \"file\": \"%s\",\n", name ? name : (rom_model == ZX_48 ? "rom48" : "rom128"));
+    printf("      \"model\": %d,\n", model);
+    printf("      \"contention\": %d,\n", mconfig.contention);
+    printf("      \"frames\": %d,\n", frames);
+    printf("      \"machines\": %d,\n", machines);
+    printf("      \"run_ahead\": %d,\n", ahead);
+    printf("      \"seconds\": %.6f,\n", ns / 1e9);
+    printf("      \"fps\": %.2f,\n", frames * machines * 1e9 / ns);
+    printf("      \"tstates_per_sec\": %.0f,\n", tstates * 1e9 / ns);
+    printf("      \"state_hash\": \"%08x\",\n", hash);
+    printf("      \"machines_agree\": %s,\n", agree ? "true" : "false");
+    if (picture >= 0)
+        printf("      \"picture_hash\": \"%08x\",\n", picture_hash);
+    printf("      \"cores\": {\n");
+    for (n = 0; n < Z80_CORES; n++)
+    {
+        Z80Profile *p = &z80_profile[n];
+        double sec = p->ns / 1e9;
+
+        printf("        \"%s\": { \"calls\": %llu, \"instructions\": %llu, \"tstates\": %llu, "
+               "\"seconds\": %.6f, \"tstates_per_sec\": %.0f, \"ns_per_instruction\": %.3f }%s\n",
+               core_names[n], p->calls, p->ops, p->tstates, sec,
+               p->ns ? p->tstates / sec : 0.0,
+               p->ops ? (double)p->ns / p->ops : 0.0,
+               n < Z80_CORES - 1 ? "," : "");
+    }
+    printf("      }");
+    if (states)
+    {
+        double save_us, load_us;
+        int replay = check_states(frames, &save_us, &load_us);
+
+        printf(",\n      \"state_save_us\": %.3f,\n", save_us);
+        printf("      \"state_load_us\": %.3f,\n", load_us);
+        printf("      \"state_replay\": %s", replay ? "true" : "false");
+    }
+    if (states)
+    {
+        int size, zxlz_size, bzip2_size = 0;
+        double zxlz_us, unpack_us, bzip2_us = 0;
+        int roundtrip = check_packing(&size, &zxlz_size, &zxlz_us, &unpack_us, &bzip2_size, &bzip2_us);
+
+        printf(",\n      \"state_bytes\": %d,\n", size);
+        printf("      \"zxlz_bytes\": %d,\n", zxlz_size);
+        printf("      \"zxlz_pack_us\": %.3f,\n", zxlz_us);
+        printf("      \"zxlz_unpack_us\": %.3f,\n", unpack_us);
+        printf("      \"bzip2_bytes\": %d,\n", bzip2_size);
+        printf("      \"bzip2_pack_us\": %.3f,\n", bzip2_us);
+        printf("      \"zxlz_roundtrip\": %s", roundtrip ? "true" : "false");
+    }
+    if (rewind)
+    {
+        double push_us, frame_bytes;
+        int kept, replay = check_rewind(frames, &push_us, &frame_bytes, &kept);
+
+        printf(",\n      \"rewind_push_us\": %.3f,\n", push_us);
+        printf("      \"rewind_bytes_per_frame\": %.0f,\n", frame_bytes);
+        printf("      \"rewind_frames\": %d,\n", kept);
+        printf("      \"rewind_replay\": %s", replay ? "true" : "false");
+    }
+    printf("\n    }");
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: xpectrum-bench [-n frames] [-c 0|1] [-m machines] [-a frames] [-s] [-r] [-p 0|1|2] [snapshot.z80|snapshot.sna ...]\n"
+            "       xpectrum-bench -t trials [-v]\n"
+            "       xpectrum-bench [-c 0|1] -x exerciser.com\n"
+            "  -n frames   frames to run per snapshot (default 500)\n"
+            "  -c 0|1      emulate memory contention (default 1)\n"
+            "  -m machines run that many machines side by side (default 1)\n"
+            "  -a frames   run that many frames ahead of every frame (default 0)\n"
+            "  -s          also time ZX_StateSave/ZX_StateLoad, replay from a state and pack it\n"
+            "  -r          also time rewind_push and replay from rewound frames\n"
+            "  -p 0|1|2    also draw every frame, in the window, full screen or the\n"
+            "              window in 32 bit colour\n"
+            "  -t trials   compare all opcodes on the three cores, trials states each\n"
+            "  -v          print every mismatch\n"
+            "  -x file     run a CP/M instruction exerciser (zexdoc.com, zexall.com)\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    Z80Regs regs_z80;
+    int frames = 500, contention = 1, machines = 1, ahead = 0, states = 0, rewind = 0, picture = -1, trials = 0, verbose = 0;
+    const char *exerciser = NULL;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "n:c:m:a:srp:t:vx:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': frames = atoi(optarg); break;
+            case 'c': contention = atoi(optarg); break;
+            case 'm': machines = atoi(optarg); break;
+            case 'a': ahead = atoi(optarg); break;
+            case 's': states = 1; break;
+            case 'r': rewind = 1; break;
+            case 'p': picture = atoi(optarg); break;
+            case 't': trials = atoi(optarg); break;
+            case 'v': verbose = 1; break;
+            case 'x': exerciser = optarg; break;
+            default: usage();
+        }
+    }
+    if (frames <= 0 || machines <= 0 || machines > MAX_MACHINES || ahead < 0) usage();
+
+    mconfig.id = 0xABCD0019;
+    mconfig.contention = contention;
+    mconfig.sound_mode = 0;
+    mconfig.sound_freq = 44100;
+    mconfig.speed_mode = 100;
+    mconfig.flash_loading = 1;
+    mconfig.ula64 = 1;
+
+    spectrumZ80 = &regs_z80;
+    tape_init();
+    ZX_Init();
+    if (rewind && !rewind_init(frames / REWIND_FPS + 1, REWIND_BUDGET))
+    {
+        fprintf(stderr, "bench: out of memory for the rewind buffer\n");
+        return 1;
+    }
+
+    if (trials > 0 || exerciser)
+    {
+        i = exerciser ? conform_cpm(exerciser, contention) : conform_opcodes(trials, verbose);
+        tape_finish();
+        return i ? 1 : 0;
+    }
+
+    printf("{\n  \"results\": [\n");
+    if (optind == argc)
+    {
+        bench_one(NULL, ZX_48, frames, machines, ahead, states, rewind, picture, 1);
+        bench_one(NULL, ZX_128, frames, machines, ahead, states, rewind, picture, 0);
+    }
+    else
+        for (i = optind; i < argc; i++)
+            bench_one(argv[i], 0, frames, machines, ahead, states, rewind, picture, i == optind);
+    printf("\n  ]\n}\n");
+
+    tape_finish();
+    return 0;
+}
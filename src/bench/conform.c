@@ -0,0 +1,706 @@
+/*
+ * Z80 core conformance checks for the benchmark.
+ *
+ * conform_opcodes() runs every opcode of opcodes.c, op_cb.c, op_ed.c,
+ * op_dd_fd.c and opddfdcb.c from a number of random register and memory
+ * states through Z80Run, Z80Run_NC and Z80Run_NCNI with contention off,
+ * and through the reference Z80 of z80ref.c. All three cores have to
+ * agree with it on registers, flags, memory and ICount, the T-states
+ * of the instruction. A few loops are run for a slice the same way, for
+ * the idle loop skipping of the uncontended cores and the batched block
+ * instructions, and one with a tape inserted, for the loader hook
+ * behind IN. The straight line opcodes of each group are then timed on
+ * each core. Last a block is loaded from tape through the ROM, frame by
+ * frame, with flash loading off.
+ *
+ * conform_cpm() boots a CP/M instruction exerciser such as zexdoc or
+ * zexall with just enough of BDOS (functions 2 and 9) to print its
+ * results.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "microlib.h"
+#include "shared.h"
+#include "conform.h"
+#include "z80ref.h"
+#include "zxtape.h"
+
+/* zx.c and snaps.c internals the checks have to set up by hand */
+extern byte MEMc[4], MEMs[4];
+extern int outwrites;
+extern byte Z80InPort(word port);
+extern MCONFIG mconfig;
+extern int tstates_prev_B, successive_reads;
+extern byte last_b_read;
+
+typedef word (*Z80Core)(Z80Regs *, int);
+
+static const Z80Core cores[Z80_CORES] = { Z80Run, Z80Run_NC, Z80Run_NCNI };
+static const char *core_names[Z80_CORES] = { "Z80Run", "Z80Run_NC", "Z80Run_NCNI" };
+static const char reference_name[] = "reference";
+
+/* ICount the single steps start from: below IIntTime, so Z80Run_NC
+   doesn't interrupt */
+#define STEP_ICOUNT 1000
+
+#define RAM_SIZE 0x10000
+
+static unsigned rnd_state = 0x2545f491;
+
+static unsigned rnd(void)
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/* 64K of uncontended RAM, RAM pages 0-3 in a row, and no contended
+   lines, so the ULA port isn't contended and the floating bus reads 0xFF */
+static void flat_ram(void)
+{
+    int n;
+
+    for (n = 0; n < 4; n++)
+    {
+        MEMr[n] = MEMw[n] = RAM_pages;
+        MEMc[n] = MEMs[n] = 0;
+    }
+    ula_timing.length = 0;
+}
+
+static unsigned ram_hash(const byte *ram)
+{
+    unsigned h = 2166136261u;
+    int n;
+
+    for (n = 0; n < RAM_SIZE; n++)
+        h = (h ^ ram[n]) * 16777619u;
+    return h;
+}
+
+/*--- opcode groups ----------------------------------------------------*/
+
+typedef struct
+{
+    const char *name;
+    byte prefix[2];
+    int nprefix;
+    int displaced;                 /* DD CB d op: the opcode comes last */
+}
+OpGroup;
+
+static const OpGroup groups[] =
+{
+    { "base", { 0 }, 0, 0 },
+    { "cb", { 0xCB }, 1, 0 },
+    { "ed", { 0xED }, 1, 0 },
+    { "dd", { 0xDD }, 1, 0 },
+    { "fd", { 0xFD }, 1, 0 },
+    { "ddcb", { 0xDD, 0xCB }, 2, 1 },
+    { "fdcb", { 0xFD, 0xCB }, 2, 1 },
+};
+
+#define NGROUPS ((int)(sizeof(groups) / sizeof(groups[0])))
+
+/* prefixes have their own group, and ED 3F is the tape loading trap */
+static int skip_opcode(const OpGroup *g, int op)
+{
+    if (g->nprefix == 0)
+        return op == 0xCB || op == 0xDD || op == 0xED || op == 0xFD;
+    if (g->nprefix == 1 && g->prefix[0] != 0xCB && op == 0xCB)
+        return 1;
+    return g->prefix[0] == 0xED && op == TRAPLOAD;
+}
+
+/* where the cores knowingly part from the reference: they take ED ED
+   as 12 T-states that leave PC on the second ED, see op_ed.c, rather
+   than as two NOPs. These are only checked core against core */
+static int known_difference(const OpGroup *g, int op)
+{
+    return g->nprefix == 1 && g->prefix[0] == 0xED && op == 0xED;
+}
+
+/* instruction bytes, operands (or d) from operand[] */
+static int opcode_bytes(const OpGroup *g, int op, const byte *operand, byte *out)
+{
+    int n;
+
+    for (n = 0; n < g->nprefix; n++)
+        out[n] = g->prefix[n];
+    if (g->displaced)
+    {
+        out[n++] = operand[0];
+        out[n++] = op;
+        return n;
+    }
+    out[n++] = op;
+    out[n++] = operand[0];
+    out[n++] = operand[1];
+    return n;
+}
+
+/*--- single steps -----------------------------------------------------*/
+
+typedef struct
+{
+    Z80Regs regs;
+    unsigned ram;
+    int outs;
+}
+CpuState;
+
+static void run_step(int core, const Z80Regs *start, const byte *ram, CpuState *out)
+{
+    memcpy(RAM_pages, ram, RAM_SIZE);
+    *spectrumZ80 = *start;
+    outwrites = 0;
+    cores[core](spectrumZ80, 1);
+    out->regs = *spectrumZ80;
+    out->ram = ram_hash(RAM_pages);
+    out->outs = outwrites;
+}
+
+/* the same step on the reference, ports read from the emulator */
+static void run_reference(const Z80Regs *start, const byte *ram, CpuState *out)
+{
+    static byte copy[RAM_SIZE];
+
+    memcpy(copy, ram, RAM_SIZE);
+    out->regs = *start;
+    z80ref_step(&out->regs, copy, Z80InPort);
+    out->ram = ram_hash(copy);
+    out->outs = 0;
+}
+
+/* prints what differs and returns the number of fields */
+static int compare_states(const CpuState *a, const CpuState *b, int verbose)
+{
+    static const char *names[] =
+    {
+        "AF", "BC", "DE", "HL", "IX", "IY", "SP", "PC", "AF'", "BC'", "DE'", "HL'",
+        "I", "R", "IFF1", "IFF2", "IM", "halted", "ICount", "RAM"
+    };
+    const Z80Regs *x = &a->regs, *y = &b->regs;
+    unsigned va[] = { x->AF.W, x->BC.W, x->DE.W, x->HL.W, x->IX.W, x->IY.W, x->SP.W,
+                      x->PC.W, x->AFs.W, x->BCs.W, x->DEs.W, x->HLs.W, x->I, x->R,
+                      x->IFF1, x->IFF2, x->IM, x->halted, x->ICount, a->ram };
+    unsigned vb[] = { y->AF.W, y->BC.W, y->DE.W, y->HL.W, y->IX.W, y->IY.W, y->SP.W,
+                      y->PC.W, y->AFs.W, y->BCs.W, y->DEs.W, y->HLs.W, y->I, y->R,
+                      y->IFF1, y->IFF2, y->IM, y->halted, y->ICount, b->ram };
+    int n, diffs = 0;
+
+    for (n = 0; n < (int)(sizeof(va) / sizeof(va[0])); n++)
+        if (va[n] != vb[n])
+        {
+            if (verbose)
+                fprintf(stderr, " %s %04x/%04x", names[n], va[n], vb[n]);
+            diffs++;
+        }
+    return diffs;
+}
+
+static void random_state(Z80Regs *regs, byte *ram, const byte *code, int len)
+{
+    int n;
+
+    for (n = 0; n < RAM_SIZE; n++)
+        ram[n] = rnd();
+
+    regs->AF.W = rnd(); regs->BC.W = rnd(); regs->DE.W = rnd(); regs->HL.W = rnd();
+    regs->IX.W = rnd(); regs->IY.W = rnd(); regs->SP.W = rnd();
+    regs->AFs.W = rnd(); regs->BCs.W = rnd(); regs->DEs.W = rnd(); regs->HLs.W = rnd();
+    regs->I = rnd(); regs->R = rnd(); regs->R7 = regs->R;
+    regs->IFF1 = regs->IFF2 = rnd() & 1;
+    regs->IM = rnd() % 3;
+    regs->halted = 0;
+    regs->DecodingErrors = 0;
+    regs->PC.W = rnd();
+    regs->ICount = STEP_ICOUNT;
+
+    for (n = 0; n < len; n++)
+        ram[(word)(regs->PC.W + n)] = code[n];
+}
+
+/*--- throughput -------------------------------------------------------*/
+
+#define PROGRAM_ORG 0x8000
+
+/* points the registers somewhere harmless before every pass */
+static const byte program_prologue[] =
+{
+    0x31, 0x00, 0xF0,             /* LD SP,F000 */
+    0x21, 0x00, 0xC0,             /* LD HL,C000 */
+    0x11, 0x00, 0xC1,             /* LD DE,C100 */
+    0x01, 0x01, 0x00,             /* LD BC,0001 */
+    0xDD, 0x21, 0x00, 0xC2,       /* LD IX,C200 */
+    0xFD, 0x21, 0x00, 0xC3,       /* LD IY,C300 */
+};
+
+static void time_group(const OpGroup *g, const int *length, double *ns_per_op)
+{
+    static const byte zero[2] = { 0, 0 };
+    byte code[8];
+    Z80Regs start;
+    int addr, op, core, n;
+
+    memset(RAM_pages, 0, RAM_SIZE);
+    addr = PROGRAM_ORG;
+    memcpy(RAM_pages + addr, program_prologue, sizeof(program_prologue));
+    addr += sizeof(program_prologue);
+    for (op = 0; op < 256; op++)
+        if (length[op])
+        {
+            opcode_bytes(g, op, zero, code);
+            memcpy(RAM_pages + addr, code, length[op]);
+            addr += length[op];
+        }
+    RAM_pages[addr++] = 0xC3;     /* JP PROGRAM_ORG */
+    RAM_pages[addr++] = PROGRAM_ORG & 0xff;
+    RAM_pages[addr++] = PROGRAM_ORG >> 8;
+
+    memset(&start, 0, sizeof(start));
+    start.PC.W = PROGRAM_ORG;
+    start.IPeriod = spectrumZ80->IPeriod;
+    start.IIntTime = spectrumZ80->IIntTime;
+
+    for (core = 0; core < Z80_CORES; core++)
+    {
+        *spectrumZ80 = start;
+        memset(z80_profile, 0, sizeof(z80_profile));
+        for (n = 0; n < 200; n++)
+        {
+            outwrites = 0;
+            spectrumZ80->ICount = 60000;
+            cores[core](spectrumZ80, 59000);
+        }
+        ns_per_op[core] = z80_profile[core].ops ?
+            (double)z80_profile[core].ns / z80_profile[core].ops : 0.0;
+    }
+}
+
+/*--- loops ------------------------------------------------------------*/
+
+/* little programs run for a slice from PROGRAM_ORG, where the idle loop
+   skipping of the uncontended cores and the batched block instructions
+   have to end up where the reference does by going round the loop every
+   time */
+typedef struct
+{
+    const char *name;
+    byte code[12];
+    int len;
+}
+LoopCase;
+
+static const LoopCase loop_cases[] =
+{
+    /* DI; LD SP,9000; L: INC SP; JR L */
+    { "inc_sp", { 0xF3, 0x31, 0x00, 0x90, 0x33, 0x18, 0xFD }, 7 },
+    /* DI; LD SP,9000; L: DEC SP; JR L */
+    { "dec_sp", { 0xF3, 0x31, 0x00, 0x90, 0x3B, 0x18, 0xFD }, 7 },
+    /* DI; L: INC SP; JP L */
+    { "inc_sp_jp", { 0xF3, 0x33, 0xC3, 0x01, 0x80 }, 5 },
+    /* DI; L: LD A,(C000); CP 1; JR NZ,L */
+    { "poll_memory", { 0xF3, 0x3A, 0x00, 0xC0, 0xFE, 0x01, 0x20, 0xF9 }, 8 },
+    /* DI; LD A,1F; L: IN A,(FE); AND 1F; CP 1F; JR Z,L */
+    { "poll_keyboard", { 0xF3, 0x3E, 0x1F, 0xDB, 0xFE, 0xE6, 0x1F, 0xFE, 0x1F, 0x28, 0xF8 }, 11 },
+    /* DI; LD HL,8000; LD DE,C000; LD BC,5000; LDIR: over itself, across
+       pages and past the end of the slice */
+    { "ldir", { 0xF3, 0x21, 0x00, 0x80, 0x11, 0x00, 0xC0, 0x01, 0x00, 0x50, 0xED, 0xB0 }, 12 },
+    /* DI; LD HL,C000; LD DE,7F00; LD BC,1000; LDIR: over the LDIR */
+    { "ldir_self", { 0xF3, 0x21, 0x00, 0xC0, 0x11, 0x00, 0x7F, 0x01, 0x00, 0x10, 0xED, 0xB0 }, 12 },
+    /* DI; LD HL,BFFF; LD DE,FFFF; LD BC,9000; LDDR: down over the LDDR */
+    { "lddr", { 0xF3, 0x21, 0xFF, 0xBF, 0x11, 0xFF, 0xFF, 0x01, 0x00, 0x90, 0xED, 0xB8 }, 12 },
+    /* DI; LD A,21; LD HL,7800; LD BC,0; CPIR: up to the LD HL */
+    { "cpir", { 0xF3, 0x3E, 0x21, 0x21, 0x00, 0x78, 0x01, 0x00, 0x00, 0xED, 0xB1 }, 11 },
+    /* DI; LD A,F3; LD HL,87FF; LD BC,0; CPDR: down to the DI */
+    { "cpdr", { 0xF3, 0x3E, 0xF3, 0x21, 0xFF, 0x87, 0x01, 0x00, 0x00, 0xED, 0xB9 }, 11 },
+};
+
+#define NLOOPS ((int)(sizeof(loop_cases) / sizeof(loop_cases[0])))
+
+/* below IIntTime all along, so nothing interrupts */
+#define LOOP_ICOUNT 60000
+#define LOOP_CYCLES 50000
+
+static int conform_loops(const Z80Regs *reset, int verbose)
+{
+    static byte ram[RAM_SIZE];
+    Z80Regs start;
+    CpuState state, reference;
+    int l, core, bad = 0;
+
+    for (l = 0; l < NLOOPS; l++)
+    {
+        memset(ram, 0, RAM_SIZE);
+        memcpy(ram + PROGRAM_ORG, loop_cases[l].code, loop_cases[l].len);
+        start = *reset;
+        start.PC.W = PROGRAM_ORG;
+        start.ICount = LOOP_ICOUNT;
+
+        memcpy(RAM_pages, ram, RAM_SIZE);
+        reference.regs = start;
+        while (reference.regs.ICount > LOOP_ICOUNT - LOOP_CYCLES)
+            z80ref_step(&reference.regs, RAM_pages, Z80InPort);
+        reference.ram = ram_hash(RAM_pages);
+
+        for (core = 0; core < Z80_CORES; core++)
+        {
+            memcpy(RAM_pages, ram, RAM_SIZE);
+            *spectrumZ80 = start;
+            cores[core](spectrumZ80, LOOP_CYCLES);
+            state.regs = *spectrumZ80;
+            state.ram = ram_hash(RAM_pages);
+            if (compare_states(&reference, &state, 0))
+            {
+                if (verbose || !bad)
+                {
+                    fprintf(stderr, "loop %s: %s vs %s:", loop_cases[l].name,
+                            reference_name, core_names[core]);
+                    compare_states(&reference, &state, 1);
+                    fprintf(stderr, "\n");
+                }
+                bad++;
+                break;
+            }
+        }
+    }
+    return bad;
+}
+
+/*--- tape hook --------------------------------------------------------*/
+
+/* the ROM's edge loop reads the ULA port with B counting up, which is
+   what loader_hook looks for to start the tape by itself. It goes by PC
+   and B at every IN, so this catches a core handing the port stale
+   registers */
+
+/* DI; L: INC B; IN A,(FE); JR L */
+static const byte edge_loop[] = { 0xF3, 0x04, 0xDB, 0xFE, 0x18, 0xFB };
+
+/* a lone 19 byte header block, only there for tape_is_tape() */
+static byte hook_tap[2 + 19] = { 19, 0 };
+
+static int conform_tape_hook(const Z80Regs *reset, int verbose)
+{
+    int core, auto_loading = mconfig.auto_loading, bad = 0;
+
+    if (tape_open(hook_tap, sizeof(hook_tap), "conform.tap", 0))
+    {
+        fprintf(stderr, "tape hook: can't insert the tape\n");
+        return 1;
+    }
+    mconfig.auto_loading = 1;
+
+    for (core = 0; core < Z80_CORES; core++)
+    {
+        tape_stop();
+        tstates_prev_B = successive_reads = 0;
+        last_b_read = 0;
+        tape_reschedule = 0;
+
+        memset(RAM_pages, 0, RAM_SIZE);
+        memcpy(RAM_pages + PROGRAM_ORG, edge_loop, sizeof(edge_loop));
+        *spectrumZ80 = *reset;
+        spectrumZ80->PC.W = PROGRAM_ORG;
+        spectrumZ80->BC.W = 0;
+        spectrumZ80->ICount = LOOP_ICOUNT;
+        cores[core](spectrumZ80, LOOP_CYCLES);
+
+        if (!tape_playing)
+        {
+            if (verbose || !bad)
+                fprintf(stderr, "tape hook: %s didn't start the tape\n",
+                        core_names[core]);
+            bad++;
+        }
+    }
+
+    tape_close();
+    mconfig.auto_loading = auto_loading;
+    return bad;
+}
+
+/*--- tape load --------------------------------------------------------*/
+
+/* LD-BYTES of the 48K ROM loads a header and a data block from a tape
+   started by the auto-loading, timed edge by edge, with every combination
+   of contention, edge loading and speed loading, and returns to a DI;
+   JR $ after each */
+#define LD_BYTES     0x0556
+#define LOAD_ORG     0x8000
+#define LOAD_HEADER  17
+#define LOAD_SIZE    256
+#define LOAD_RETURN  0x7F00
+#define LOAD_FRAMES  1000
+
+static byte load_tap[2 + 1 + LOAD_HEADER + 1 + 2 + 1 + LOAD_SIZE + 1];
+
+/* a TAP block of size bytes with the flag, returns where the next goes */
+static byte *load_block(byte *tap, byte flag, int size)
+{
+    byte check = flag;
+    int n;
+
+    tap[0] = (size + 2) & 0xff;
+    tap[1] = (size + 2) >> 8;
+    tap[2] = flag;
+    for (n = 0; n < size; n++)
+        check ^= tap[3 + n] = rnd();
+    tap[3 + size] = check;
+    return tap + 3 + size + 1;
+}
+
+static int conform_tape_load(int verbose)
+{
+    static const int size[2] = { LOAD_HEADER, LOAD_SIZE };
+    static const byte flag[2] = { 0x00, 0xFF };
+    MCONFIG saved = mconfig;
+    Z80Regs *r = spectrumZ80;
+    const byte *data[2];
+    int run, b, n, frames, bad = 0;
+
+    data[0] = load_tap + 3;
+    data[1] = load_block(load_tap, flag[0], size[0]) + 3;
+    load_block((byte *)data[1] - 3, flag[1], size[1]);
+
+    for (run = 0; run < 8; run++)
+    {
+        int failed = 0;
+
+        mconfig.flash_loading = 0;
+        mconfig.auto_loading = 1;
+        mconfig.contention = run & 1;
+        mconfig.edge_loading = (run >> 1) & 1;
+        mconfig.speed_loading = (run >> 2) & 1;
+        ZX_Reset(ZX_48);
+        ZX_Unpatch_ROM();
+        Tape_init(load_tap, sizeof(load_tap));
+        Z80WriteMem_notiming(LOAD_RETURN, 0xF3);
+        Z80WriteMem_notiming(LOAD_RETURN + 1, 0x18);
+        Z80WriteMem_notiming(LOAD_RETURN + 2, 0xFE);
+
+        for (b = 0; b < 2 && !failed; b++)
+        {
+            Z80WriteMem_notiming(0xFEFE, LOAD_RETURN & 0xff);
+            Z80WriteMem_notiming(0xFEFF, LOAD_RETURN >> 8);
+            r->SP.W = 0xFEFE;
+            r->PC.W = LD_BYTES;
+            r->AF.W = flag[b] << 8 | FLAG_C;    /* carry: load, not verify */
+            r->IX.W = LOAD_ORG;
+            r->DE.W = size[b];
+            r->IY.W = 0x5C3A;
+            r->IM = 1;
+
+            for (frames = 0; frames < LOAD_FRAMES; frames++)
+            {
+                ZX_Frame(1);
+                if ((word)(r->PC.W - LOAD_RETURN) < 3)
+                    break;
+            }
+            for (n = 0; n < size[b]; n++)
+                if (Z80ReadMem_notiming(LOAD_ORG + n) != data[b][n])
+                    break;
+            failed = frames == LOAD_FRAMES || n < size[b] || !(r->AF.B.l & FLAG_C);
+
+            if (verbose || (failed && !bad))
+                fprintf(stderr, "tape load: contention %d, edge loading %d, speed loading %d, "
+                        "block %d: %d frames, %d bytes%s\n", mconfig.contention,
+                        mconfig.edge_loading, mconfig.speed_loading, b, frames, n,
+                        failed ? ", failed" : "");
+        }
+        bad += failed;
+        Tape_close();
+    }
+
+    mconfig = saved;
+    return bad;
+}
+
+int conform_opcodes(int trials, int verbose)
+{
+    static byte ram[RAM_SIZE];
+    Z80Regs reset;
+    int g, op, t, core, bad, hook, load, mismatches = 0, instructions = 0;
+
+    ZX_Reset(ZX_48);
+    flat_ram();
+    reset = *spectrumZ80;
+
+    printf("{\n  \"conformance\": {\n    \"trials\": %d,\n    \"groups\": {\n", trials);
+    for (g = 0; g < NGROUPS; g++)
+    {
+        const OpGroup *grp = &groups[g];
+        int length[256], tested = 0, straight = 0, bad = 0;
+        double ns[Z80_CORES];
+
+        for (op = 0; op < 256; op++)
+        {
+            int failed = 0;
+
+            length[op] = 0;
+            if (skip_opcode(grp, op))
+                continue;
+            tested++;
+            length[op] = -1;
+
+            for (t = 0; t < trials; t++)
+            {
+                byte operand[2], code[8];
+                Z80Regs regs = reset;
+                CpuState state[Z80_CORES], reference;
+                const CpuState *expected = &reference;
+                const char *expected_name = reference_name;
+                int len, step;
+
+                operand[0] = rnd();
+                operand[1] = rnd();
+                len = opcode_bytes(grp, op, operand, code);
+                random_state(&regs, ram, code, len);
+
+                for (core = 0; core < Z80_CORES; core++)
+                    run_step(core, &regs, ram, &state[core]);
+                run_reference(&regs, ram, &reference);
+                if (known_difference(grp, op))
+                {
+                    expected = &state[0];
+                    expected_name = core_names[0];
+                }
+
+                for (core = 0; core < Z80_CORES; core++)
+                    if (compare_states(expected, &state[core], 0))
+                    {
+                        if (verbose || !failed)
+                        {
+                            fprintf(stderr, "%s %02X: %s vs %s:", grp->name, op,
+                                    expected_name, core_names[core]);
+                            compare_states(expected, &state[core], 1);
+                            fprintf(stderr, " at %04x\n", regs.PC.W);
+                        }
+                        failed = 1;
+                    }
+
+                /* worth timing if it always falls through to the next
+                   instruction without touching the stack, HALT or the
+                   ULA port */
+                step = (word)(state[0].regs.PC.W - regs.PC.W);
+                if (step < 1 || step > 4 || state[0].regs.SP.W != regs.SP.W ||
+                    state[0].regs.halted || state[0].outs ||
+                    (length[op] >= 0 && length[op] != step))
+                    length[op] = 0;
+                else if (length[op] < 0)
+                    length[op] = step;
+            }
+            if (length[op] < 0)
+                length[op] = 0;
+            if (length[op])
+                straight++;
+            bad += failed;
+        }
+        instructions += tested;
+        mismatches += bad;
+
+        time_group(grp, length, ns);
+        printf("      \"%s\": { \"opcodes\": %d, \"mismatches\": %d, \"timed\": %d, "
+               "\"ns_per_instruction\": { \"%s\": %.3f, \"%s\": %.3f, \"%s\": %.3f } }%s\n",
+               grp->name, tested, bad, straight,
+               core_names[0], ns[0], core_names[1], ns[1], core_names[2], ns[2],
+               g < NGROUPS - 1 ? "," : "");
+    }
+    bad = conform_loops(&reset, verbose);
+    hook = conform_tape_hook(&reset, verbose);
+    load = conform_tape_load(verbose);
+    mismatches += bad + hook + load;
+    printf("    },\n    \"loops\": { \"programs\": %d, \"mismatches\": %d },\n"
+           "    \"tape_hook\": { \"mismatches\": %d },\n"
+           "    \"tape_load\": { \"runs\": 8, \"mismatches\": %d },\n"
+           "    \"instructions\": %d,\n    \"mismatches\": %d\n  }\n}\n",
+           NLOOPS, bad, hook, load, instructions, mismatches);
+    return mismatches;
+}
+
+/*--- CP/M exercisers --------------------------------------------------*/
+
+#define CPM_BDOS 0xFE00
+
+int conform_cpm(const char *name, int contended)
+{
+    Z80Core core = contended ? Z80Run : Z80Run_NCNI;
+    FILE *fp;
+    int c;
+
+    ZX_Reset(ZX_48);
+    flat_ram();
+    memset(RAM_pages, 0, RAM_SIZE);
+
+    fp = fopen(name, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "bench: can't load %s\n", name);
+        return 1;
+    }
+    fread(RAM_pages + 0x100, 1, CPM_BDOS - 0x100, fp);
+    fclose(fp);
+
+    /* warm boot is a HALT at 0, BDOS a HALT and a RET at the top of the
+       TPA, where the JP at 5 says it is */
+    RAM_pages[0x0000] = 0x76;
+    RAM_pages[0x0005] = 0xC3;
+    RAM_pages[0x0006] = CPM_BDOS & 0xff;
+    RAM_pages[0x0007] = CPM_BDOS >> 8;
+    RAM_pages[CPM_BDOS] = 0x76;
+    RAM_pages[CPM_BDOS + 1] = 0xC9;
+
+    spectrumZ80->PC.W = 0x100;
+    spectrumZ80->SP.W = CPM_BDOS - 2;    /* returns to the warm boot */
+    spectrumZ80->IFF1 = spectrumZ80->IFF2 = 0;
+    memset(z80_profile, 0, sizeof(z80_profile));
+
+    for (;;)
+    {
+        spectrumZ80->ICount = 60000;
+        core(spectrumZ80, 59000);
+        if (!spectrumZ80->halted)
+            continue;
+
+        if (spectrumZ80->PC.W == 1)
+            break;
+        if (spectrumZ80->PC.W == CPM_BDOS + 1)
+        {
+            if (spectrumZ80->BC.B.l == 2)
+                putchar(spectrumZ80->DE.B.l);
+            else if (spectrumZ80->BC.B.l == 9)
+                for (c = spectrumZ80->DE.W; RAM_pages[c & 0xffff] != '$'; c++)
+                    putchar(RAM_pages[c & 0xffff]);
+            fflush(stdout);
+            spectrumZ80->halted = 0;
+            continue;
+        }
+        fprintf(stderr, "bench: HALT at %04x\n", spectrumZ80->PC.W - 1);
+        return 1;
+    }
+
+    c = contended ? Z80_CORE_C : Z80_CORE_NCNI;
+    fprintf(stderr, "%s: %llu instructions, %.3f s\n",
+            core_names[c], z80_profile[c].ops, z80_profile[c].ns / 1e9);
+    return 0;
+}
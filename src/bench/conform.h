@@ -0,0 +1,13 @@
+#ifndef BENCH_CONFORM_H
+#define BENCH_CONFORM_H
+
+/* opcode by opcode comparison of the three cores with the reference Z80
+   of z80ref.c plus a throughput run per opcode group, returns the number
+   of mismatching instructions */
+int conform_opcodes(int trials, int verbose);
+
+/* runs a CP/M .com instruction exerciser (zexdoc, zexall...) on one
+   core, returns 0 when it warm booted */
+int conform_cpm(const char *name, int contended);
+
+#endif
@@ -0,0 +1,801 @@
+/*
+ * Reference Z80 for the conformance checks.
+ *
+ * A plain interpreter written from the Zilog manual and Sean Young's
+ * "The Undocumented Z80 Documented", sharing no code or tables with
+ * cpu/: opcodes are decoded from their x/y/z fields, the flags are
+ * worked out bit by bit from the result, and the T-states come from
+ * the tables below as those documents give them. The cores build
+ * every opcode from the same sources, so agreeing with each other
+ * says nothing about a wrong flag or a wrong T-state count; agreeing
+ * with this does.
+ *
+ * It runs one instruction at a time the way the cores step: a DD or
+ * FD in front of an opcode that doesn't use HL is a 4 T-state
+ * instruction of its own, a block instruction does one pass and steps
+ * PC back when it repeats, and PC is left past a HALT. R counts every
+ * M1 cycle in all 8 bits and R7 keeps bit 7 from LD R,A. There is no
+ * MEMPTR: BIT n,(HL) leaves bits 3 and 5 clear, as the cores do.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ */
+
+#include <stdio.h>
+
+#include "microlib.h"
+#include "shared.h"
+#include "z80ref.h"
+
+#define SF 0x80
+#define ZF 0x40
+#define YF 0x20
+#define HF 0x10
+#define XF 0x08
+#define PF 0x04
+#define NF 0x02
+#define CF 0x01
+
+/*--- T-states ---------------------------------------------------------*/
+
+/* unprefixed, with conditions not met; JR cc and DJNZ take 5 more when
+   they jump, CALL cc 7 and RET cc 6 */
+static const byte t_base[256] =
+{
+ /*       0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F */
+ /* 0 */  4, 10,  7,  6,  4,  4,  7,  4,  4, 11,  7,  6,  4,  4,  7,  4,
+ /* 1 */  8, 10,  7,  6,  4,  4,  7,  4, 12, 11,  7,  6,  4,  4,  7,  4,
+ /* 2 */  7, 10, 16,  6,  4,  4,  7,  4,  7, 11, 16,  6,  4,  4,  7,  4,
+ /* 3 */  7, 10, 13,  6, 11, 11, 10,  4,  7, 11, 13,  6,  4,  4,  7,  4,
+ /* 4 */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* 5 */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* 6 */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* 7 */  7,  7,  7,  7,  7,  7,  4,  7,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* 8 */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* 9 */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* A */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* B */  4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+ /* C */  5, 10, 10, 10, 10, 11,  7, 11,  5, 10, 10,  0, 10, 17,  7, 11,
+ /* D */  5, 10, 10, 11, 10, 11,  7, 11,  5,  4, 10, 11, 10,  0,  7, 11,
+ /* E */  5, 10, 10, 19, 10, 11,  7, 11,  5,  4, 10,  4, 10,  0,  7, 11,
+ /* F */  5, 10, 10,  4, 10, 11,  7, 11,  5,  6, 10,  4, 10,  0,  7, 11,
+};
+
+/* ED xx; the block instructions take 5 more when they repeat */
+static const byte t_ed[256] =
+{
+ /*       0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F */
+ /* 0 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* 1 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* 2 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* 3 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* 4 */ 12, 12, 15, 20,  8, 14,  8,  9, 12, 12, 15, 20,  8, 14,  8,  9,
+ /* 5 */ 12, 12, 15, 20,  8, 14,  8,  9, 12, 12, 15, 20,  8, 14,  8,  9,
+ /* 6 */ 12, 12, 15, 20,  8, 14,  8, 18, 12, 12, 15, 20,  8, 14,  8, 18,
+ /* 7 */ 12, 12, 15, 20,  8, 14,  8,  8, 12, 12, 15, 20,  8, 14,  8,  8,
+ /* 8 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* 9 */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* A */ 16, 16, 16, 16,  8,  8,  8,  8, 16, 16, 16, 16,  8,  8,  8,  8,
+ /* B */ 16, 16, 16, 16,  8,  8,  8,  8, 16, 16, 16, 16,  8,  8,  8,  8,
+ /* C */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* D */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* E */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+ /* F */  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+};
+
+/* DD xx and FD xx, prefix included; 0 is an opcode that doesn't use HL,
+   where the prefix is an instruction of 4 T-states on its own */
+static const byte t_index[256] =
+{
+ /*       0   1   2   3   4   5   6   7   8   9   A   B   C   D   E   F */
+ /* 0 */  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,
+ /* 1 */  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,
+ /* 2 */  0, 14, 20, 10,  8,  8, 11,  0,  0, 15, 20, 10,  8,  8, 11,  0,
+ /* 3 */  0,  0,  0,  0, 23, 23, 19,  0,  0, 15,  0,  0,  0,  0,  0,  0,
+ /* 4 */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* 5 */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* 6 */  8,  8,  8,  8,  8,  8, 19,  8,  8,  8,  8,  8,  8,  8, 19,  8,
+ /* 7 */ 19, 19, 19, 19, 19, 19,  0, 19,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* 8 */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* 9 */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* A */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* B */  0,  0,  0,  0,  8,  8, 19,  0,  0,  0,  0,  0,  8,  8, 19,  0,
+ /* C */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* D */  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+ /* E */  0, 14,  0, 23,  0, 15,  0,  0,  0,  8,  0,  0,  0,  0,  0,  0,
+ /* F */  0,  0,  0,  0,  0,  0,  0,  0,  0, 10,  0,  0,  0,  0,  0,  0,
+};
+
+/* CB xx: 8, 15 on (HL) and 12 for BIT n,(HL); DD CB d xx: 23, 20 for BIT */
+#define T_CB(z, x)      ((z) != 6 ? 8 : (x) == 1 ? 12 : 15)
+#define T_INDEX_CB(x)   ((x) == 1 ? 20 : 23)
+
+/*--- machine ----------------------------------------------------------*/
+
+static Z80Regs *cpu;
+static byte *mem;
+static byte (*in_port)(word port);
+static int tstates;
+
+#define rA  cpu->AF.B.h
+#define rF  cpu->AF.B.l
+#define rB  cpu->BC.B.h
+#define rC  cpu->BC.B.l
+#define rPC cpu->PC.W
+#define rSP cpu->SP.W
+
+static byte fetch(void)
+{
+    return mem[rPC++];
+}
+
+static word fetch16(void)
+{
+    word lo = fetch();
+    return lo | fetch() << 8;
+}
+
+static word read16(word addr)
+{
+    return mem[addr] | mem[(word)(addr + 1)] << 8;
+}
+
+static void write16(word addr, word value)
+{
+    mem[addr] = value;
+    mem[(word)(addr + 1)] = value >> 8;
+}
+
+static void push(word value)
+{
+    rSP -= 2;
+    write16(rSP, value);
+}
+
+static word pop(void)
+{
+    word value = read16(rSP);
+    rSP += 2;
+    return value;
+}
+
+static int parity(int v)
+{
+    int n, odd = 0;
+
+    for (n = 0; n < 8; n++)
+        odd ^= v >> n & 1;
+    return odd ? 0 : PF;
+}
+
+/* sign, zero and the two undocumented bits of a result */
+static int sz53(int v)
+{
+    v &= 0xff;
+    return (v & (SF | YF | XF)) | (v ? 0 : ZF);
+}
+
+static int sz53p(int v)
+{
+    return sz53(v) | parity(v);
+}
+
+/*--- arithmetic -------------------------------------------------------*/
+
+static byte add8(int a, int v, int carry)
+{
+    int res = a + v + carry;
+
+    rF = sz53(res) | ((a ^ v ^ res) & HF) |
+        (((a ^ res) & (v ^ res) & 0x80) ? PF : 0) | (res >> 8 & CF);
+    return res;
+}
+
+static byte sub8(int a, int v, int carry)
+{
+    int res = a - v - carry;
+
+    rF = sz53(res) | ((a ^ v ^ res) & HF) |
+        (((a ^ v) & (a ^ res) & 0x80) ? PF : 0) | NF | (res & 0x100 ? CF : 0);
+    return res;
+}
+
+/* ADD ADC SUB SBC AND XOR OR CP, in opcode order */
+static void alu(int op, byte v)
+{
+    switch (op)
+    {
+    case 0: rA = add8(rA, v, 0); break;
+    case 1: rA = add8(rA, v, rF & CF); break;
+    case 2: rA = sub8(rA, v, 0); break;
+    case 3: rA = sub8(rA, v, rF & CF); break;
+    case 4: rA &= v; rF = sz53p(rA) | HF; break;
+    case 5: rA ^= v; rF = sz53p(rA); break;
+    case 6: rA |= v; rF = sz53p(rA); break;
+    case 7:                                     /* bits 3 and 5 of the operand */
+        sub8(rA, v, 0);
+        rF = (rF & ~(YF | XF)) | (v & (YF | XF));
+        break;
+    }
+}
+
+static byte inc8(byte v)
+{
+    byte res = v + 1;
+
+    rF = (rF & CF) | sz53(res) | ((v ^ res) & HF) | (v == 0x7f ? PF : 0);
+    return res;
+}
+
+static byte dec8(byte v)
+{
+    byte res = v - 1;
+
+    rF = (rF & CF) | NF | sz53(res) | ((v ^ res) & HF) | (v == 0x80 ? PF : 0);
+    return res;
+}
+
+static word add16(int a, int v)
+{
+    int res = a + v;
+
+    rF = (rF & (SF | ZF | PF)) | ((a ^ v ^ res) >> 8 & HF) |
+        (res >> 8 & (YF | XF)) | (res >> 16 & CF);
+    return res;
+}
+
+static word adc16(int a, int v)
+{
+    int res = a + v + (rF & CF);
+
+    rF = (res & 0x8000 ? SF : 0) | (res & 0xffff ? 0 : ZF) | ((a ^ v ^ res) >> 8 & HF) |
+        (((a ^ res) & (v ^ res) & 0x8000) ? PF : 0) | (res >> 8 & (YF | XF)) |
+        (res >> 16 & CF);
+    return res;
+}
+
+static word sbc16(int a, int v)
+{
+    int res = a - v - (rF & CF);
+
+    rF = (res & 0x8000 ? SF : 0) | (res & 0xffff ? 0 : ZF) | ((a ^ v ^ res) >> 8 & HF) |
+        (((a ^ v) & (a ^ res) & 0x8000) ? PF : 0) | NF | (res >> 8 & (YF | XF)) |
+        (res & 0x10000 ? CF : 0);
+    return res;
+}
+
+static void daa(void)
+{
+    int add = 0, carry = rF & CF, half;
+
+    if ((rF & HF) || (rA & 0x0f) > 9)
+        add = 0x06;
+    if (carry || rA > 0x99)
+    {
+        add |= 0x60;
+        carry = CF;
+    }
+    if (rF & NF)
+    {
+        half = (rF & HF) && (rA & 0x0f) < 6;
+        rA -= add;
+    }
+    else
+    {
+        half = (rA & 0x0f) > 9;
+        rA += add;
+    }
+    rF = sz53p(rA) | (half ? HF : 0) | (rF & NF) | carry;
+}
+
+/* RLC RRC RL RR SLA SRA SLL SRL, in opcode order */
+static byte shift(int op, byte v)
+{
+    int res, carry;
+
+    switch (op)
+    {
+    case 0: carry = v >> 7; res = v << 1 | carry; break;
+    case 1: carry = v & 1; res = v >> 1 | carry << 7; break;
+    case 2: carry = v >> 7; res = v << 1 | (rF & CF); break;
+    case 3: carry = v & 1; res = v >> 1 | (rF & CF) << 7; break;
+    case 4: carry = v >> 7; res = v << 1; break;
+    case 5: carry = v & 1; res = v >> 1 | (v & 0x80); break;
+    case 6: carry = v >> 7; res = v << 1 | 1; break;
+    default: carry = v & 1; res = v >> 1; break;
+    }
+    rF = sz53p(res) | carry;
+    return res;
+}
+
+/* BIT n: bits 3 and 5 come from xy, the register or the address high
+   byte */
+static void bit(int n, byte v, byte xy)
+{
+    rF = (rF & CF) | HF | (xy & (YF | XF));
+    if (!(v & 1 << n))
+        rF |= ZF | PF;
+    else if (n == 7)
+        rF |= SF;
+}
+
+/*--- registers by field -----------------------------------------------*/
+
+/* idx 0 is HL, 1 IX, 2 IY */
+static eword *pair_hl(int idx)
+{
+    return idx == 0 ? &cpu->HL : idx == 1 ? &cpu->IX : &cpu->IY;
+}
+
+/* B C D E H L - A by the r field, H and L through idx */
+static byte *reg8(int r, int idx)
+{
+    switch (r)
+    {
+    case 0: return &cpu->BC.B.h;
+    case 1: return &cpu->BC.B.l;
+    case 2: return &cpu->DE.B.h;
+    case 3: return &cpu->DE.B.l;
+    case 4: return &pair_hl(idx)->B.h;
+    case 5: return &pair_hl(idx)->B.l;
+    default: return &cpu->AF.B.h;
+    }
+}
+
+/* BC DE HL SP by the p field */
+static word *reg16_sp(int p, int idx)
+{
+    switch (p)
+    {
+    case 0: return &cpu->BC.W;
+    case 1: return &cpu->DE.W;
+    case 2: return &pair_hl(idx)->W;
+    default: return &cpu->SP.W;
+    }
+}
+
+/* BC DE HL AF by the p field */
+static word *reg16_af(int p, int idx)
+{
+    return p == 3 ? &cpu->AF.W : reg16_sp(p, idx);
+}
+
+static int condition(int y)
+{
+    static const byte flag[4] = { ZF, CF, PF, SF };
+
+    return !(rF & flag[y >> 1]) == !(y & 1);
+}
+
+/*--- CB xx and DD CB d xx ---------------------------------------------*/
+
+static void exec_cb(void)
+{
+    int op = fetch(), x = op >> 6, y = op >> 3 & 7, z = op & 7;
+    byte v, *r = z == 6 ? &mem[cpu->HL.W] : reg8(z, 0);
+
+    cpu->R++;
+    tstates += T_CB(z, x);
+    v = *r;
+    switch (x)
+    {
+    case 0: *r = shift(y, v); break;
+    case 1: bit(y, v, z == 6 ? 0 : v); break;   /* no MEMPTR, see above */
+    case 2: *r = v & ~(1 << y); break;
+    case 3: *r = v | 1 << y; break;
+    }
+}
+
+/* the result goes to memory and, but for (HL), to the register too */
+static void exec_index_cb(int idx)
+{
+    word addr = pair_hl(idx)->W + (signed char)fetch();
+    int op = fetch(), x = op >> 6, y = op >> 3 & 7, z = op & 7;
+    byte v = mem[addr];
+
+    tstates += T_INDEX_CB(x);
+    switch (x)
+    {
+    case 0: v = shift(y, v); break;
+    case 1: bit(y, v, addr >> 8); return;
+    case 2: v &= ~(1 << y); break;
+    case 3: v |= 1 << y; break;
+    }
+    mem[addr] = v;
+    if (z != 6)
+        *reg8(z, 0) = v;
+}
+
+/*--- ED xx ------------------------------------------------------------*/
+
+static void block(int y, int z)
+{
+    int step = y & 1 ? -1 : 1, repeat = y >= 6, again = 0, t;
+    byte v;
+
+    switch (z)
+    {
+    case 0:                                     /* LDI LDD LDIR LDDR */
+        v = mem[cpu->HL.W];
+        mem[cpu->DE.W] = v;
+        cpu->HL.W += step;
+        cpu->DE.W += step;
+        cpu->BC.W--;
+        t = rA + v;
+        rF = (rF & (SF | ZF | CF)) | (cpu->BC.W ? PF : 0) | (t & XF) | (t << 4 & YF);
+        again = cpu->BC.W != 0;
+        break;
+    case 1:                                     /* CPI CPD CPIR CPDR */
+        v = mem[cpu->HL.W];
+        t = rA - v;
+        rF = (rF & CF) | NF | sz53(t) | ((rA ^ v ^ t) & HF) | (cpu->BC.W != 1 ? PF : 0);
+        t -= rF & HF ? 1 : 0;
+        rF = (rF & ~(YF | XF)) | (t & XF) | (t << 4 & YF);
+        cpu->HL.W += step;
+        cpu->BC.W--;
+        again = cpu->BC.W != 0 && !(rF & ZF);
+        break;
+    case 2:                                     /* INI IND INIR INDR */
+        v = in_port(cpu->BC.W);
+        mem[cpu->HL.W] = v;
+        rB--;
+        cpu->HL.W += step;
+        t = v + (byte)(rC + step);
+        rF = (v & 0x80 ? NF : 0) | (t > 0xff ? HF | CF : 0) | parity((t & 7) ^ rB) | sz53(rB);
+        again = rB != 0;
+        break;
+    default:                                    /* OUTI OUTD OTIR OTDR */
+        v = mem[cpu->HL.W];
+        rB--;
+        cpu->HL.W += step;
+        t = v + cpu->HL.B.l;
+        rF = (v & 0x80 ? NF : 0) | (t > 0xff ? HF | CF : 0) | parity((t & 7) ^ rB) | sz53(rB);
+        again = rB != 0;
+        break;
+    }
+    if (repeat && again)
+    {
+        rPC -= 2;
+        tstates += 5;
+    }
+}
+
+static void exec_ed(void)
+{
+    int op = fetch(), x = op >> 6, y = op >> 3 & 7, z = op & 7, p = y >> 1, q = y & 1;
+    byte v, *r;
+
+    cpu->R++;
+    tstates += t_ed[op];
+    if (x == 2 && z <= 3 && y >= 4)
+    {
+        block(y, z);
+        return;
+    }
+    if (x != 1)
+        return;                                 /* two NOPs */
+    switch (z)
+    {
+    case 0:                                     /* IN r,(C), IN (C) */
+        v = in_port(cpu->BC.W);
+        rF = (rF & CF) | sz53p(v);
+        if (y != 6)
+            *reg8(y, 0) = v;
+        break;
+    case 1:                                     /* OUT (C),r, OUT (C),0 */
+        break;
+    case 2:
+        if (q)
+            cpu->HL.W = adc16(cpu->HL.W, *reg16_sp(p, 0));
+        else
+            cpu->HL.W = sbc16(cpu->HL.W, *reg16_sp(p, 0));
+        break;
+    case 3:
+        if (q)
+            *reg16_sp(p, 0) = read16(fetch16());
+        else
+            write16(fetch16(), *reg16_sp(p, 0));
+        break;
+    case 4:                                     /* NEG */
+        rA = sub8(0, rA, 0);
+        break;
+    case 5:                                     /* RETN, RETI */
+        cpu->IFF1 = cpu->IFF2;
+        rPC = pop();
+        break;
+    case 6:                                     /* IM 0 IM 0/1 IM 1 IM 2 */
+        cpu->IM = (y & 3) < 2 ? 0 : (y & 3) - 1;
+        break;
+    default:
+        switch (y)
+        {
+        case 0: cpu->I = rA; break;
+        case 1: cpu->R = cpu->R7 = rA; break;
+        case 2:
+        case 3:
+            rA = y == 2 ? cpu->I : (cpu->R & 0x7f) | (cpu->R7 & 0x80);
+            rF = (rF & CF) | sz53(rA) | (cpu->IFF2 ? PF : 0);
+            break;
+        case 4:                                 /* RRD */
+            r = &mem[cpu->HL.W];
+            v = *r;
+            *r = rA << 4 | v >> 4;
+            rA = (rA & 0xf0) | (v & 0x0f);
+            rF = (rF & CF) | sz53p(rA);
+            break;
+        case 5:                                 /* RLD */
+            r = &mem[cpu->HL.W];
+            v = *r;
+            *r = v << 4 | (rA & 0x0f);
+            rA = (rA & 0xf0) | v >> 4;
+            rF = (rF & CF) | sz53p(rA);
+            break;
+        }
+        break;
+    }
+}
+
+/*--- unprefixed, and DD/FD ---------------------------------------------*/
+
+/* what an r field of 6 stands for: (HL), or (IX+d) read once */
+static word operand_addr(int idx)
+{
+    return idx ? pair_hl(idx)->W + (signed char)fetch() : cpu->HL.W;
+}
+
+static void exec_main(int op, int idx)
+{
+    int x = op >> 6, y = op >> 3 & 7, z = op & 7, p = y >> 1, q = y & 1;
+    word addr, w;
+    byte v;
+    eword swap;
+
+    switch (x)
+    {
+    case 0:
+        switch (z)
+        {
+        case 0:
+            if (y == 0)
+                break;
+            if (y == 1)
+            {
+                swap = cpu->AF;
+                cpu->AF = cpu->AFs;
+                cpu->AFs = swap;
+                break;
+            }
+            v = fetch();
+            if (y == 2 ? --rB != 0 : y == 3 || condition(y - 4))
+            {
+                rPC += (signed char)v;
+                tstates += y == 3 ? 0 : 5;
+            }
+            break;
+        case 1:
+            if (q)
+                pair_hl(idx)->W = add16(pair_hl(idx)->W, *reg16_sp(p, idx));
+            else
+                *reg16_sp(p, idx) = fetch16();
+            break;
+        case 2:
+            switch (y)
+            {
+            case 0: mem[cpu->BC.W] = rA; break;
+            case 1: rA = mem[cpu->BC.W]; break;
+            case 2: mem[cpu->DE.W] = rA; break;
+            case 3: rA = mem[cpu->DE.W]; break;
+            case 4: write16(fetch16(), pair_hl(idx)->W); break;
+            case 5: pair_hl(idx)->W = read16(fetch16()); break;
+            case 6: mem[fetch16()] = rA; break;
+            case 7: rA = mem[fetch16()]; break;
+            }
+            break;
+        case 3:
+            *reg16_sp(p, idx) += q ? -1 : 1;
+            break;
+        case 4:
+        case 5:
+            if (y == 6)
+            {
+                addr = operand_addr(idx);
+                mem[addr] = z == 4 ? inc8(mem[addr]) : dec8(mem[addr]);
+            }
+            else
+                *reg8(y, idx) = z == 4 ? inc8(*reg8(y, idx)) : dec8(*reg8(y, idx));
+            break;
+        case 6:
+            if (y == 6)
+            {
+                addr = operand_addr(idx);
+                mem[addr] = fetch();
+            }
+            else
+                *reg8(y, idx) = fetch();
+            break;
+        default:
+            switch (y)
+            {
+            case 0:                             /* RLCA RRCA RLA RRA */
+            case 1:
+            case 2:
+            case 3:
+                w = rF & (SF | ZF | PF);
+                rA = shift(y, rA);
+                rF = w | (rA & (YF | XF)) | (rF & CF);
+                break;
+            case 4: daa(); break;
+            case 5:                             /* CPL */
+                rA = ~rA;
+                rF = (rF & (SF | ZF | PF | CF)) | HF | NF | (rA & (YF | XF));
+                break;
+            case 6:                             /* SCF */
+                rF = (rF & (SF | ZF | PF)) | (rA & (YF | XF)) | CF;
+                break;
+            default:                            /* CCF */
+                rF = ((rF & (SF | ZF | PF)) | (rF & CF ? HF : 0) | (rA & (YF | XF))) |
+                    (~rF & CF);
+                break;
+            }
+            break;
+        }
+        break;
+
+    case 1:
+        if (op == 0x76)
+        {
+            cpu->halted = 1;
+            break;
+        }
+        /* with (IX+d) on one side, H and L on the other are the real ones */
+        if (z == 6)
+            *reg8(y, 0) = mem[operand_addr(idx)];
+        else if (y == 6)
+            mem[operand_addr(idx)] = *reg8(z, 0);
+        else
+            *reg8(y, idx) = *reg8(z, idx);
+        break;
+
+    case 2:
+        alu(y, z == 6 ? mem[operand_addr(idx)] : *reg8(z, idx));
+        break;
+
+    default:
+        switch (z)
+        {
+        case 0:
+            if (condition(y))
+            {
+                rPC = pop();
+                tstates += 6;
+            }
+            break;
+        case 1:
+            switch (y)
+            {
+            case 1: rPC = pop(); break;
+            case 3:                             /* EXX */
+                swap = cpu->BC; cpu->BC = cpu->BCs; cpu->BCs = swap;
+                swap = cpu->DE; cpu->DE = cpu->DEs; cpu->DEs = swap;
+                swap = cpu->HL; cpu->HL = cpu->HLs; cpu->HLs = swap;
+                break;
+            case 5: rPC = pair_hl(idx)->W; break;
+            case 7: rSP = pair_hl(idx)->W; break;
+            default: *reg16_af(p, idx) = pop(); break;
+            }
+            break;
+        case 2:
+            w = fetch16();
+            if (condition(y))
+                rPC = w;
+            break;
+        case 3:
+            switch (y)
+            {
+            case 0: rPC = fetch16(); break;
+            case 2: fetch(); break;             /* OUT (n),A */
+            case 3: v = fetch(); rA = in_port(v | rA << 8); break;
+            case 4:                             /* EX (SP),HL */
+                w = read16(rSP);
+                write16(rSP, pair_hl(idx)->W);
+                pair_hl(idx)->W = w;
+                break;
+            case 5:
+                swap = cpu->DE; cpu->DE = cpu->HL; cpu->HL = swap;
+                break;
+            case 6: cpu->IFF1 = cpu->IFF2 = 0; break;
+            case 7: cpu->IFF1 = cpu->IFF2 = 1; break;
+            }
+            break;
+        case 4:
+            w = fetch16();
+            if (condition(y))
+            {
+                push(rPC);
+                rPC = w;
+                tstates += 7;
+            }
+            break;
+        case 5:
+            if (q)
+            {
+                w = fetch16();                  /* CALL, y 1 */
+                push(rPC);
+                rPC = w;
+            }
+            else
+                push(*reg16_af(p, idx));
+            break;
+        case 6:
+            alu(y, fetch());
+            break;
+        default:                                /* RST */
+            push(rPC);
+            rPC = y << 3;
+            break;
+        }
+        break;
+    }
+}
+
+static void exec_index(int idx)
+{
+    int op = mem[rPC];
+
+    if (op == 0xCB)
+    {
+        rPC++;
+        cpu->R++;
+        exec_index_cb(idx);
+        return;
+    }
+    if (!t_index[op])
+    {
+        tstates += 4;
+        return;
+    }
+    rPC++;
+    cpu->R++;
+    tstates += t_index[op];
+    exec_main(op, idx);
+}
+
+/*--- public side --------------------------------------------------------*/
+
+int z80ref_step(Z80Regs *regs, byte *ram, byte (*in)(word port))
+{
+    int op;
+
+    cpu = regs;
+    mem = ram;
+    in_port = in;
+    tstates = 0;
+
+    op = fetch();
+    cpu->R++;
+    switch (op)
+    {
+    case 0xCB: exec_cb(); break;
+    case 0xED: exec_ed(); break;
+    case 0xDD: exec_index(1); break;
+    case 0xFD: exec_index(2); break;
+    default:
+        tstates += t_base[op];
+        exec_main(op, 0);
+        break;
+    }
+    cpu->ICount -= tstates;
+    return tstates;
+}
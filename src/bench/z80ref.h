@@ -0,0 +1,8 @@
+#ifndef BENCH_Z80REF_H
+#define BENCH_Z80REF_H
+
+/* runs one instruction of the reference Z80 on regs and 64K of ram,
+   reading ports through in; charges ICount and returns the T-states */
+int z80ref_step(Z80Regs *regs, byte *ram, byte (*in)(word port));
+
+#endif
@@ -32,834 +32,1106 @@
 
 /* 8 clock cycles minimum = CB opcode = 4+4 */
 
-opcode = Z80ReadMem (r_PC);
-AddCycles(1);
+opcode = READ_MEM (r_PC);
+CONTENDED (AddCycles(1));
 r_PC++;
 
-switch (opcode)
+OPCODE_SWITCH (opcode)
   {
 
-  case RLC_B:
+  OPCODE (RLC_B)
     RLC (r_B);
-    break;
-  case RLC_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_C)
     RLC (r_C);
-    break;
-  case RLC_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_D)
     RLC (r_D);
-    break;
-  case RLC_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_E)
     RLC (r_E);
-    break;
-  case RLC_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_H)
     RLC (r_H);
-    break;
-  case RLC_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_L)
     RLC (r_L);
-    break;
-  case RLC_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    RLC (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case RLC_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RLC_xHL)
+    r_meml = READ_MEM (r_HL);
+    RLC (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RLC_A)
     RLC (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RRC_B:
+  OPCODE (RRC_B)
     RRC (r_B);
-    break;
-  case RRC_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_C)
     RRC (r_C);
-    break;
-  case RRC_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_D)
     RRC (r_D);
-    break;
-  case RRC_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_E)
     RRC (r_E);
-    break;
-  case RRC_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_H)
     RRC (r_H);
-    break;
-  case RRC_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_L)
     RRC (r_L);
-    break;
-  case RRC_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    RRC (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case RRC_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RRC_xHL)
+    r_meml = READ_MEM (r_HL);
+    RRC (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RRC_A)
     RRC (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RL_B:
+  OPCODE (RL_B)
     RL (r_B);
-    break;
-  case RL_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_C)
     RL (r_C);
-    break;
-  case RL_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_D)
     RL (r_D);
-    break;
-  case RL_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_E)
     RL (r_E);
-    break;
-  case RL_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_H)
     RL (r_H);
-    break;
-  case RL_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_L)
     RL (r_L);
-    break;
-  case RL_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    RL (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case RL_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RL_xHL)
+    r_meml = READ_MEM (r_HL);
+    RL (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RL_A)
     RL (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RR_B:
+  OPCODE (RR_B)
     RR (r_B);
-    break;
-  case RR_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_C)
     RR (r_C);
-    break;
-  case RR_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_D)
     RR (r_D);
-    break;
-  case RR_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_E)
     RR (r_E);
-    break;
-  case RR_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_H)
     RR (r_H);
-    break;
-  case RR_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_L)
     RR (r_L);
-    break;
-  case RR_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    RR (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-
-    break;
-  case RR_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RR_xHL)
+    r_meml = READ_MEM (r_HL);
+    RR (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RR_A)
     RR (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SLA_B:
+  OPCODE (SLA_B)
     SLA (r_B);
-    break;
-  case SLA_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_C)
     SLA (r_C);
-    break;
-  case SLA_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_D)
     SLA (r_D);
-    break;
-  case SLA_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_E)
     SLA (r_E);
-    break;
-  case SLA_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_H)
     SLA (r_H);
-    break;
-  case SLA_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_L)
     SLA (r_L);
-    break;
-  case SLA_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    SLA (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case SLA_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLA_xHL)
+    r_meml = READ_MEM (r_HL);
+    SLA (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SLA_A)
     SLA (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SRA_B:
+  OPCODE (SRA_B)
     SRA (r_B);
-    break;
-  case SRA_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_C)
     SRA (r_C);
-    break;
-  case SRA_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_D)
     SRA (r_D);
-    break;
-  case SRA_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_E)
     SRA (r_E);
-    break;
-  case SRA_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_H)
     SRA (r_H);
-    break;
-  case SRA_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_L)
     SRA (r_L);
-    break;
-  case SRA_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    SRA (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case SRA_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRA_xHL)
+    r_meml = READ_MEM (r_HL);
+    SRA (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SRA_A)
     SRA (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SLL_B:
+  OPCODE (SLL_B)
     SLL (r_B);
-    break;
-  case SLL_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_C)
     SLL (r_C);
-    break;
-  case SLL_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_D)
     SLL (r_D);
-    break;
-  case SLL_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_E)
     SLL (r_E);
-    break;
-  case SLL_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_H)
     SLL (r_H);
-    break;
-  case SLL_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_L)
     SLL (r_L);
-    break;
-  case SLL_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    SLL (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case SLL_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SLL_xHL)
+    r_meml = READ_MEM (r_HL);
+    SLL (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SLL_A)
     SLL (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SRL_B:
+  OPCODE (SRL_B)
     SRL (r_B);
-    break;
-  case SRL_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_C)
     SRL (r_C);
-    break;
-  case SRL_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_D)
     SRL (r_D);
-    break;
-  case SRL_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_E)
     SRL (r_E);
-    break;
-  case SRL_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_H)
     SRL (r_H);
-    break;
-  case SRL_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_L)
     SRL (r_L);
-    break;
-  case SRL_xHL:
-    r_meml = Z80ReadMem (r_HL);
-    SRL (r_meml);contend_read(r_HL);
-    Z80WriteMem (r_HL, r_meml, regs);
-    break;
-  case SRL_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SRL_xHL)
+    r_meml = READ_MEM (r_HL);
+    SRL (r_meml);
+    CONTENDED (contend_read(r_HL));
+    WRITE_MEM (r_HL, r_meml);
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SRL_A)
     SRL (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_0_B:
+  OPCODE (BIT_0_B)
     BIT_BIT (0, r_B);
-    break;
-  case BIT_0_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_C)
     BIT_BIT (0, r_C);
-    break;
-  case BIT_0_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_D)
     BIT_BIT (0, r_D);
-    break;
-  case BIT_0_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_E)
     BIT_BIT (0, r_E);
-    break;
-  case BIT_0_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_H)
     BIT_BIT (0, r_H);
-    break;
-  case BIT_0_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_L)
     BIT_BIT (0, r_L);
-    break;
-  case BIT_0_xHL:
-    BIT_mem_BIT (0, r_HL); contend_read(r_HL);
-    break;
-  case BIT_0_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_0_xHL)
+    BIT_mem_BIT (0, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_0_A)
     BIT_BIT (0, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_1_B:
+  OPCODE (BIT_1_B)
     BIT_BIT (1, r_B);
-    break;
-  case BIT_1_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_C)
     BIT_BIT (1, r_C);
-    break;
-  case BIT_1_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_D)
     BIT_BIT (1, r_D);
-    break;
-  case BIT_1_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_E)
     BIT_BIT (1, r_E);
-    break;
-  case BIT_1_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_H)
     BIT_BIT (1, r_H);
-    break;
-  case BIT_1_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_L)
     BIT_BIT (1, r_L);
-    break;
-  case BIT_1_xHL:
-    BIT_mem_BIT (1, r_HL); contend_read(r_HL);
-    break;
-  case BIT_1_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_1_xHL)
+    BIT_mem_BIT (1, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_1_A)
     BIT_BIT (1, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_2_B:
+  OPCODE (BIT_2_B)
     BIT_BIT (2, r_B);
-    break;
-  case BIT_2_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_C)
     BIT_BIT (2, r_C);
-    break;
-  case BIT_2_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_D)
     BIT_BIT (2, r_D);
-    break;
-  case BIT_2_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_E)
     BIT_BIT (2, r_E);
-    break;
-  case BIT_2_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_H)
     BIT_BIT (2, r_H);
-    break;
-  case BIT_2_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_L)
     BIT_BIT (2, r_L);
-    break;
-  case BIT_2_xHL:
-    BIT_mem_BIT (2, r_HL); contend_read(r_HL);
-    break;
-  case BIT_2_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_2_xHL)
+    BIT_mem_BIT (2, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_2_A)
     BIT_BIT (2, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_3_B:
+  OPCODE (BIT_3_B)
     BIT_BIT (3, r_B);
-    break;
-  case BIT_3_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_C)
     BIT_BIT (3, r_C);
-    break;
-  case BIT_3_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_D)
     BIT_BIT (3, r_D);
-    break;
-  case BIT_3_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_E)
     BIT_BIT (3, r_E);
-    break;
-  case BIT_3_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_H)
     BIT_BIT (3, r_H);
-    break;
-  case BIT_3_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_L)
     BIT_BIT (3, r_L);
-    break;
-  case BIT_3_xHL:
-    BIT_mem_BIT (3, r_HL); contend_read(r_HL);
-    break;
-  case BIT_3_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_3_xHL)
+    BIT_mem_BIT (3, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_3_A)
     BIT_BIT (3, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_4_B:
+  OPCODE (BIT_4_B)
     BIT_BIT (4, r_B);
-    break;
-  case BIT_4_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_C)
     BIT_BIT (4, r_C);
-    break;
-  case BIT_4_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_D)
     BIT_BIT (4, r_D);
-    break;
-  case BIT_4_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_E)
     BIT_BIT (4, r_E);
-    break;
-  case BIT_4_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_H)
     BIT_BIT (4, r_H);
-    break;
-  case BIT_4_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_L)
     BIT_BIT (4, r_L);
-    break;
-  case BIT_4_xHL:
-    BIT_mem_BIT (4, r_HL); contend_read(r_HL);
-    break;
-  case BIT_4_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_4_xHL)
+    BIT_mem_BIT (4, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_4_A)
     BIT_BIT (4, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_5_B:
+  OPCODE (BIT_5_B)
     BIT_BIT (5, r_B);
-    break;
-  case BIT_5_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_C)
     BIT_BIT (5, r_C);
-    break;
-  case BIT_5_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_D)
     BIT_BIT (5, r_D);
-    break;
-  case BIT_5_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_E)
     BIT_BIT (5, r_E);
-    break;
-  case BIT_5_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_H)
     BIT_BIT (5, r_H);
-    break;
-  case BIT_5_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_L)
     BIT_BIT (5, r_L);
-    break;
-  case BIT_5_xHL:
-    BIT_mem_BIT (5, r_HL); contend_read(r_HL);
-    break;
-  case BIT_5_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_5_xHL)
+    BIT_mem_BIT (5, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_5_A)
     BIT_BIT (5, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_6_B:
+  OPCODE (BIT_6_B)
     BIT_BIT (6, r_B);
-    break;
-  case BIT_6_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_C)
     BIT_BIT (6, r_C);
-    break;
-  case BIT_6_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_D)
     BIT_BIT (6, r_D);
-    break;
-  case BIT_6_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_E)
     BIT_BIT (6, r_E);
-    break;
-  case BIT_6_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_H)
     BIT_BIT (6, r_H);
-    break;
-  case BIT_6_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_L)
     BIT_BIT (6, r_L);
-    break;
-  case BIT_6_xHL:
-    BIT_mem_BIT (6, r_HL); contend_read(r_HL);
-    break;
-  case BIT_6_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_6_xHL)
+    BIT_mem_BIT (6, r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_6_A)
     BIT_BIT (6, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case BIT_7_B:
+  OPCODE (BIT_7_B)
     BIT_BIT7 (r_B);
-    break;
-  case BIT_7_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_C)
     BIT_BIT7 (r_C);
-    break;
-  case BIT_7_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_D)
     BIT_BIT7 (r_D);
-    break;
-  case BIT_7_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_E)
     BIT_BIT7 (r_E);
-    break;
-  case BIT_7_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_H)
     BIT_BIT7 (r_H);
-    break;
-  case BIT_7_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_L)
     BIT_BIT7 (r_L);
-    break;
-  case BIT_7_xHL:
-    BIT_mem_BIT7 (r_HL); contend_read(r_HL);
-    break;
-  case BIT_7_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (BIT_7_xHL)
+    BIT_mem_BIT7 (r_HL);
+    CONTENDED (contend_read(r_HL));
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (BIT_7_A)
     BIT_BIT7 (r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_0_B:
+  OPCODE (RES_0_B)
     BIT_RES (0, r_B);
-    break;
-  case RES_0_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_C)
     BIT_RES (0, r_C);
-    break;
-  case RES_0_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_D)
     BIT_RES (0, r_D);
-    break;
-  case RES_0_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_E)
     BIT_RES (0, r_E);
-    break;
-  case RES_0_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_H)
     BIT_RES (0, r_H);
-    break;
-  case RES_0_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_L)
     BIT_RES (0, r_L);
-    break;
-  case RES_0_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_0_xHL)
     BIT_mem_RES (0, r_HL);
-    break;
-  case RES_0_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_0_A)
     BIT_RES (0, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_1_B:
+  OPCODE (RES_1_B)
     BIT_RES (1, r_B);
-    break;
-  case RES_1_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_C)
     BIT_RES (1, r_C);
-    break;
-  case RES_1_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_D)
     BIT_RES (1, r_D);
-    break;
-  case RES_1_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_E)
     BIT_RES (1, r_E);
-    break;
-  case RES_1_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_H)
     BIT_RES (1, r_H);
-    break;
-  case RES_1_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_L)
     BIT_RES (1, r_L);
-    break;
-  case RES_1_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_1_xHL)
     BIT_mem_RES (1, r_HL);
-    break;
-  case RES_1_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_1_A)
     BIT_RES (1, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_2_B:
+  OPCODE (RES_2_B)
     BIT_RES (2, r_B);
-    break;
-  case RES_2_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_C)
     BIT_RES (2, r_C);
-    break;
-  case RES_2_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_D)
     BIT_RES (2, r_D);
-    break;
-  case RES_2_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_E)
     BIT_RES (2, r_E);
-    break;
-  case RES_2_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_H)
     BIT_RES (2, r_H);
-    break;
-  case RES_2_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_L)
     BIT_RES (2, r_L);
-    break;
-  case RES_2_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_2_xHL)
     BIT_mem_RES (2, r_HL);
-    break;
-  case RES_2_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_2_A)
     BIT_RES (2, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_3_B:
+  OPCODE (RES_3_B)
     BIT_RES (3, r_B);
-    break;
-  case RES_3_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_C)
     BIT_RES (3, r_C);
-    break;
-  case RES_3_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_D)
     BIT_RES (3, r_D);
-    break;
-  case RES_3_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_E)
     BIT_RES (3, r_E);
-    break;
-  case RES_3_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_H)
     BIT_RES (3, r_H);
-    break;
-  case RES_3_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_L)
     BIT_RES (3, r_L);
-    break;
-  case RES_3_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_3_xHL)
     BIT_mem_RES (3, r_HL);
-    break;
-  case RES_3_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_3_A)
     BIT_RES (3, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_4_B:
+  OPCODE (RES_4_B)
     BIT_RES (4, r_B);
-    break;
-  case RES_4_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_C)
     BIT_RES (4, r_C);
-    break;
-  case RES_4_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_D)
     BIT_RES (4, r_D);
-    break;
-  case RES_4_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_E)
     BIT_RES (4, r_E);
-    break;
-  case RES_4_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_H)
     BIT_RES (4, r_H);
-    break;
-  case RES_4_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_L)
     BIT_RES (4, r_L);
-    break;
-  case RES_4_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_4_xHL)
     BIT_mem_RES (4, r_HL);
-    break;
-  case RES_4_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_4_A)
     BIT_RES (4, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_5_B:
+  OPCODE (RES_5_B)
     BIT_RES (5, r_B);
-    break;
-  case RES_5_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_C)
     BIT_RES (5, r_C);
-    break;
-  case RES_5_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_D)
     BIT_RES (5, r_D);
-    break;
-  case RES_5_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_E)
     BIT_RES (5, r_E);
-    break;
-  case RES_5_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_H)
     BIT_RES (5, r_H);
-    break;
-  case RES_5_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_L)
     BIT_RES (5, r_L);
-    break;
-  case RES_5_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_5_xHL)
     BIT_mem_RES (5, r_HL);
-    break;
-  case RES_5_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_5_A)
     BIT_RES (5, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_6_B:
+  OPCODE (RES_6_B)
     BIT_RES (6, r_B);
-    break;
-  case RES_6_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_C)
     BIT_RES (6, r_C);
-    break;
-  case RES_6_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_D)
     BIT_RES (6, r_D);
-    break;
-  case RES_6_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_E)
     BIT_RES (6, r_E);
-    break;
-  case RES_6_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_H)
     BIT_RES (6, r_H);
-    break;
-  case RES_6_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_L)
     BIT_RES (6, r_L);
-    break;
-  case RES_6_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_6_xHL)
     BIT_mem_RES (6, r_HL);
-    break;
-  case RES_6_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_6_A)
     BIT_RES (6, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case RES_7_B:
+  OPCODE (RES_7_B)
     BIT_RES (7, r_B);
-    break;
-  case RES_7_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_C)
     BIT_RES (7, r_C);
-    break;
-  case RES_7_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_D)
     BIT_RES (7, r_D);
-    break;
-  case RES_7_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_E)
     BIT_RES (7, r_E);
-    break;
-  case RES_7_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_H)
     BIT_RES (7, r_H);
-    break;
-  case RES_7_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_L)
     BIT_RES (7, r_L);
-    break;
-  case RES_7_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (RES_7_xHL)
     BIT_mem_RES (7, r_HL);
-    break;
-  case RES_7_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (RES_7_A)
     BIT_RES (7, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_0_B:
+  OPCODE (SET_0_B)
     BIT_SET (0, r_B);
-    break;
-  case SET_0_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_C)
     BIT_SET (0, r_C);
-    break;
-  case SET_0_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_D)
     BIT_SET (0, r_D);
-    break;
-  case SET_0_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_E)
     BIT_SET (0, r_E);
-    break;
-  case SET_0_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_H)
     BIT_SET (0, r_H);
-    break;
-  case SET_0_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_L)
     BIT_SET (0, r_L);
-    break;
-  case SET_0_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_0_xHL)
     BIT_mem_SET (0, r_HL);
-    break;
-  case SET_0_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_0_A)
     BIT_SET (0, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_1_B:
+  OPCODE (SET_1_B)
     BIT_SET (1, r_B);
-    break;
-  case SET_1_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_C)
     BIT_SET (1, r_C);
-    break;
-  case SET_1_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_D)
     BIT_SET (1, r_D);
-    break;
-  case SET_1_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_E)
     BIT_SET (1, r_E);
-    break;
-  case SET_1_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_H)
     BIT_SET (1, r_H);
-    break;
-  case SET_1_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_L)
     BIT_SET (1, r_L);
-    break;
-  case SET_1_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_1_xHL)
     BIT_mem_SET (1, r_HL);
-    break;
-  case SET_1_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_1_A)
     BIT_SET (1, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_2_B:
+  OPCODE (SET_2_B)
     BIT_SET (2, r_B);
-    break;
-  case SET_2_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_C)
     BIT_SET (2, r_C);
-    break;
-  case SET_2_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_D)
     BIT_SET (2, r_D);
-    break;
-  case SET_2_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_E)
     BIT_SET (2, r_E);
-    break;
-  case SET_2_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_H)
     BIT_SET (2, r_H);
-    break;
-  case SET_2_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_L)
     BIT_SET (2, r_L);
-    break;
-  case SET_2_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_2_xHL)
     BIT_mem_SET (2, r_HL);
-    break;
-  case SET_2_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_2_A)
     BIT_SET (2, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_3_B:
+  OPCODE (SET_3_B)
     BIT_SET (3, r_B);
-    break;
-  case SET_3_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_C)
     BIT_SET (3, r_C);
-    break;
-  case SET_3_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_D)
     BIT_SET (3, r_D);
-    break;
-  case SET_3_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_E)
     BIT_SET (3, r_E);
-    break;
-  case SET_3_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_H)
     BIT_SET (3, r_H);
-    break;
-  case SET_3_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_L)
     BIT_SET (3, r_L);
-    break;
-  case SET_3_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_3_xHL)
     BIT_mem_SET (3, r_HL);
-    break;
-  case SET_3_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_3_A)
     BIT_SET (3, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_4_B:
+  OPCODE (SET_4_B)
     BIT_SET (4, r_B);
-    break;
-  case SET_4_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_C)
     BIT_SET (4, r_C);
-    break;
-  case SET_4_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_D)
     BIT_SET (4, r_D);
-    break;
-  case SET_4_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_E)
     BIT_SET (4, r_E);
-    break;
-  case SET_4_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_H)
     BIT_SET (4, r_H);
-    break;
-  case SET_4_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_L)
     BIT_SET (4, r_L);
-    break;
-  case SET_4_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_4_xHL)
     BIT_mem_SET (4, r_HL);
-    break;
-  case SET_4_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_4_A)
     BIT_SET (4, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_5_B:
+  OPCODE (SET_5_B)
     BIT_SET (5, r_B);
-    break;
-  case SET_5_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_C)
     BIT_SET (5, r_C);
-    break;
-  case SET_5_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_D)
     BIT_SET (5, r_D);
-    break;
-  case SET_5_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_E)
     BIT_SET (5, r_E);
-    break;
-  case SET_5_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_H)
     BIT_SET (5, r_H);
-    break;
-  case SET_5_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_L)
     BIT_SET (5, r_L);
-    break;
-  case SET_5_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_5_xHL)
     BIT_mem_SET (5, r_HL);
-    break;
-  case SET_5_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_5_A)
     BIT_SET (5, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_6_B:
+  OPCODE (SET_6_B)
     BIT_SET (6, r_B);
-    break;
-  case SET_6_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_C)
     BIT_SET (6, r_C);
-    break;
-  case SET_6_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_D)
     BIT_SET (6, r_D);
-    break;
-  case SET_6_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_E)
     BIT_SET (6, r_E);
-    break;
-  case SET_6_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_H)
     BIT_SET (6, r_H);
-    break;
-  case SET_6_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_L)
     BIT_SET (6, r_L);
-    break;
-  case SET_6_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_6_xHL)
     BIT_mem_SET (6, r_HL);
-    break;
-  case SET_6_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_6_A)
     BIT_SET (6, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case SET_7_B:
+  OPCODE (SET_7_B)
     BIT_SET (7, r_B);
-    break;
-  case SET_7_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_C)
     BIT_SET (7, r_C);
-    break;
-  case SET_7_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_D)
     BIT_SET (7, r_D);
-    break;
-  case SET_7_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_E)
     BIT_SET (7, r_E);
-    break;
-  case SET_7_H:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_H)
     BIT_SET (7, r_H);
-    break;
-  case SET_7_L:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_L)
     BIT_SET (7, r_L);
-    break;
-  case SET_7_xHL:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SET_7_xHL)
     BIT_mem_SET (7, r_HL);
-    break;
-  case SET_7_A:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SET_7_A)
     BIT_SET (7, r_A);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  default:
+  OPCODE_DEFAULT
 //    exit(1);
     if (regs->DecodingErrors)
       printf ("z80 core: Unknown instruction: CB %02Xh at PC=%04Xh.\n",
-	      Z80ReadMem (r_PC - 1), r_PC - 2);
-    break;
+	      READ_MEM (r_PC - 1), r_PC - 2);
+    NEXT;
   }
@@ -44,406 +44,495 @@
 #define REGL REGISTER.B.l
 #define REGH REGISTER.B.h
 
-opcode = Z80ReadMem (r_PC);
-AddCycles(1);
+opcode = READ_MEM (r_PC);
+CONTENDED (AddCycles(1));
 r_PC++;
 
 #define AddCycles2(x) AddCycles((x)-8)
 
-switch (opcode)
+OPCODE_SWITCH (opcode)
   {
-  case ADD_IXY_BC:
-    contend_read_byte_x7();
+  OPCODE (ADD_IXY_BC)
+    CONTENDED (contend_read_byte_x7());
     ADD_WORD (REG, r_BC);
-    break;
-  case ADD_IXY_DE:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADD_IXY_DE)
+    CONTENDED (contend_read_byte_x7());
     ADD_WORD (REG, r_DE);
-    break;
-  case ADD_IXY_SP:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADD_IXY_SP)
+    CONTENDED (contend_read_byte_x7());
     ADD_WORD (REG, r_SP);
-    break;
-  case ADD_IXY_IXY:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADD_IXY_IXY)
+    CONTENDED (contend_read_byte_x7());
     ADD_WORD (REG, REG);
-    break;
-  case DEC_IXY:
-    contend_read_byte_x2();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (DEC_IXY)
+    CONTENDED (contend_read_byte_x2());
     REG--;
-    break;
-  case INC_IXY:
-    contend_read_byte_x2();
+    UNCONTENDED (AddCycles (10));
+    NEXT;
+  OPCODE (INC_IXY)
+    CONTENDED (contend_read_byte_x2());
     REG++;
-    break;
+    UNCONTENDED (AddCycles (10));
+    NEXT;
 
-  case JP_IXY:
+  OPCODE (JP_IXY)
     r_PC = REG;
-    break;
-  case LD_SP_IXY:
-    contend_read_byte_x2();
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_SP_IXY)
+    CONTENDED (contend_read_byte_x2());
     r_SP = REG;
-    break;
+    UNCONTENDED (AddCycles (10));
+    NEXT;
 
-  case PUSH_IXY:
-    contend_read_byte();
+  OPCODE (PUSH_IXY)
+    CONTENDED (contend_read_byte());
     PUSH_IXYr ();
-    break;
-  case POP_IXY:
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (POP_IXY)
     POP_IXYr ();
-    break;
-
-  case EX_IXY_xSP:
-    r_meml = Z80ReadMem (r_SP);
-    r_memh = Z80ReadMem (r_SP + 1);contend_read(r_SP+1);
-    Z80WriteMem (r_SP + 1, REGH, regs);
-    Z80WriteMem (r_SP, REGL, regs);
-    contend_read_x2(r_SP);
+    UNCONTENDED (AddCycles (14));
+    NEXT;
+
+  OPCODE (EX_IXY_xSP)
+    r_meml = READ_MEM (r_SP);
+    r_memh = READ_MEM (r_SP + 1);
+    CONTENDED (contend_read(r_SP+1));
+    WRITE_MEM (r_SP + 1, REGH);
+    WRITE_MEM (r_SP, REGL);
+    CONTENDED (contend_read_x2(r_SP));
     REGL = r_meml;
     REGH = r_memh;
-    break;
+    UNCONTENDED (AddCycles (23));
+    NEXT;
 
-  case LD_A_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_A = Z80ReadMem (REG + ((offset) r_meml));
+  OPCODE (LD_A_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_A = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
-  case LD_B_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_B = Z80ReadMem (REG + ((offset) r_meml));
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_B_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_B = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
-  case LD_C_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_C = Z80ReadMem (REG + ((offset) r_meml));
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_C_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_C = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
-  case LD_D_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_D = Z80ReadMem (REG + ((offset) r_meml));
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_D_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_D = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
-  case LD_E_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_E = Z80ReadMem (REG + ((offset) r_meml));
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_E_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_E = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case LD_xIXY_A:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    Z80WriteMem (REG + (offset) r_meml, r_A, regs);
+  OPCODE (LD_xIXY_A)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    WRITE_MEM (REG + (offset) r_meml, r_A);
     r_PC++;
-    break;
-  case LD_xIXY_B:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    Z80WriteMem (REG + (offset) r_meml, r_B, regs);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_xIXY_B)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    WRITE_MEM (REG + (offset) r_meml, r_B);
     r_PC++;
-    break;
-  case LD_xIXY_C:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    Z80WriteMem (REG + (offset) r_meml, r_C, regs);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_xIXY_C)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    WRITE_MEM (REG + (offset) r_meml, r_C);
     r_PC++;
-    break;
-  case LD_xIXY_D:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    Z80WriteMem (REG + (offset) r_meml, r_D, regs);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_xIXY_D)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    WRITE_MEM (REG + (offset) r_meml, r_D);
     r_PC++;
-    break;
-  case LD_xIXY_E:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    Z80WriteMem (REG + (offset) r_meml, r_E, regs);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_xIXY_E)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    WRITE_MEM (REG + (offset) r_meml, r_E);
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case INC_xIXY:
-    r_mem = REG + (offset) Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
+  OPCODE (INC_xIXY)
+    r_mem = REG + (offset) READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
     r_PC++;
-    tmpreg.B.l = Z80ReadMem (r_mem);
-    INC (tmpreg.B.l);contend_read(r_mem);
-    Z80WriteMem (r_mem, tmpreg.B.l, regs);
-    break;
+    tmpreg.B.l = READ_MEM (r_mem);
+    INC (tmpreg.B.l);
+    CONTENDED (contend_read(r_mem));
+    WRITE_MEM (r_mem, tmpreg.B.l);
+    UNCONTENDED (AddCycles (23));
+    NEXT;
     
-  case DEC_xIXY:
-    r_mem = REG + (offset) Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
+  OPCODE (DEC_xIXY)
+    r_mem = REG + (offset) READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
     r_PC++;
-    tmpreg.B.l = Z80ReadMem (r_mem);
-    DEC (tmpreg.B.l);contend_read(r_mem);
-    Z80WriteMem (r_mem, tmpreg.B.l, regs);
-    break;
-
-  case ADC_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    tmpreg.B.l = READ_MEM (r_mem);
+    DEC (tmpreg.B.l);
+    CONTENDED (contend_read(r_mem));
+    WRITE_MEM (r_mem, tmpreg.B.l);
+    UNCONTENDED (AddCycles (23));
+    NEXT;
+
+  OPCODE (ADC_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     ADC (r_meml);
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case SBC_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+  OPCODE (SBC_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     SBC (r_meml);
-    break;
-  case ADD_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (ADD_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     ADD (r_meml);
-    break;
-  case SUB_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (SUB_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     SUB (r_meml);
-    break;
-  case AND_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (AND_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     AND (r_meml);
-    break;
-  case OR_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (OR_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     OR (r_meml);
-    break;
-  case XOR_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (XOR_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     XOR (r_meml);
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case CP_xIXY:
-    r_memh = Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_meml = Z80ReadMem (REG + (offset) r_memh);
+  OPCODE (CP_xIXY)
+    r_memh = READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_meml = READ_MEM (REG + (offset) r_memh);
     r_PC++;
     CP (r_meml);
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case LD_IXY_NN:
-    REGL = Z80ReadMem (r_PC);
+  OPCODE (LD_IXY_NN)
+    REGL = READ_MEM (r_PC);
     r_PC++;
-    REGH = Z80ReadMem (r_PC);
+    REGH = READ_MEM (r_PC);
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (14));
+    NEXT;
 
-  case LD_xIXY_N:
-    r_mem = REG + (offset) Z80ReadMem (r_PC);
+  OPCODE (LD_xIXY_N)
+    r_mem = REG + (offset) READ_MEM (r_PC);
     r_PC++;
-    r_tmph=Z80ReadMem (r_PC);
-    contend_read_x2(r_PC);
-    Z80WriteMem (r_mem, r_tmph, regs);
+    r_tmph=READ_MEM (r_PC);
+    CONTENDED (contend_read_x2(r_PC));
+    WRITE_MEM (r_mem, r_tmph);
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case LD_IXY_xNN:
+  OPCODE (LD_IXY_xNN)
     LOAD_rr_nn (REG);
-    break;
+    UNCONTENDED (AddCycles (20));
+    NEXT;
 
-  case LD_xNN_IXY:
+  OPCODE (LD_xNN_IXY)
     STORE_nn_rr (REG);
-    break;
+    UNCONTENDED (AddCycles (20));
+    NEXT;
 
 
 /* some undocumented opcodes: may be wrong: */
-  case LD_A_IXYh:
+  OPCODE (LD_A_IXYh)
     r_A = REGH;
-    break;
-  case LD_A_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_A_IXYl)
     r_A = REGL;
-    break;
-  case LD_B_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_B_IXYh)
     r_B = REGH;
-    break;
-  case LD_B_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_B_IXYl)
     r_B = REGL;
-    break;
-  case LD_C_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_C_IXYh)
     r_C = REGH;
-    break;
-  case LD_C_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_C_IXYl)
     r_C = REGL;
-    break;
-  case LD_D_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_D_IXYh)
     r_D = REGH;
-    break;
-  case LD_D_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_D_IXYl)
     r_D = REGL;
-    break;
-  case LD_E_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_E_IXYh)
     r_E = REGH;
-    break;
-  case LD_E_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_E_IXYl)
     r_E = REGL;
-    break;
-  case LD_IXYh_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_A)
     REGH = r_A;
-    break;
-  case LD_IXYh_B:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_B)
     REGH = r_B;
-    break;
-  case LD_IXYh_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_C)
     REGH = r_C;
-    break;
-  case LD_IXYh_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_D)
     REGH = r_D;
-    break;
-  case LD_IXYh_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_E)
     REGH = r_E;
-    break;
-  case LD_IXYh_IXYh:
-    break;
-  case LD_IXYh_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_IXYh)
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_IXYl)
     REGH = REGL;
-    break;
-  case LD_IXYl_A:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_A)
     REGL = r_A;
-    break;
-  case LD_IXYl_B:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_B)
     REGL = r_B;
-    break;
-  case LD_IXYl_C:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_C)
     REGL = r_C;
-    break;
-  case LD_IXYl_D:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_D)
     REGL = r_D;
-    break;
-  case LD_IXYl_E:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_E)
     REGL = r_E;
-    break;
-  case LD_IXYl_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_IXYh)
     REGL = REGH;
-    break;
-  case LD_IXYl_IXYl:
-    break;
-  case LD_IXYh_N:
-    REGH = Z80ReadMem (r_PC);
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYl_IXYl)
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (LD_IXYh_N)
+    REGH = READ_MEM (r_PC);
     r_PC++;
-    break;
-  case LD_IXYl_N:
-    REGL = Z80ReadMem (r_PC);
+    UNCONTENDED (AddCycles (11));
+    NEXT;
+  OPCODE (LD_IXYl_N)
+    REGL = READ_MEM (r_PC);
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (11));
+    NEXT;
 
 
-  case ADD_IXYh:
+  OPCODE (ADD_IXYh)
     ADD (REGH);
-    break;
-  case ADD_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (ADD_IXYl)
     ADD (REGL);
-    break;
-  case ADC_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (ADC_IXYh)
     ADC (REGH);
-    break;
-  case ADC_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (ADC_IXYl)
     ADC (REGL);
-    break;
-  case SUB_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SUB_IXYh)
     SUB (REGH);
-    break;
-  case SUB_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SUB_IXYl)
     SUB (REGL);
-    break;
-  case SBC_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SBC_IXYh)
     SBC (REGH);
-    break;
-  case SBC_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (SBC_IXYl)
     SBC (REGL);
-    break;
-  case AND_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (AND_IXYh)
     AND (REGH);
-    break;
-  case AND_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (AND_IXYl)
     AND (REGL);
-    break;
-  case XOR_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (XOR_IXYh)
     XOR (REGH);
-    break;
-  case XOR_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (XOR_IXYl)
     XOR (REGL);
-    break;
-  case OR_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (OR_IXYh)
     OR (REGH);
-    break;
-  case OR_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (OR_IXYl)
     OR (REGL);
-    break;
-  case CP_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (CP_IXYh)
     CP (REGH);
-    break;
-  case CP_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (CP_IXYl)
     CP (REGL);
-    break;
-  case INC_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (INC_IXYh)
     INC (REGH);
-    break;
-  case INC_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (INC_IXYl)
     INC (REGL);
-    break;
-  case DEC_IXYh:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (DEC_IXYh)
     DEC (REGH);
-    break;
-  case DEC_IXYl:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+  OPCODE (DEC_IXYl)
     DEC (REGL);
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case LD_xIXY_H:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
+  OPCODE (LD_xIXY_H)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
     r_PC++;
-    Z80WriteMem (REG + (offset) r_meml, r_H, regs);
-    break;
-  case LD_xIXY_L:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
+    WRITE_MEM (REG + (offset) r_meml, r_H);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_xIXY_L)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
     r_PC++;
-    Z80WriteMem (REG + (offset) r_meml, r_L, regs);
-    break;
-  case LD_H_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_H = Z80ReadMem (REG + ((offset) r_meml));
+    WRITE_MEM (REG + (offset) r_meml, r_L);
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_H_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_H = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
-  case LD_L_xIXY:
-    r_meml=Z80ReadMem (r_PC);
-    contend_read_x5(r_PC);
-    r_L = Z80ReadMem (REG + ((offset) r_meml));
+    UNCONTENDED (AddCycles (19));
+    NEXT;
+  OPCODE (LD_L_xIXY)
+    r_meml=READ_MEM (r_PC);
+    CONTENDED (contend_read_x5(r_PC));
+    r_L = READ_MEM (REG + ((offset) r_meml));
     r_PC++;
-    break;
+    UNCONTENDED (AddCycles (19));
+    NEXT;
 
-  case PREFIX_CB:
+  OPCODE (PREFIX_CB)
 #ifndef CPP_COMPILATION
 #include "opddfdcb.c"
 #else
 #include "opddfdcb.cpp"
 #endif
-    break;
+    NEXT;
 
-  default:
-    AddCycles2 (4);
+  OPCODE_DEFAULT
+    CONTENDED (AddCycles2 (4));
+    UNCONTENDED (AddCycles (4));
     r_PC--;			/* decode it the next time :) */
     SubR (1);
 
@@ -457,7 +546,7 @@ switch (opcode)
 //         printf("FD ");
 //      printf("%02Xh at PC=%04Xh.\n", Z80ReadMem(r_PC-1), r_PC-2 );
 //    }
-    break;
+    NEXT;
   }
 
 #undef AddCycles2
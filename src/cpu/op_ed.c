@@ -30,230 +30,286 @@
 
 /* 8 clock cycles minimum = ED opcode = 4 + 4 */
 
-opcode = Z80ReadMem (r_PC);
-AddCycles(1);
+opcode = READ_MEM (r_PC);
+CONTENDED (AddCycles(1));
 r_PC++;
 
-switch (opcode)
+OPCODE_SWITCH (opcode)
   {
-  case TRAPLOAD:
+  OPCODE (TRAPLOAD)
 	 r_PC++;
+	Z80_SPILL ();
+	FLAGS_SYNC ();
 	Z80Patch (regs);
-	break;
-  case LD_BC_xNNe:
+	Z80_RELOAD ();
+	NEXT;
+  OPCODE (LD_BC_xNNe)
     LOAD_rr_nn (r_BC);
-    break;
-  case LD_DE_xNNe:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_DE_xNNe)
     LOAD_rr_nn (r_DE);
-    break;
-  case LD_HL_xNNe:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_HL_xNNe)
     LOAD_rr_nn (r_HL);
-    break;
-  case LD_SP_xNNe:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_SP_xNNe)
     LOAD_rr_nn (r_SP);
-    break;
+    UNCONTENDED (AddCycles (20));
+    NEXT;
 
-  case LD_xNNe_BC:
+  OPCODE (LD_xNNe_BC)
     STORE_nn_rr (r_BC);
-    break;
-  case LD_xNNe_DE:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_xNNe_DE)
     STORE_nn_rr (r_DE);
-    break;
-  case LD_xNNe_HL:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_xNNe_HL)
     STORE_nn_rr (r_HL);
-    break;
-  case LD_xNNe_SP:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+  OPCODE (LD_xNNe_SP)
     STORE_nn_rr (r_SP);
-    break;
-
-  case NEG:
-  case ED_5C:
-  case ED_74:
-  case ED_7C:
-  case ED_6C:
-  case ED_54:
-  case ED_4C:
-  case ED_64:
+    UNCONTENDED (AddCycles (20));
+    NEXT;
+
+  OPCODE (NEG)
+  OPCODE (ED_5C)
+  OPCODE (ED_74)
+  OPCODE (ED_7C)
+  OPCODE (ED_6C)
+  OPCODE (ED_54)
+  OPCODE (ED_4C)
+  OPCODE (ED_64)
     NEG_A ();
-    break;
-
-  case RETI:
-  case RETN:
-  case ED_65:
-  case ED_6D:
-  case ED_75:
-  case ED_7D:
-  case ED_5D:
-  case ED_55:
+    UNCONTENDED (AddCycles (8));
+    NEXT;
+
+  OPCODE (RETI)
+  OPCODE (RETN)
+  OPCODE (ED_65)
+  OPCODE (ED_6D)
+  OPCODE (ED_75)
+  OPCODE (ED_7D)
+  OPCODE (ED_5D)
+  OPCODE (ED_55)
     r_IFF1 = r_IFF2;
     RET_nn ();
-    break;
+    UNCONTENDED (AddCycles (14));
+    NEXT;
 
-  case IM_0:
-  case ED_4E:			/* * IM 0/1 */
-  case ED_6E:
-  case ED_66:
+  OPCODE (IM_0)
+  OPCODE (ED_4E)			/* * IM 0/1 */
+  OPCODE (ED_6E)
+  OPCODE (ED_66)
     regs->IM = 0;
-    break;			/* * IM 0 */
+    UNCONTENDED (AddCycles (8));
+    NEXT;			/* * IM 0 */
 
 
-  case IM_1:
-  case ED_76:
+  OPCODE (IM_1)
+  OPCODE (ED_76)
     regs->IM = 1;
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case IM_2:
-  case ED_7E:
+  OPCODE (IM_2)
+  OPCODE (ED_7E)
     regs->IM = 2;
-    break;
+    UNCONTENDED (AddCycles (8));
+    NEXT;
 
-  case ED_77:
-  case ED_7F:
-    break;			/* * NOP */
+  OPCODE (ED_77)
+  OPCODE (ED_7F)
+    UNCONTENDED (AddCycles (8));
+    NEXT;			/* * NOP */
 
-  case OUT_xC_B:
-    ula_contend_port_early(r_BC);
+  OPCODE (OUT_xC_B)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_B);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_C:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_C)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_C);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_D:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_D)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_D);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_E:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_E)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_E);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_H:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_H)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_H);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_L:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_L)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_L);
-    ula_contend_port_late(r_BC);
-    break;
-  case OUT_xC_A:
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
+  OPCODE (OUT_xC_A)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, r_A);
-    ula_contend_port_late(r_BC);
-    break;
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
     /* * OUT (C), 0 */
-  case ED_71:
-    ula_contend_port_early(r_BC);
+  OPCODE (ED_71)
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (9));
     Z80OutPort (regs, r_BC, 0);
-    ula_contend_port_late(r_BC);
-    break;
+    CONTENDED (ula_contend_port_late(r_BC));
+    UNCONTENDED (AddCycles (3));
+    NEXT;
 
-  case IN_B_xC:
+  OPCODE (IN_B_xC)
     IN_PORT (r_B, r_BC);
-    break;
-  case IN_C_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_C_xC)
     IN_PORT (r_C, r_BC);
-    break;
-  case IN_D_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_D_xC)
     IN_PORT (r_D, r_BC);
-    break;
-  case IN_E_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_E_xC)
     IN_PORT (r_E, r_BC);
-    break;
-  case IN_L_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_L_xC)
     IN_PORT (r_L, r_BC);
-    break;
-  case IN_H_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_H_xC)
     IN_PORT (r_H, r_BC);
-    break;
-  case IN_A_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_A_xC)
     IN_PORT (r_A, r_BC);
-    break;
-  case IN_F_xC:
+    UNCONTENDED (AddCycles (12));
+    NEXT;
+  OPCODE (IN_F_xC)
     IN_PORT (r_meml, r_BC);
-    break;
+    UNCONTENDED (AddCycles (12));
+    NEXT;
 
-  case LD_A_I:
-    contend_read_byte();
+  OPCODE (LD_A_I)
+    CONTENDED (contend_read_byte());
     r_A = regs->I;
     r_F = (r_F & FLAG_C) | sz53_table[r_A] | (regs->IFF2 ? FLAG_V : 0);
-    break;
+    UNCONTENDED (AddCycles (9));
+    NEXT;
 
-  case LD_I_A:
-    contend_read_byte();
+  OPCODE (LD_I_A)
+    CONTENDED (contend_read_byte());
     regs->I = r_A;
-    break;
+    UNCONTENDED (AddCycles (9));
+    NEXT;
 
-  case LD_A_R:
-    contend_read_byte();
+  OPCODE (LD_A_R)
+    CONTENDED (contend_read_byte());
     r_A = (r_R & 0x7f) | (r_R7 & 0x80);
     r_F = (r_F & FLAG_C) | sz53_table[r_A] | (regs->IFF2 ? FLAG_V : 0);
-    break;
+    UNCONTENDED (AddCycles (9));
+    NEXT;
 
-  case LD_R_A:
-    contend_read_byte();
+  OPCODE (LD_R_A)
+    CONTENDED (contend_read_byte());
     r_R7 = r_R = r_A;
-    break;
+    UNCONTENDED (AddCycles (9));
+    NEXT;
 
 
-  case ADC_HL_BC:
-    contend_read_byte_x7();
+  OPCODE (ADC_HL_BC)
+    CONTENDED (contend_read_byte_x7());
     ADC_WORD (r_BC);
-    break;
-  case ADC_HL_DE:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADC_HL_DE)
+    CONTENDED (contend_read_byte_x7());
     ADC_WORD (r_DE);
-    break;
-  case ADC_HL_HL:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADC_HL_HL)
+    CONTENDED (contend_read_byte_x7());
     ADC_WORD (r_HL);
-    break;
-  case ADC_HL_SP:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (ADC_HL_SP)
+    CONTENDED (contend_read_byte_x7());
     ADC_WORD (r_SP);
-    break;
+    UNCONTENDED (AddCycles (15));
+    NEXT;
 
-  case SBC_HL_BC:
-    contend_read_byte_x7();
+  OPCODE (SBC_HL_BC)
+    CONTENDED (contend_read_byte_x7());
     SBC_WORD (r_BC);
-    break;
-  case SBC_HL_DE:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SBC_HL_DE)
+    CONTENDED (contend_read_byte_x7());
     SBC_WORD (r_DE);
-    break;
-  case SBC_HL_HL:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SBC_HL_HL)
+    CONTENDED (contend_read_byte_x7());
     SBC_WORD (r_HL);
-    break;
-  case SBC_HL_SP:
-    contend_read_byte_x7();
+    UNCONTENDED (AddCycles (15));
+    NEXT;
+  OPCODE (SBC_HL_SP)
+    CONTENDED (contend_read_byte_x7());
     SBC_WORD (r_SP);
-    break;
+    UNCONTENDED (AddCycles (15));
+    NEXT;
 
-  case RRD:
-    r_meml = Z80ReadMem (r_HL);
-    contend_read_x4(r_HL);
-    Z80WriteMem (r_HL, (r_A << 4) | (r_meml >> 4), regs);
+  OPCODE (RRD)
+    r_meml = READ_MEM (r_HL);
+    CONTENDED (contend_read_x4(r_HL));
+    WRITE_MEM (r_HL, (r_A << 4) | (r_meml >> 4));
     r_A = (r_A & 0xf0) | (r_meml & 0x0f);
     r_F = (r_F & FLAG_C) | sz53p_table[r_A];
-    break;
+    UNCONTENDED (AddCycles (18));
+    NEXT;
 
-  case RLD:
-    r_meml = Z80ReadMem (r_HL);
-    contend_read_x4(r_HL);
-    Z80WriteMem (r_HL, (r_meml << 4) | (r_A & 0x0f), regs);
+  OPCODE (RLD)
+    r_meml = READ_MEM (r_HL);
+    CONTENDED (contend_read_x4(r_HL));
+    WRITE_MEM (r_HL, (r_meml << 4) | (r_A & 0x0f));
     r_A = (r_A & 0xf0) | (r_meml >> 4);
     r_F = (r_F & FLAG_C) | sz53p_table[r_A];
-    break;
+    UNCONTENDED (AddCycles (18));
+    NEXT;
 
-  case LDI:
-    r_meml = Z80ReadMem (r_HL);
-    Z80WriteMem (r_DE, r_meml, regs);contend_read_x2(r_DE);
+  OPCODE (LDI)
+    r_meml = READ_MEM (r_HL);
+    WRITE_MEM (r_DE, r_meml);
+    CONTENDED (contend_read_x2(r_DE));
     r_DE++;
     r_HL++;
     r_BC--;
@@ -261,64 +317,80 @@ switch (opcode)
     r_F = (r_F & (FLAG_C | FLAG_Z | FLAG_S)) |
       (r_BC ? FLAG_V : 0) | (r_meml & FLAG_3) |
       ((r_meml & 0x02) ? FLAG_5 : 0);
-    break;
-
-  case LDIR:
-    r_meml = Z80ReadMem (r_HL);
-    Z80WriteMem (r_DE, r_meml, regs);contend_read_x2(r_DE);
+    UNCONTENDED (AddCycles (16));
+    NEXT;
+
+  OPCODE (LDIR)
+  REPEAT_LABEL (LDIR)
+    BLOCK_BATCH_LD (1);
+    r_meml = READ_MEM (r_HL);
+    WRITE_MEM (r_DE, r_meml);
+    CONTENDED (contend_read_x2(r_DE));
     r_BC--;
     r_meml += r_A;
     r_F = (r_F & (FLAG_C | FLAG_Z | FLAG_S)) |
       (r_BC ? FLAG_V : 0) | (r_meml & FLAG_3) |
       ((r_meml & 0x02) ? FLAG_5 : 0);
+    UNCONTENDED (AddCycles (16));
     if (r_BC)
       {
-      contend_read_x5(r_DE);
+      CONTENDED (contend_read_x5(r_DE));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_DE++;
     r_HL++;
-    break;
+    if (r_BC)
+      REPEAT_BLOCK (LDIR);
+    NEXT;
 
-  case LDD:
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (LDD)
+    r_meml = READ_MEM (r_HL);
     r_HL--;
-    Z80WriteMem (r_DE, r_meml, regs);contend_read_x2(r_DE);
+    WRITE_MEM (r_DE, r_meml);
+    CONTENDED (contend_read_x2(r_DE));
     r_DE--;
     r_BC--;
     r_meml += r_A;
     r_F = (r_F & (FLAG_C | FLAG_Z | FLAG_S)) |
       (r_BC ? FLAG_V : 0) | (r_meml & FLAG_3) |
       ((r_meml & 0x02) ? FLAG_5 : 0);
-    break;
+    UNCONTENDED (AddCycles (16));
+    NEXT;
 
 
-  case LDDR:
-    r_meml = Z80ReadMem (r_HL);
-    Z80WriteMem (r_DE, r_meml, regs);contend_read_x2(r_DE);
-
+  OPCODE (LDDR)
+  REPEAT_LABEL (LDDR)
+    BLOCK_BATCH_LD (-1);
+    r_meml = READ_MEM (r_HL);
+    WRITE_MEM (r_DE, r_meml);
+    CONTENDED (contend_read_x2(r_DE));
     r_BC--;
     r_meml += r_A;
     r_F = (r_F & (FLAG_C | FLAG_Z | FLAG_S)) |
       (r_BC ? FLAG_V : 0) | (r_meml & FLAG_3) |
       ((r_meml & 0x02) ? FLAG_5 : 0);
+    UNCONTENDED (AddCycles (16));
     if (r_BC)
       {
-      contend_read_x5(r_DE);
+      CONTENDED (contend_read_x5(r_DE));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_HL--;
     r_DE--;
-    break;
+    if (r_BC)
+      REPEAT_BLOCK (LDDR);
+    NEXT;
 
     // I had lots of problems with CPI, INI, CPD, IND, OUTI, OUTD and so...
     // Thanks a lot to Philip Kendall for letting me to take a look to his
     // fuse emulator and allowing me to use their flag routines :-)
-  case CPI:		// "Inspired" by YAZE
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (CPI)		// "Inspired" by YAZE
+    r_meml = READ_MEM (r_HL);
     r_memh = r_A - r_meml;
     r_opl = r_A ^ r_meml ^ r_memh;
-    contend_read_x5(r_HL);  // Before or after HL is increased?
+    CONTENDED (contend_read_x5(r_HL));  // Before or after HL is increased?
     r_HL++;
     r_F = (r_F & FLAG_C) | (r_memh & FLAG_S) | (!(r_memh & 0xff)<<6)|
         (((r_memh - ((r_opl&16)>>4))&2) << 4) | (r_opl & 16) |
@@ -326,13 +398,16 @@ switch (opcode)
 	((--r_BC & 0xffff) != 0) << 2 | 2;
     if ((r_memh & 15) == 8 && (r_opl & 16) != 0)
     	r_F &= ~8;
-    break;
+    UNCONTENDED (AddCycles (16));
+    NEXT;
 
-  case CPIR:
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (CPIR)
+  REPEAT_LABEL (CPIR)
+    BLOCK_BATCH_CP (1);
+    r_meml = READ_MEM (r_HL);
     r_memh = r_A - r_meml;
     r_opl = r_A ^ r_meml ^ r_memh;
-    contend_read_x5(r_HL);
+    CONTENDED (contend_read_x5(r_HL));
     r_F = (r_F & FLAG_C) | (r_memh & FLAG_S) | (!(r_memh & 0xff)<<6)|
         (((r_memh - ((r_opl&16)>>4))&2) << 4) | (r_opl & 16) |
 	((r_memh - ((r_opl >> 4) & 1)) & 8) |
@@ -340,20 +415,24 @@ switch (opcode)
     if ((r_memh & 15) == 8 && (r_opl & 16) != 0)
     	r_F &= ~8;
 
+    UNCONTENDED (AddCycles (16));
     if ((r_F & (FLAG_V | FLAG_Z)) == FLAG_V)
       {
-      contend_read_x5(r_HL);
+      CONTENDED (contend_read_x5(r_HL));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_HL++;
-    break;
+    if ((r_F & (FLAG_V | FLAG_Z)) == FLAG_V)
+      REPEAT_BLOCK (CPIR);
+    NEXT;
 
-  case CPD:
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (CPD)
+    r_meml = READ_MEM (r_HL);
     r_memh = r_A - r_meml;
     r_opl = ((r_A & 0x08) >> 3) |
       (((r_meml) & 0x08) >> 2) | ((r_memh & 0x08) >> 1);
-    contend_read_x5(r_HL);
+    CONTENDED (contend_read_x5(r_HL));
     r_HL--;
     r_BC--;
     r_F = (r_F & FLAG_C) |
@@ -362,14 +441,17 @@ switch (opcode)
     if (r_F & FLAG_H)
       r_memh--;
     r_F |= (r_memh & FLAG_3) | ((r_memh & 0x02) ? FLAG_5 : 0);
-    break;
+    UNCONTENDED (AddCycles (16));
+    NEXT;
 
-  case CPDR:
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (CPDR)
+  REPEAT_LABEL (CPDR)
+    BLOCK_BATCH_CP (-1);
+    r_meml = READ_MEM (r_HL);
     r_memh = r_A - r_meml;
     r_opl = ((r_A & 0x08) >> 3) |
       (((r_meml) & 0x08) >> 2) | ((r_memh & 0x08) >> 1);
-    contend_read_x5(r_HL);
+    CONTENDED (contend_read_x5(r_HL));
     r_BC--;
     r_F = (r_F & FLAG_C) |
       (r_BC ? (FLAG_V | FLAG_N) : FLAG_N) |
@@ -377,25 +459,29 @@ switch (opcode)
     if (r_F & FLAG_H)
       r_memh--;
     r_F |= (r_memh & FLAG_3) | ((r_memh & 0x02) ? FLAG_5 : 0);
+    UNCONTENDED (AddCycles (16));
     if ((r_F & (FLAG_V | FLAG_Z)) == FLAG_V)
       {
-      contend_read_x5(r_HL);
+      CONTENDED (contend_read_x5(r_HL));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_HL--;
-    break;
+    if ((r_F & (FLAG_V | FLAG_Z)) == FLAG_V)
+      REPEAT_BLOCK (CPDR);
+    NEXT;
 
-  case IND:
-    contend_read_byte();
-    ula_contend_port_early(r_BC);
-    ula_contend_port_late(r_BC);
+  OPCODE (IND)
+    CONTENDED (contend_read_byte());
+    CONTENDED (ula_contend_port_early(r_BC));
+    CONTENDED (ula_contend_port_late(r_BC));
     r_meml = Z80InPort (regs, r_BC);
     if( ( r_BC & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) )
       {
       Z80OutPort(regs,0x7ffd,r_meml);
       }
     r_B--;
-    Z80WriteMem (r_HL, r_meml, regs);
+    WRITE_MEM (r_HL, r_meml);
     r_oph = r_meml+r_C-1;
     r_opl = (r_oph & 7) ^ r_B;
     r_F = ( r_meml & 0x80 ? FLAG_N : 0 ) |
@@ -403,19 +489,21 @@ switch (opcode)
     	  ( parity_table[r_opl] ) |
     	  sz53_table[(r_B)];
     r_HL--;
-    break;
-
-  case INDR:
-    contend_read_byte();
-    ula_contend_port_early((r_BC));
-    ula_contend_port_late((r_BC));
+    UNCONTENDED (AddCycles (16));
+    NEXT;
+
+  OPCODE (INDR)
+  REPEAT_LABEL (INDR)
+    CONTENDED (contend_read_byte());
+    CONTENDED (ula_contend_port_early((r_BC)));
+    CONTENDED (ula_contend_port_late((r_BC)));
     r_meml = Z80InPort (regs, (r_BC));
     if( ( r_BC & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) )
       {
       Z80OutPort(regs,0x7ffd,r_meml);
       }
     r_B--;
-    Z80WriteMem (r_HL, r_meml, regs);
+    WRITE_MEM (r_HL, r_meml);
   
     r_oph = r_meml+r_C-1;
     r_opl = (r_oph & 7) ^ r_B;
@@ -423,25 +511,29 @@ switch (opcode)
     	  ( (r_oph < r_meml ) ? FLAG_H | FLAG_C : 0 ) |
     	  ( parity_table[r_opl] ) |
     	  sz53_table[(r_B)];   
+    UNCONTENDED (AddCycles (16));
     if (r_B)
       {
-      contend_read_x5(r_HL);
+      CONTENDED (contend_read_x5(r_HL));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_HL--;
-    break;
+    if (r_B)
+      REPEAT_BLOCK (INDR);
+    NEXT;
 
-  case INI:
-    contend_read_byte();
-    ula_contend_port_early((r_BC));
-    ula_contend_port_late((r_BC));
+  OPCODE (INI)
+    CONTENDED (contend_read_byte());
+    CONTENDED (ula_contend_port_early((r_BC)));
+    CONTENDED (ula_contend_port_late((r_BC)));
     r_meml = Z80InPort (regs, r_BC);
     if( ( r_BC & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) )
       {
       Z80OutPort(regs,0x7ffd,r_meml);
       }
     r_B--;
-    Z80WriteMem (r_HL, r_meml, regs);
+    WRITE_MEM (r_HL, r_meml);
     r_HL++;
     r_oph = r_meml+r_C+1;
     r_opl = (r_oph & 7) ^ r_B;
@@ -449,42 +541,49 @@ switch (opcode)
     	  ( (r_oph < r_meml ) ? FLAG_H | FLAG_C : 0 ) |
     	  ( parity_table[r_opl] ) |
     	  sz53_table[(r_B)];
-    break;
+    UNCONTENDED (AddCycles (16));
+    NEXT;
 
 
-  case INIR:
-    contend_read_byte();
-    ula_contend_port_early((r_BC));
-    ula_contend_port_late((r_BC));
+  OPCODE (INIR)
+  REPEAT_LABEL (INIR)
+    CONTENDED (contend_read_byte());
+    CONTENDED (ula_contend_port_early((r_BC)));
+    CONTENDED (ula_contend_port_late((r_BC)));
     r_meml = Z80InPort (regs, (r_BC));
     if( ( r_BC & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) )
       {
       Z80OutPort(regs,0x7ffd,r_meml);
       }
     r_B--;
-    Z80WriteMem (r_HL, r_meml, regs);
+    WRITE_MEM (r_HL, r_meml);
 
     r_oph = r_meml+r_C+1;
     r_opl = (r_oph & 7) ^ r_B;
     r_F = ( r_meml & 0x80 ? FLAG_N : 0 ) |
     	  ( (r_oph < r_meml ) ? FLAG_H | FLAG_C : 0 ) |
-    	  ( parity_table[r_opl] ? FLAG_P : 0 ) |
+    	  ( parity_table[r_opl] ) |
     	  sz53_table[(r_B)];
+    UNCONTENDED (AddCycles (16));
     if (r_B)
       {
-      contend_read_x5(r_HL);
+      CONTENDED (contend_read_x5(r_HL));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
     r_HL++;
-    break;
+    if (r_B)
+      REPEAT_BLOCK (INIR);
+    NEXT;
 
-  case OUTI:
-    contend_read_byte();
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (OUTI)
+    CONTENDED (contend_read_byte());
+    r_meml = READ_MEM (r_HL);
     r_B--;
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (13));
     Z80OutPort (regs, r_BC, r_meml);
-    ula_contend_port_late(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
 
     r_HL++;
     r_oph = r_meml+r_L;
@@ -494,15 +593,18 @@ switch (opcode)
     	  ( parity_table[r_opl] ? FLAG_P : 0 ) |
     	  sz53_table[(r_B)];
 
-    break;
+    UNCONTENDED (AddCycles (3));
+    NEXT;
 
-  case OTIR:
-    contend_read_byte();
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (OTIR)
+  REPEAT_LABEL (OTIR)
+    CONTENDED (contend_read_byte());
+    r_meml = READ_MEM (r_HL);
     r_B--;
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (13));
     Z80OutPort (regs, r_BC, r_meml);
-    ula_contend_port_late(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
 
     r_HL++;
     r_oph = r_meml+r_L;
@@ -512,21 +614,26 @@ switch (opcode)
     	  ( parity_table[r_opl] ? FLAG_P : 0 ) |
     	  sz53_table[(r_B)];
 
+    UNCONTENDED (AddCycles (3));
     if (r_B)
       {
-      contend_read_x5(r_BC);
+      CONTENDED (contend_read_x5(r_BC));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
-    break;
+    if (r_B)
+      REPEAT_BLOCK (OTIR);
+    NEXT;
 
 
-  case OUTD:
-    contend_read_byte();
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (OUTD)
+    CONTENDED (contend_read_byte());
+    r_meml = READ_MEM (r_HL);
     r_B--;
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (13));
     Z80OutPort (regs, r_BC, r_meml);
-    ula_contend_port_late(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
 
     r_HL--;
     r_oph = r_meml+r_L;
@@ -536,15 +643,18 @@ switch (opcode)
     	  ( parity_table[r_opl] ? FLAG_P : 0 ) |
     	  sz53_table[(r_B)];
 
-    break;
+    UNCONTENDED (AddCycles (3));
+    NEXT;
 
-  case OTDR:
-    contend_read_byte();
-    r_meml = Z80ReadMem (r_HL);
+  OPCODE (OTDR)
+  REPEAT_LABEL (OTDR)
+    CONTENDED (contend_read_byte());
+    r_meml = READ_MEM (r_HL);
     r_B--;
-    ula_contend_port_early(r_BC);
+    CONTENDED (ula_contend_port_early(r_BC));
+    UNCONTENDED (AddCycles (13));
     Z80OutPort (regs, r_BC, r_meml);
-    ula_contend_port_late(r_BC);
+    CONTENDED (ula_contend_port_late(r_BC));
 
     r_HL--;
     r_oph = r_meml+r_L;
@@ -554,22 +664,28 @@ switch (opcode)
     	  ( parity_table[r_opl] ? FLAG_P : 0 ) |
     	  sz53_table[(r_B)];
 
+    UNCONTENDED (AddCycles (3));
     if (r_B)
       {
-      contend_read_x5(r_BC);
+      CONTENDED (contend_read_x5(r_BC));
       r_PC -= 2;
+      UNCONTENDED (AddCycles (5));
       }
-    break;
+    if (r_B)
+      REPEAT_BLOCK (OTDR);
+    NEXT;
 
-  case PREFIX_ED:
-    AddCycles (4);              /* ED ED xx = 12 cycles min = 4+8 */
+  OPCODE (PREFIX_ED)
+    CONTENDED (AddCycles (4));    /* ED ED xx = 12 cycles min = 4+8 */
+    UNCONTENDED (AddCycles (12));
     r_PC--;
-    break;
+    NEXT;
 
-  default:
+  OPCODE_DEFAULT
 // exit(1);
+    UNCONTENDED (AddCycles (8));    /* acts as two NOPs */
     if (regs->DecodingErrors)
       printf ("z80 core: Unknown instruction: ED %02Xh at PC=%04Xh.\n",
-	      Z80ReadMem (r_PC - 1), r_PC - 2);
-    break;
+	      READ_MEM (r_PC - 1), r_PC - 2);
+    NEXT;
   }
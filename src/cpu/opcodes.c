@@ -39,203 +39,249 @@
                              3 more for each memory write/read. */
 
 
-case NOP:
-break;
+OPCODE (NOP)
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_BC_NN:
+OPCODE (LD_BC_NN)
 LD_rr_nn (r_BC);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case LD_xBC_A:
+OPCODE (LD_xBC_A)
 STORE_r (r_BC, r_A);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case INC_BC:
-contend_read_byte_x2();
+OPCODE (INC_BC)
+CONTENDED (contend_read_byte_x2());
 r_BC++;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_B:
+OPCODE (INC_B)
 INC (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_B:
+OPCODE (DEC_B)
 DEC (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_N:
+OPCODE (LD_B_N)
 LD_r_n (r_B);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case EX_AF_AF:
+OPCODE (EX_AF_AF)
 EX_WORD (r_AF, r_AFs);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_xBC:
+OPCODE (LD_A_xBC)
 LOAD_r (r_A, r_BC);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case DEC_BC:
-contend_read_byte_x2();
+OPCODE (DEC_BC)
+CONTENDED (contend_read_byte_x2());
 r_BC--;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_C:
+OPCODE (INC_C)
 INC (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_C:
+OPCODE (DEC_C)
 DEC (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_N:
+OPCODE (LD_C_N)
 LD_r_n (r_C);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_DE_NN:
+OPCODE (LD_DE_NN)
 LD_rr_nn (r_DE);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case LD_xDE_A:
+OPCODE (LD_xDE_A)
 STORE_r (r_DE, r_A);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case INC_DE:
-contend_read_byte_x2();
+OPCODE (INC_DE)
+CONTENDED (contend_read_byte_x2());
 r_DE++;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_D:
+OPCODE (INC_D)
 INC (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_D:
+OPCODE (DEC_D)
 DEC (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_N:
+OPCODE (LD_D_N)
 LD_r_n (r_D);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case ADD_HL_BC:
-contend_read_byte_x7();
+OPCODE (ADD_HL_BC)
+CONTENDED (contend_read_byte_x7());
 ADD_WORD (r_HL, r_BC);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case ADD_HL_DE:
-contend_read_byte_x7();
+OPCODE (ADD_HL_DE)
+CONTENDED (contend_read_byte_x7());
 ADD_WORD (r_HL, r_DE);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case ADD_HL_HL:
-contend_read_byte_x7();
+OPCODE (ADD_HL_HL)
+CONTENDED (contend_read_byte_x7());
 ADD_WORD (r_HL, r_HL);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case ADD_HL_SP:
-contend_read_byte_x7();
+OPCODE (ADD_HL_SP)
+CONTENDED (contend_read_byte_x7());
 ADD_WORD (r_HL, r_SP);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case LD_A_xDE:
+OPCODE (LD_A_xDE)
 LOAD_r (r_A, r_DE);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case DEC_DE:
-contend_read_byte_x2();
+OPCODE (DEC_DE)
+CONTENDED (contend_read_byte_x2());
 r_DE--;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_E:
+OPCODE (INC_E)
 INC (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_E:
+OPCODE (DEC_E)
 DEC (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_N:
+OPCODE (LD_E_N)
 LD_r_n (r_E);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_HL_NN:
+OPCODE (LD_HL_NN)
 LD_rr_nn (r_HL);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case LD_xNN_HL:
+OPCODE (LD_xNN_HL)
 STORE_nn_rr (r_HL);
-break;
+UNCONTENDED (AddCycles (16));
+NEXT;
 
-case INC_HL:
-contend_read_byte_x2();
+OPCODE (INC_HL)
+CONTENDED (contend_read_byte_x2());
 r_HL++;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_H:
+OPCODE (INC_H)
 INC (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_H:
+OPCODE (DEC_H)
 DEC (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_N:
+OPCODE (LD_H_N)
 LD_r_n (r_H);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_HL_xNN:
+OPCODE (LD_HL_xNN)
 LOAD_rr_nn (r_HL);
-break;
+UNCONTENDED (AddCycles (16));
+NEXT;
 
-case DEC_HL:
-contend_read_byte_x2();
+OPCODE (DEC_HL)
+CONTENDED (contend_read_byte_x2());
 r_HL--;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_L:
+OPCODE (INC_L)
 INC (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_L:
+OPCODE (DEC_L)
 DEC (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_N:
+OPCODE (LD_L_N)
 LD_r_n (r_L);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_SP_NN:
+OPCODE (LD_SP_NN)
 LD_rr_nn (r_SP);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case LD_xNN_A:
+OPCODE (LD_xNN_A)
 STORE_nn_r (r_A);
-break;
+UNCONTENDED (AddCycles (13));
+NEXT;
 
-case INC_SP:
-contend_read_byte_x2();
+OPCODE (INC_SP)
+CONTENDED (contend_read_byte_x2());
 r_SP++;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case LD_xHL_N:
-r_meml = Z80ReadMem (r_PC);r_PC++;
+OPCODE (LD_xHL_N)
+r_meml = READ_MEM (r_PC);r_PC++;
 STORE_r (r_HL, r_meml);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case LD_A_xNN:
+OPCODE (LD_A_xNN)
 LOAD_r_nn (r_A);
-break;
+UNCONTENDED (AddCycles (13));
+NEXT;
 
-case DEC_SP:
-contend_read_byte_x2();
+OPCODE (DEC_SP)
+CONTENDED (contend_read_byte_x2());
 r_SP--;
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case INC_A:
+OPCODE (INC_A)
 INC (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DEC_A:
+OPCODE (DEC_A)
 ///////// EDGE LOADING TRAP
 if(fast_edge_loading==2)
 {
@@ -250,866 +296,1092 @@ if(fast_edge_loading==2)
 }
 //////////////////////////
 DEC (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_N:
+OPCODE (LD_A_N)
 LD_r_n (r_A);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_B_B:
+OPCODE (LD_B_B)
 LD_r_r (r_B, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_C:
+OPCODE (LD_B_C)
 LD_r_r (r_B, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_D:
+OPCODE (LD_B_D)
 LD_r_r (r_B, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_E:
+OPCODE (LD_B_E)
 LD_r_r (r_B, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_H:
+OPCODE (LD_B_H)
 LD_r_r (r_B, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_L:
+OPCODE (LD_B_L)
 LD_r_r (r_B, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_B_xHL:
+OPCODE (LD_B_xHL)
 LOAD_r (r_B, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_B_A:
+OPCODE (LD_B_A)
 LD_r_r (r_B, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_B:
+OPCODE (LD_C_B)
 LD_r_r (r_C, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_C:
+OPCODE (LD_C_C)
 LD_r_r (r_C, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_D:
+OPCODE (LD_C_D)
 LD_r_r (r_C, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_E:
+OPCODE (LD_C_E)
 LD_r_r (r_C, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_H:
+OPCODE (LD_C_H)
 LD_r_r (r_C, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_L:
+OPCODE (LD_C_L)
 LD_r_r (r_C, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_C_xHL:
+OPCODE (LD_C_xHL)
 LOAD_r (r_C, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_C_A:
+OPCODE (LD_C_A)
 LD_r_r (r_C, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_B:
+OPCODE (LD_D_B)
 LD_r_r (r_D, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_C:
+OPCODE (LD_D_C)
 LD_r_r (r_D, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_D:
+OPCODE (LD_D_D)
 LD_r_r (r_D, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_E:
+OPCODE (LD_D_E)
 LD_r_r (r_D, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_H:
+OPCODE (LD_D_H)
 LD_r_r (r_D, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_L:
+OPCODE (LD_D_L)
 LD_r_r (r_D, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_D_xHL:
+OPCODE (LD_D_xHL)
 LOAD_r (r_D, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_D_A:
+OPCODE (LD_D_A)
 LD_r_r (r_D, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_B:
+OPCODE (LD_E_B)
 LD_r_r (r_E, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_C:
+OPCODE (LD_E_C)
 LD_r_r (r_E, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_D:
+OPCODE (LD_E_D)
 LD_r_r (r_E, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_E:
+OPCODE (LD_E_E)
 LD_r_r (r_E, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_H:
+OPCODE (LD_E_H)
 LD_r_r (r_E, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_L:
+OPCODE (LD_E_L)
 LD_r_r (r_E, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_E_xHL:
+OPCODE (LD_E_xHL)
 LOAD_r (r_E, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_E_A:
+OPCODE (LD_E_A)
 LD_r_r (r_E, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_B:
+OPCODE (LD_H_B)
 LD_r_r (r_H, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_C:
+OPCODE (LD_H_C)
 LD_r_r (r_H, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_D:
+OPCODE (LD_H_D)
 LD_r_r (r_H, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_E:
+OPCODE (LD_H_E)
 LD_r_r (r_H, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_H:
+OPCODE (LD_H_H)
 LD_r_r (r_H, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_L:
+OPCODE (LD_H_L)
 LD_r_r (r_H, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_H_xHL:
+OPCODE (LD_H_xHL)
 LOAD_r (r_H, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_H_A:
+OPCODE (LD_H_A)
 LD_r_r (r_H, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_B:
+OPCODE (LD_L_B)
 LD_r_r (r_L, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_C:
+OPCODE (LD_L_C)
 LD_r_r (r_L, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_D:
+OPCODE (LD_L_D)
 LD_r_r (r_L, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_E:
+OPCODE (LD_L_E)
 LD_r_r (r_L, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_H:
+OPCODE (LD_L_H)
 LD_r_r (r_L, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_L:
+OPCODE (LD_L_L)
 LD_r_r (r_L, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_L_xHL:
+OPCODE (LD_L_xHL)
 LOAD_r (r_L, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_L_A:
+OPCODE (LD_L_A)
 LD_r_r (r_L, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_xHL_B:
+OPCODE (LD_xHL_B)
 STORE_r (r_HL, r_B);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_C:
+OPCODE (LD_xHL_C)
 STORE_r (r_HL, r_C);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_D:
+OPCODE (LD_xHL_D)
 STORE_r (r_HL, r_D);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_E:
+OPCODE (LD_xHL_E)
 STORE_r (r_HL, r_E);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_H:
+OPCODE (LD_xHL_H)
 STORE_r (r_HL, r_H);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_L:
+OPCODE (LD_xHL_L)
 STORE_r (r_HL, r_L);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_xHL_A:
+OPCODE (LD_xHL_A)
 STORE_r (r_HL, r_A);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_A_B:
+OPCODE (LD_A_B)
 LD_r_r (r_A, r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_C:
+OPCODE (LD_A_C)
 LD_r_r (r_A, r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_D:
+OPCODE (LD_A_D)
 LD_r_r (r_A, r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_E:
+OPCODE (LD_A_E)
 LD_r_r (r_A, r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_H:
+OPCODE (LD_A_H)
 LD_r_r (r_A, r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_L:
+OPCODE (LD_A_L)
 LD_r_r (r_A, r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_A_xHL:
+OPCODE (LD_A_xHL)
 LOAD_r (r_A, r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case LD_A_A:
+OPCODE (LD_A_A)
 LD_r_r (r_A, r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case LD_SP_HL:
-contend_read_byte_x2();
+OPCODE (LD_SP_HL)
+CONTENDED (contend_read_byte_x2());
 LD_r_r (r_SP, r_HL);
-break;
+UNCONTENDED (AddCycles (6));
+NEXT;
 
-case ADD_B:
+OPCODE (ADD_B)
 ADD (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_C:
+OPCODE (ADD_C)
 ADD (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_D:
+OPCODE (ADD_D)
 ADD (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_E:
+OPCODE (ADD_E)
 ADD (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_H:
+OPCODE (ADD_H)
 ADD (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_L:
+OPCODE (ADD_L)
 ADD (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADD_xHL:
-r_meml = Z80ReadMem (r_HL);
+OPCODE (ADD_xHL)
+r_meml = READ_MEM (r_HL);
 ADD (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case ADD_A:
+OPCODE (ADD_A)
 ADD (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_B:
+OPCODE (ADC_B)
 ADC (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_C:
+OPCODE (ADC_C)
 ADC (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_D:
+OPCODE (ADC_D)
 ADC (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_E:
+OPCODE (ADC_E)
 ADC (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_H:
+OPCODE (ADC_H)
 ADC (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_L:
+OPCODE (ADC_L)
 ADC (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_xHL:
-r_meml = Z80ReadMem (r_HL);
+OPCODE (ADC_xHL)
+r_meml = READ_MEM (r_HL);
 ADC (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case ADC_A:
+OPCODE (ADC_A)
 ADC (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case ADC_N:
-r_meml = Z80ReadMem (r_PC);
+OPCODE (ADC_N)
+r_meml = READ_MEM (r_PC);
 r_PC++;
 ADC (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case SUB_A:
+OPCODE (SUB_A)
 SUB (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_B:
+OPCODE (SUB_B)
 SUB (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_C:
+OPCODE (SUB_C)
 SUB (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_D:
+OPCODE (SUB_D)
 SUB (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_E:
+OPCODE (SUB_E)
 SUB (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_H:
+OPCODE (SUB_H)
 SUB (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_L:
+OPCODE (SUB_L)
 SUB (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SUB_xHL:
-r_meml = Z80ReadMem (r_HL);
+OPCODE (SUB_xHL)
+r_meml = READ_MEM (r_HL);
 SUB (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case SUB_N:
-r_meml = Z80ReadMem (r_PC);
+OPCODE (SUB_N)
+r_meml = READ_MEM (r_PC);
 r_PC++;
 SUB (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case SBC_A:
+OPCODE (SBC_A)
 SBC (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_B:
+OPCODE (SBC_B)
 SBC (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_C:
+OPCODE (SBC_C)
 SBC (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_D:
+OPCODE (SBC_D)
 SBC (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_E:
+OPCODE (SBC_E)
 SBC (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_H:
+OPCODE (SBC_H)
 SBC (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_L:
+OPCODE (SBC_L)
 SBC (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case SBC_xHL:
-r_meml = Z80ReadMem (r_HL);
+OPCODE (SBC_xHL)
+r_meml = READ_MEM (r_HL);
 SBC (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case SBC_N:
-r_meml = Z80ReadMem (r_PC);
+OPCODE (SBC_N)
+r_meml = READ_MEM (r_PC);
 r_PC++;
 SBC (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case AND_B:
+OPCODE (AND_B)
 AND (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_C:
+OPCODE (AND_C)
 AND (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_D:
+OPCODE (AND_D)
 AND (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_E:
+OPCODE (AND_E)
 AND (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_H:
+OPCODE (AND_H)
 AND (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_L:
+OPCODE (AND_L)
 AND (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_xHL:
+OPCODE (AND_xHL)
 AND_mem (r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case AND_A:
+OPCODE (AND_A)
 AND (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_B:
+OPCODE (XOR_B)
 XOR (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_C:
+OPCODE (XOR_C)
 XOR (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_D:
+OPCODE (XOR_D)
 XOR (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_E:
+OPCODE (XOR_E)
 XOR (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_H:
+OPCODE (XOR_H)
 XOR (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_L:
+OPCODE (XOR_L)
 XOR (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case XOR_xHL:
+OPCODE (XOR_xHL)
 XOR_mem (r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case XOR_A:
+OPCODE (XOR_A)
 XOR (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_B:
+OPCODE (OR_B)
 OR (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_C:
+OPCODE (OR_C)
 OR (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_D:
+OPCODE (OR_D)
 OR (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_E:
+OPCODE (OR_E)
 OR (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_H:
+OPCODE (OR_H)
 OR (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_L:
+OPCODE (OR_L)
 OR (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OR_xHL:
+OPCODE (OR_xHL)
 OR_mem (r_HL);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case OR_A:
+OPCODE (OR_A)
 OR (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_A:
+OPCODE (CP_A)
 CP (r_A);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_B:
+OPCODE (CP_B)
 CP (r_B);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_C:
+OPCODE (CP_C)
 CP (r_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_D:
+OPCODE (CP_D)
 CP (r_D);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_E:
+OPCODE (CP_E)
 CP (r_E);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_H:
+OPCODE (CP_H)
 CP (r_H);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_L:
+OPCODE (CP_L)
 CP (r_L);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CP_xHL:
-r_meml = Z80ReadMem (r_HL);
+OPCODE (CP_xHL)
+r_meml = READ_MEM (r_HL);
 CP (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case CP_N:
-r_meml = Z80ReadMem (r_PC);
+OPCODE (CP_N)
+r_meml = READ_MEM (r_PC);
 r_PC++;
 CP (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case RET_Z:
-contend_read_byte();
+OPCODE (RET_Z)
+CONTENDED (contend_read_byte());
 if (TEST_FLAG (Z_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
   }
-break;
+else
+  {
+  UNCONTENDED (AddCycles (5));
+  }
+NEXT;
 
-case RET_C:
-contend_read_byte();
+OPCODE (RET_C)
+CONTENDED (contend_read_byte());
 if (TEST_FLAG (C_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
   }
-break;
+else
+  {
+  UNCONTENDED (AddCycles (5));
+  }
+NEXT;
 
-case RET_M:
-contend_read_byte();
+OPCODE (RET_M)
+CONTENDED (contend_read_byte());
 if (TEST_FLAG (S_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
+  }
+else
+  {
+  UNCONTENDED (AddCycles (5));
   }
-break;
+NEXT;
 
-case RET_PE:
-contend_read_byte();
+OPCODE (RET_PE)
+CONTENDED (contend_read_byte());
 if (TEST_FLAG (P_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
   }
-break;
+else
+  {
+  UNCONTENDED (AddCycles (5));
+  }
+NEXT;
 
-case RET_PO:
-contend_read_byte();
+OPCODE (RET_PO)
+CONTENDED (contend_read_byte());
 if (!TEST_FLAG (P_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
   }
-break;
+else
+  {
+  UNCONTENDED (AddCycles (5));
+  }
+NEXT;
 
-case RET_P:
-contend_read_byte();
+OPCODE (RET_P)
+CONTENDED (contend_read_byte());
 if (!TEST_FLAG (S_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
+  }
+else
+  {
+  UNCONTENDED (AddCycles (5));
   }
-break;
+NEXT;
 
-case RET:
+OPCODE (RET)
 RET_nn ();
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case RET_NZ:
-contend_read_byte();
+OPCODE (RET_NZ)
+CONTENDED (contend_read_byte());
 if (!TEST_FLAG (Z_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
+  }
+else
+  {
+  UNCONTENDED (AddCycles (5));
   }
-break;
+NEXT;
 
-case RET_NC:
-contend_read_byte();
+OPCODE (RET_NC)
+CONTENDED (contend_read_byte());
 if (!TEST_FLAG (C_FLAG))
   {
   RET_nn ();
+  UNCONTENDED (AddCycles (11));
   }
-break;
+else
+  {
+  UNCONTENDED (AddCycles (5));
+  }
+NEXT;
 
-case ADD_N:
-r_meml = Z80ReadMem (r_PC);
+OPCODE (ADD_N)
+r_meml = READ_MEM (r_PC);
 r_PC++;
 ADD (r_meml);
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case JR:
+OPCODE (JR)
+IDLE_LOOP_SKIP ();
 JR_n ();
-break;
+UNCONTENDED (AddCycles (12));
+NEXT;
 
-case JR_NZ:
+OPCODE (JR_NZ)
 if (TEST_FLAG (Z_FLAG))
   {
-  contend_read_jr();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (7));
   }
 else
   {
+  IDLE_LOOP_SKIP ();
   JR_n ();
+  UNCONTENDED (AddCycles (12));
   }
 
-break;
+NEXT;
 
-case JR_Z:
+OPCODE (JR_Z)
 if (TEST_FLAG (Z_FLAG))
   {
+  IDLE_LOOP_SKIP ();
   JR_n ();
+  UNCONTENDED (AddCycles (12));
   }
 else
   {
-  contend_read_jr();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (7));
   }
 
-break;
+NEXT;
 
-case JR_NC:
+OPCODE (JR_NC)
 if (TEST_FLAG (C_FLAG))
   {
-  contend_read_jr();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (7));
   }
 else
   {
+  IDLE_LOOP_SKIP ();
   JR_n ();
+  UNCONTENDED (AddCycles (12));
   }
 
-break;
+NEXT;
 
-case JR_C:
+OPCODE (JR_C)
 if (TEST_FLAG (C_FLAG))
   {
+  IDLE_LOOP_SKIP ();
   JR_n ();
+  UNCONTENDED (AddCycles (12));
   }
 else
   {
-  contend_read_jr();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (7));
   }
 
-break;
+NEXT;
 
-case JP_NZ:
+OPCODE (JP_NZ)
 if (TEST_FLAG (Z_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
 else
   {
+  IDLE_LOOP_SKIP ();
   JP_nn ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP:
+OPCODE (JP)
+IDLE_LOOP_SKIP ();
 JP_nn ();
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_Z:
+OPCODE (JP_Z)
 if (TEST_FLAG (Z_FLAG))
   {
+  IDLE_LOOP_SKIP ();
   JP_nn ();
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_NC:
+OPCODE (JP_NC)
 if (TEST_FLAG (C_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
 else
   {
+  IDLE_LOOP_SKIP ();
   JP_nn ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_C:
+OPCODE (JP_C)
 if (TEST_FLAG (C_FLAG))
   {
+  IDLE_LOOP_SKIP ();
   JP_nn ();
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_PO:
+OPCODE (JP_PO)
 if (TEST_FLAG (P_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
 else
   {
   JP_nn ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_PE:
+OPCODE (JP_PE)
 if (TEST_FLAG (P_FLAG))
   {
   JP_nn ();
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_P:
+OPCODE (JP_P)
 if (TEST_FLAG (S_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
 else
   {
   JP_nn ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
 
-case JP_M:
+OPCODE (JP_M)
 if (TEST_FLAG (S_FLAG))
   {
   JP_nn ();
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
   }
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case JP_xHL:
+OPCODE (JP_xHL)
 r_PC = r_HL;
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CPL:
+OPCODE (CPL)
 r_A ^= 0xFF;
 r_F = (r_F & (FLAG_C | FLAG_P | FLAG_Z | FLAG_S)) |
   (r_A & (FLAG_3 | FLAG_5)) | (FLAG_N | FLAG_H);
-break;
-
-case INC_xHL:
-r_meml = Z80ReadMem (r_HL);
-INC (r_meml);contend_read(r_HL);
-Z80WriteMem (r_HL, r_meml, regs);
-break;
-
-case DEC_xHL:
-r_meml = Z80ReadMem (r_HL);
-DEC (r_meml);contend_read(r_HL);
-Z80WriteMem (r_HL, r_meml, regs);
-break;
-
-case SCF:
+UNCONTENDED (AddCycles (4));
+NEXT;
+
+OPCODE (INC_xHL)
+r_meml = READ_MEM (r_HL);
+INC (r_meml);
+CONTENDED (contend_read(r_HL));
+WRITE_MEM (r_HL, r_meml);
+UNCONTENDED (AddCycles (11));
+NEXT;
+
+OPCODE (DEC_xHL)
+r_meml = READ_MEM (r_HL);
+DEC (r_meml);
+CONTENDED (contend_read(r_HL));
+WRITE_MEM (r_HL, r_meml);
+UNCONTENDED (AddCycles (11));
+NEXT;
+
+OPCODE (SCF)
 r_F &= FLAG_Z | FLAG_S | FLAG_P;
 r_F |= (r_A & (FLAG_3 | FLAG_5));
 r_F |= FLAG_C;
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CCF:
+OPCODE (CCF)
 r_F = (r_F & (FLAG_P | FLAG_Z | FLAG_S)) |
   ((r_F & FLAG_C) ? FLAG_H : FLAG_C) | (r_A & (FLAG_3 | FLAG_5));
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case HALT:
+OPCODE (HALT)
 regs->halted = 1;
-break;
+UNCONTENDED (AddCycles (4));
+HALT_FAST_FORWARD ();
+NEXT;
 
-case POP_BC:
+OPCODE (POP_BC)
 POP (BC);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case PUSH_BC:
-contend_read_byte();
+OPCODE (PUSH_BC)
+CONTENDED (contend_read_byte());
 PUSH (BC);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case POP_HL:
+OPCODE (POP_HL)
 POP (HL);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case PUSH_HL:
-contend_read_byte();
+OPCODE (PUSH_HL)
+CONTENDED (contend_read_byte());
 PUSH (HL);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case POP_AF:
+OPCODE (POP_AF)
+FLAGS_SYNC ();
 POP (AF);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case PUSH_AF:
-contend_read_byte();
+OPCODE (PUSH_AF)
+CONTENDED (contend_read_byte());
+FLAGS_SYNC ();
 PUSH (AF);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case POP_DE:
+OPCODE (POP_DE)
 POP (DE);
-break;
+UNCONTENDED (AddCycles (10));
+NEXT;
 
-case PUSH_DE:
-contend_read_byte();
+OPCODE (PUSH_DE)
+CONTENDED (contend_read_byte());
 PUSH (DE);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RLCA:
+OPCODE (RLCA)
 r_A = (r_A << 1) | (r_A >> 7);
 r_F = (r_F & (FLAG_P | FLAG_Z | FLAG_S)) | (r_A & (FLAG_C | FLAG_3 | FLAG_5));
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case RRCA:
+OPCODE (RRCA)
 r_F = (r_F & (FLAG_P | FLAG_Z | FLAG_S)) | (r_A & FLAG_C);
 r_A = (r_A >> 1) | (r_A << 7);
 r_F |= (r_A & (FLAG_3 | FLAG_5));
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DJNZ:
+OPCODE (DJNZ)
 ///////// EDGE LOADING TRAP
 if(fast_edge_loading==2)
 {
@@ -1117,38 +1389,42 @@ if(fast_edge_loading==2)
 	  {
 		   r_B=0x00;
 		   r_PC++;
-		   break;	   		        	
+		   NEXT;	   		        	
 	  }	
 }	
 /////////////////////////
-contend_read_byte();
+CONTENDED (contend_read_byte());
 r_B--;
 if (r_B)
   {
   JR_n ();
+  UNCONTENDED (AddCycles (13));
   }
 else
   {
-  contend_read_jr();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (8));
   }
 
-break;
+NEXT;
 
-case RLA:
+OPCODE (RLA)
 r_meml = r_A;
 r_A = (r_A << 1) | (r_F & FLAG_C);
 r_F = (r_F & (FLAG_P | FLAG_Z | FLAG_S)) |
   (r_A & (FLAG_3 | FLAG_5)) | (r_meml >> 7);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case RRA:
+OPCODE (RRA)
 r_meml = r_A;
 r_A = (r_A >> 1) | (r_F << 7);
 r_F = (r_F & (FLAG_P | FLAG_Z | FLAG_S)) |
   (r_A & (FLAG_3 | FLAG_5)) | (r_meml & FLAG_C);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case DAA:
+OPCODE (DAA)
 r_meml = 0;
 r_memh = (r_F & FLAG_C);
 if ((r_F & FLAG_H) || ((r_A & 0x0f) > 9))
@@ -1171,176 +1447,205 @@ else
   }
 
 r_F = (r_F & ~(FLAG_C | FLAG_P | FLAG_H)) | r_memh | parity_table[r_A];
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case OUT_N_A:
-r_meml=Z80ReadMem (r_PC);
+OPCODE (OUT_N_A)
+r_meml=READ_MEM (r_PC);
 r_memh=r_A;
-ula_contend_port_early(r_mem);
+CONTENDED (ula_contend_port_early(r_mem));
+UNCONTENDED (AddCycles (8));
 Z80OutPort (regs, r_mem, r_A);
-ula_contend_port_late(r_mem);
+CONTENDED (ula_contend_port_late(r_mem));
 r_PC++;
-break;
+UNCONTENDED (AddCycles (3));
+NEXT;
 
-case IN_A_N:
-r_meml=Z80ReadMem (r_PC);
+OPCODE (IN_A_N)
+r_meml=READ_MEM (r_PC);
 r_memh=r_A;
-ula_contend_port_early(r_mem);
-ula_contend_port_late(r_mem);
+CONTENDED (ula_contend_port_early(r_mem));
+CONTENDED (ula_contend_port_late(r_mem));
 r_A = Z80InPort (regs, r_mem);
 if( ( r_mem & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) )
   {
   Z80OutPort(regs,0x7ffd,r_A);
   }
 r_PC++;
-break;
-
-case EX_HL_xSP:
-r_meml = Z80ReadMem (r_SP);
-r_memh = Z80ReadMem (r_SP + 1);contend_read(r_SP+1);
-Z80WriteMem (r_SP + 1, r_H, regs);
-Z80WriteMem (r_SP, r_L, regs);
-contend_read_x2(r_SP);
+UNCONTENDED (AddCycles (11));
+NEXT;
+
+OPCODE (EX_HL_xSP)
+r_meml = READ_MEM (r_SP);
+r_memh = READ_MEM (r_SP + 1);
+CONTENDED (contend_read(r_SP+1));
+WRITE_MEM (r_SP + 1, r_H);
+WRITE_MEM (r_SP, r_L);
+CONTENDED (contend_read_x2(r_SP));
 r_L = r_meml;
 r_H = r_memh;
-break;
+UNCONTENDED (AddCycles (19));
+NEXT;
 
-case EXX:
+OPCODE (EXX)
 EX_WORD (r_BC, r_BCs);
 EX_WORD (r_DE, r_DEs);
 EX_WORD (r_HL, r_HLs);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case EX_DE_HL:
+OPCODE (EX_DE_HL)
 EX_WORD (r_DE, r_HL);
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case AND_N:
+OPCODE (AND_N)
 AND_mem (r_PC);
 r_PC++;
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case XOR_N:
+OPCODE (XOR_N)
 XOR_mem (r_PC);
 r_PC++;
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case OR_N:
+OPCODE (OR_N)
 OR_mem (r_PC);
 r_PC++;
-break;
+UNCONTENDED (AddCycles (7));
+NEXT;
 
-case DI:
+OPCODE (DI)
 r_IFF1 = r_IFF2 = 0;
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case CALL:
+OPCODE (CALL)
 CALL_nn ();
-break;
+UNCONTENDED (AddCycles (17));
+NEXT;
 
-case CALL_NZ:
+OPCODE (CALL_NZ)
 if (TEST_FLAG (Z_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 else
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
-break;
+NEXT;
 
-case CALL_NC:
+OPCODE (CALL_NC)
 if (TEST_FLAG (C_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 else
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 
-break;
+NEXT;
 
-case CALL_PO:
+OPCODE (CALL_PO)
 if (TEST_FLAG (P_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 else
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 
-break;
+NEXT;
 
-case CALL_P:
+OPCODE (CALL_P)
 if (TEST_FLAG (S_FLAG))
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 else
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 
-break;
+NEXT;
 
 
-case CALL_Z:
+OPCODE (CALL_Z)
 if (TEST_FLAG (Z_FLAG))
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 
-break;
+NEXT;
 
-case CALL_C:
+OPCODE (CALL_C)
 if (TEST_FLAG (C_FLAG))
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
-break;
+NEXT;
 
-case CALL_PE:
+OPCODE (CALL_PE)
 if (TEST_FLAG (P_FLAG))
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
 
-break;
+NEXT;
 
-case CALL_M:
+OPCODE (CALL_M)
 if (TEST_FLAG (S_FLAG))
   {
   CALL_nn ();
+  UNCONTENDED (AddCycles (17));
   }
 else
   {
-  contend_read_jr();
-  contend_read_jr();
+  SKIP_BYTE ();
+  SKIP_BYTE ();
+  UNCONTENDED (AddCycles (10));
   }
-break;
+NEXT;
 
-case EI:
+OPCODE (EI)
 r_IFF1 = r_IFF2 = 1;
 		    /*
 		       Why Marat Fayzullin does this? ->
@@ -1352,51 +1657,60 @@ r_IFF1 = r_IFF2 = 1;
 		       regs->ICount = 0x1;
 		       r_IFF |= 0x20;
 		       } */
-break;
+UNCONTENDED (AddCycles (4));
+NEXT;
 
-case RST_00:
-contend_read_byte();
+OPCODE (RST_00)
+CONTENDED (contend_read_byte());
 RST (0x00);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_08:
-contend_read_byte();
+OPCODE (RST_08)
+CONTENDED (contend_read_byte());
 RST (0x08);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_10:
-contend_read_byte();
+OPCODE (RST_10)
+CONTENDED (contend_read_byte());
 RST (0x10);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_18:
-contend_read_byte();
+OPCODE (RST_18)
+CONTENDED (contend_read_byte());
 RST (0x18);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_20:
-contend_read_byte();
+OPCODE (RST_20)
+CONTENDED (contend_read_byte());
 RST (0x20);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_28:
-contend_read_byte();
+OPCODE (RST_28)
+CONTENDED (contend_read_byte());
 RST (0x28);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_30:
-contend_read_byte();
+OPCODE (RST_30)
+CONTENDED (contend_read_byte());
 RST (0x30);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-case RST_38:
-contend_read_byte();
+OPCODE (RST_38)
+CONTENDED (contend_read_byte());
 RST (0x38);
-break;
+UNCONTENDED (AddCycles (11));
+NEXT;
 
-default:
+OPCODE_DEFAULT
 //    exit(1);
 if (regs->DecodingErrors)
   printf ("z80 core: Unknown instruction: %02Xh at PC=%04Xh.\n",
-	  Z80ReadMem (r_PC - 1), r_PC - 1);
-break;
+	  READ_MEM (r_PC - 1), r_PC - 1);
+NEXT;
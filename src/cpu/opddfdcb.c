@@ -47,11 +47,13 @@
 
 /* 15 clock cycles minimum = FD/DD CB xx opcode = 4 + 4 + 3 + 4 */
 
-tmpreg.W = REGISTER.W + (offset) Z80ReadMem (r_PC);
+tmpreg.W = REGISTER.W + (offset) READ_MEM (r_PC);
 r_PC++;
-opcode = Z80ReadMem (r_PC);contend_read_x2(r_PC);
+opcode = READ_MEM (r_PC);
+CONTENDED (contend_read_x2(r_PC));
 r_PC++;
-r_meml = Z80ReadMem (tmpreg.W);contend_read(tmpreg.W);
+r_meml = READ_MEM (tmpreg.W);
+CONTENDED (contend_read(tmpreg.W));
 r_memh = tmpreg.W>>8;
 
 
@@ -59,114 +61,146 @@ switch (opcode & 0xf8)
   {
   case RLC_xIXY & 0xf8:
     RLC (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RRC_xIXY & 0xf8:
     RRC (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RL_xIXY & 0xf8:
     RL (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RR_xIXY & 0xf8:
     RR (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SLA_xIXY & 0xf8:
     SLA (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SRA_xIXY & 0xf8:
     SRA (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SLL_xIXY & 0xf8:
     SLL (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SRL_xIXY & 0xf8:
     SRL (r_meml);
-    Z80WriteMem (tmpreg.W, r_meml, regs);
+    WRITE_MEM (tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case BIT_0_xIXY & 0xf8:
     BIT_BIT_XY (0, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_1_xIXY & 0xf8:
     BIT_BIT_XY (1, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_2_xIXY & 0xf8:
     BIT_BIT_XY (2, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_3_xIXY & 0xf8:
     BIT_BIT_XY (3, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_4_xIXY & 0xf8:
     BIT_BIT_XY (4, r_meml,r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_5_xIXY & 0xf8:
     BIT_BIT_XY (5, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case BIT_6_xIXY & 0xf8:
     BIT_BIT_XY (6, r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
   case BIT_7_xIXY & 0xf8:
     BIT_BIT7_XY (r_meml, r_memh);
+    UNCONTENDED (AddCycles (20));
     break;
 
   case RES_0_xIXY & 0xf8:
     BIT_RES_mem (0, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_1_xIXY & 0xf8:
     BIT_RES_mem (1, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_2_xIXY & 0xf8:
     BIT_RES_mem (2, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_3_xIXY & 0xf8:
     BIT_RES_mem (3, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_4_xIXY & 0xf8:
     BIT_RES_mem (4, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_5_xIXY & 0xf8:
     BIT_RES_mem (5, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_6_xIXY & 0xf8:
     BIT_RES_mem (6, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case RES_7_xIXY & 0xf8:
     BIT_RES_mem (7, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_0_xIXY & 0xf8:
     BIT_SET_mem (0, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_1_xIXY & 0xf8:
     BIT_SET_mem (1, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_2_xIXY & 0xf8:
     BIT_SET_mem (2, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_3_xIXY & 0xf8:
     BIT_SET_mem (3, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_4_xIXY & 0xf8:
     BIT_SET_mem (4, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_5_xIXY & 0xf8:
     BIT_SET_mem (5, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_6_xIXY & 0xf8:
     BIT_SET_mem (6, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   case SET_7_xIXY & 0xf8:
     BIT_SET_mem (7, tmpreg.W, r_meml);
+    UNCONTENDED (AddCycles (23));
     break;
   default:
     break;
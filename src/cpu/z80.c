@@ -35,9 +35,60 @@
 #include "z80_macros.h"
 #include "zx.c"
 
-#define Z80WriteMem(a,b,c) Z80WriteMem(a,b)
-#define Z80InPort(a,b)     Z80InPort(b)
+/* where the cores keep the registers, see z80_macros.h */
+#ifdef Z80_LOCAL_REGS
+#define Z80_REGFILE LOCAL
+#define Z80_LOCALS \
+  eword l_PC, l_SP, l_AF, l_BC, l_DE, l_HL; \
+  int l_ICount; \
+  byte l_port;
+#define Z80_SPILL() \
+  (regs->PC = l_PC, regs->SP = l_SP, regs->AF = Z80_PAIR (AF), \
+   regs->BC = l_BC, regs->DE = l_DE, regs->HL = l_HL, \
+   regs->ICount = l_ICount)
+#define Z80_RELOAD() \
+  (l_PC = regs->PC, l_SP = regs->SP, Z80_PAIR (AF) = regs->AF, \
+   l_BC = regs->BC, l_DE = regs->DE, l_HL = regs->HL, \
+   l_ICount = regs->ICount)
+
+/* the port handlers time the border, the beeper and the floating bus
+   with ICount, and Z80InPort runs loader_hook, which looks at PC and B,
+   so all the registers go back to the structure around IN and OUT */
+#define Z80InPort(a,b) \
+  (Z80_SPILL (), l_port = Z80InPort (b), Z80_RELOAD (), \
+   Z80_TAPE_BREAK (), l_port)
+#define Z80OutPort(a,b,c) \
+  (Z80_SPILL (), Z80OutPort (b,c), Z80_RELOAD ())
+#else
+#define Z80_REGFILE MEM
+#define Z80_LOCALS \
+  byte l_port;
+#define Z80_SPILL()
+#define Z80_RELOAD()
+#define Z80InPort(a,b) \
+  (l_port = Z80InPort (b), Z80_TAPE_BREAK (), l_port)
 #define Z80OutPort(a,b,c)  Z80OutPort(b,c)
+#endif
+
+/* the cores don't look at the tape, JustRun() stops them at its edges.
+   An IN that starts or stops the tape, or brings an edge forward, ends
+   the run after the instruction so JustRun() can plan again */
+#define Z80_TAPE_BREAK() \
+  (tape_reschedule ? (tape_reschedule = 0, loop = r_ICount) : 0)
+
+/* the timed accessors in zx.c charge the core's cycle counter */
+#define Z80ReadMem(a)             Z80ReadMem(a,&r_ICount)
+#define Z80WriteMem(a,b,c)        Z80WriteMem(a,b,&r_ICount)
+#define contend_read(a)           contend_read(a,&r_ICount)
+#define contend_read_jr()         contend_read_jr(&r_PC,&r_ICount)
+#define contend_read_byte()       contend_read_byte(&r_ICount)
+#define contend_read_byte_x2()    contend_read_byte_x2(&r_ICount)
+#define contend_read_byte_x7()    contend_read_byte_x7(&r_ICount)
+#define contend_read_x5(a)        contend_read_x5(a,&r_ICount)
+#define contend_read_x4(a)        contend_read_x4(a,&r_ICount)
+#define contend_read_x2(a)        contend_read_x2(a,&r_ICount)
+#define ula_contend_port_early(a) ula_contend_port_early(a,&r_ICount)
+#define ula_contend_port_late(a)  ula_contend_port_late(a,&r_ICount)
 
 /* RAM variable, debug toggle variable, pressed key and
    row variables for keyboard emulation                   */
@@ -82,6 +133,243 @@ byte sz53p_table[0x100];	/* OR the above two tables together */
 
 #endif
 
+#ifdef Z80_LAZY_FLAGS
+/* work out the F left pending by the last ADD_FLAGS/SUB_FLAGS/CP_FLAGS */
+static inline void
+Z80Flags (Z80Regs * regs)
+{
+  word res = regs->lazy_res;
+  byte idx = regs->lazy_idx;
+
+  switch (regs->lazy_op)
+    {
+    case 0:
+      return;
+    case LAZY_ADD:
+      regs->AF.B.l = (res & 0x100 ? FLAG_C : 0) |
+	halfcarry_add_table[idx & 0x07] |
+	overflow_add_table[idx >> 4] | sz53_table[res & 0xff];
+      break;
+    case LAZY_SUB:
+      regs->AF.B.l = (res & 0x100 ? FLAG_C : 0) | FLAG_N |
+	halfcarry_sub_table[idx & 0x07] |
+	overflow_sub_table[idx >> 4] | sz53_table[res & 0xff];
+      break;
+    case LAZY_CP:
+      regs->AF.B.l = (res & 0x100 ? FLAG_C : (res ? 0 : FLAG_Z)) | FLAG_N |
+	halfcarry_sub_table[idx & 0x07] |
+	overflow_sub_table[idx >> 4] |
+	(regs->lazy_val & (FLAG_3 | FLAG_5)) | (res & FLAG_S);
+      break;
+    }
+  regs->lazy_op = 0;
+}
+#endif
+
+/*--- Idle loop skipping, see IDLE_LOOP_SKIP in z80_macros.h --------*/
+
+/* registers and ICount the last time a JR/JP was taken */
+static struct
+{
+  word pc, af, bc, de, hl, sp;
+  int icount, tstates, fetches;
+}
+idle_loop;
+
+/* the opcode Z80Run_NC ran last: no interrupt is taken right after EI */
+static byte lastopcode;
+
+/* the cores' state that outlives a call, see ZX_SelectMachine */
+MachineVar z80_vars[] = {
+  MACHINE_VAR (idle_loop), MACHINE_VAR (lastopcode),
+  {NULL, 0}
+};
+
+/* T-states in the uncontended cores of the opcodes an idle loop may be
+   made of, 0 for the ones that write, jump or use the stack. CB is the
+   time of CB xx on a register. */
+static const byte idle_tstates[256] = {
+   4, 10,  0,  6,  4,  4,  7,  4,  0, 11,  7,  6,  4,  4,  7,  4,
+   0, 10,  0,  6,  4,  4,  7,  4,  0, 11,  7,  6,  4,  4,  7,  4,
+   0, 10,  0,  6,  4,  4,  7,  4,  0, 11, 16,  6,  4,  4,  7,  4,
+   0, 10,  0,  6,  0,  0,  0,  4,  0, 11, 13,  6,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   0,  0,  0,  0,  0,  0,  0,  0,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+   0,  0,  0,  0,  0,  0,  7,  0,  0,  0,  0,  8,  0,  0,  7,  0,
+   0,  0,  0,  0,  0,  0,  7,  0,  0,  0,  0, 11,  0,  0,  7,  0,
+   0,  0,  0,  0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  7,  0,
+   0,  0,  0,  0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  7,  0
+};
+
+/* the length of an opcode of idle_tstates[] */
+static inline int
+idle_length (byte op)
+{
+  if (op == 0x01 || op == 0x11 || op == 0x21 || op == 0x31 ||
+      op == 0x2A || op == 0x3A)
+    return 3;
+  if ((op & 0xC7) == 0x06 || (op & 0xC7) == 0xC6 || op == 0xDB ||
+      op == 0xCB)
+    return 2;
+  return 1;
+}
+
+/* The jump at jpc is about to be taken with the registers it had last
+   time it was taken. If everything between its target and itself reads
+   only memory, the keyboard or the kempston port, and the time since then
+   is exactly one pass through that code, every further pass will do the
+   same. Returns how many passes can be skipped without getting to the end
+   of the slice, the frame wrap or the interrupt window, and leaves their
+   length in idle_loop.tstates and idle_loop.fetches. */
+static int
+Z80IdleLoop (Z80Regs * regs, word jpc, int icount, int loop)
+{
+  word pc, target;
+  byte op, cb;
+  int tstates, fetches = 1;
+
+  op = Z80ReadMem_notiming (jpc);
+  if (op == 0x18 || (op & 0xE7) == 0x20)      /* JR, JR cc */
+    {
+      target = jpc + 2 + (offset) Z80ReadMem_notiming (jpc + 1);
+      tstates = 12;
+    }
+  else                                        /* JP, JP cc */
+    {
+      target = Z80ReadMem_notiming (jpc + 1) |
+	(Z80ReadMem_notiming (jpc + 2) << 8);
+      tstates = 10;
+    }
+
+  for (pc = target; pc != jpc; pc += idle_length (op))
+    {
+      if ((word) (jpc - pc) > 32)
+	return 0;
+      op = Z80ReadMem_notiming (pc);
+      if (idle_tstates[op] == 0)
+	return 0;
+      tstates += idle_tstates[op];
+      fetches++;
+      if (op == 0xCB)
+	{
+	  /* BIT n,(HL) reads, the other CB xx on (HL) write */
+	  cb = Z80ReadMem_notiming (pc + 1);
+	  if ((cb & 0x07) == 0x06)
+	    {
+	      if ((cb & 0xC0) != 0x40)
+		return 0;
+	      tstates += 4;
+	    }
+	  fetches++;
+	}
+      else if (op == 0xDB)
+	{
+	  /* IN A,(FE) and IN A,(1F) only, and not with a tape inserted,
+	     loader_hook() counts those reads */
+	  cb = Z80ReadMem_notiming (pc + 1);
+	  if ((cb != 0xFE && cb != 0x1F) || tape_is_tape ())
+	    return 0;
+	}
+    }
+
+  if (idle_loop.icount - icount != tstates)
+    return 0;
+  if (loop < 0)
+    loop = 0;
+  if (icount > regs->IIntTime || icount <= loop)
+    return 0;
+  idle_loop.tstates = tstates;
+  idle_loop.fetches = fetches;
+  return (icount - loop - 1) / tstates;
+}
+
+/*--- Block instructions, see BLOCK_BATCH_LD in z80_macros.h --------*/
+
+/* The LDIR/LDDR (write set) or CPIR/CPDR at pc - 2 is about to run an
+   iteration with HL, DE and BC, the next one once more at ICount icount.
+   Returns how many iterations can be run in one go, each of them 21
+   T-states and followed by another one: they have to stay above floor,
+   leave BC for the one run as usual after them, keep within the 16K
+   pages HL and DE are in, write neither the screen nor the instruction
+   and, in the timed core, touch no contended memory. */
+static int
+Z80BlockCount (word pc, word hl, word de, word bc, int icount, int floor,
+	       int step, int write, int timed)
+{
+  byte *dst, *ip;
+  int count, n, at;
+
+  if (icount <= floor)
+    return 0;
+  count = (icount - floor - 1) / 21;
+  if (count > (word) (bc - 1))
+    count = (word) (bc - 1);
+  n = (step > 0 ? 0x4000 - (hl & 0x3FFF) : (hl & 0x3FFF) + 1);
+  if (count > n)
+    count = n;
+  if (timed && (MEMc[hl >> 14] || MEMc[(word) (pc - 2) >> 14] ||
+		MEMc[(word) (pc - 1) >> 14]))
+    return 0;
+  if (!write || count <= 0)
+    return count;
+
+  n = (step > 0 ? 0x4000 - (de & 0x3FFF) : (de & 0x3FFF) + 1);
+  if (count > n)
+    count = n;
+  if (timed && MEMc[de >> 14])
+    return 0;
+  dst = MEMw[de >> 14] + de;
+  at = (dst - RAM_pages) - 0x4000 * 5;
+  if (at >= 0 && (at & ~0x8000) < 0x4000)
+    return 0;
+  for (n = 2; n > 0; n--)
+    {
+      ip = MEMr[(word) (pc - n) >> 14] + (word) (pc - n);
+      at = (step > 0 ? ip - dst : dst - ip);
+      if (at >= 0 && at < count)
+	count = at;
+    }
+  return count;
+}
+
+#ifdef Z80_PROFILE
+#include <time.h>
+
+Z80Profile z80_profile[Z80_CORES];
+
+static unsigned long long
+Z80ProfileClock (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* ICount wraps by IPeriod inside Z80Run_NC, so count modulo a frame */
+#define PROFILE_ENTER() \
+  unsigned long long prof_ns = Z80ProfileClock (); \
+  int prof_icount = regs->ICount
+#define PROFILE_OPCODE(core) z80_profile[core].ops++
+#define PROFILE_OPCODES(core,n) z80_profile[core].ops += (n)
+#define PROFILE_LEAVE(core) \
+  z80_profile[core].calls++; \
+  z80_profile[core].ns += Z80ProfileClock () - prof_ns; \
+  z80_profile[core].tstates += \
+    (prof_icount - regs->ICount + regs->IPeriod) % regs->IPeriod
+#else
+#define PROFILE_ENTER()
+#define PROFILE_OPCODE(core)
+#define PROFILE_OPCODES(core,n)
+#define PROFILE_LEAVE(core)
+#endif
+
 /*====================================================================
   void Z80Reset( Z80Regs *regs, int cycles, int irqtime )
 
@@ -112,6 +400,9 @@ Z80Reset (Z80Regs * regs, int int_cycles, int int_irqtime)
 
   regs->IRequest = INT_NOINT;
   regs->we_are_on_ddfd = regs->dobreak = /*regs->BorderColor =*/ 0;
+#ifdef Z80_LAZY_FLAGS
+  regs->lazy_op = 0;
+#endif
 
 //#ifdef _DEBUG_
   regs->DecodingErrors = 1;
@@ -148,94 +439,137 @@ Z80Reset (Z80Regs * regs, int int_cycles, int int_irqtime)
   Pass as numcycles the number of clock cycle you want to execute
   z80 opcodes for or < 0 (negative) to execute "infinite" opcodes.
  ===================================================================*/
+/*--- threaded dispatch: ---------------------------------------------
+  Each Z80Run* defines Z80_FETCH (halt check, opcode fetch and R
+  increment), Z80_OPCODE (the variable the opcode is fetched into) and
+  Z80_EPILOGUE (what has to be done after every instruction). The
+  while() loop uses them for the first instruction and for the switch
+  build; with Z80_THREADED every NEXT in the opcode files expands to
+  its own copy of the loop test and fetch, ending in a computed goto. */
+#ifdef Z80_THREADED
+#define Z80_NEXT_OPCODE \
+  do { \
+    Z80_EPILOGUE \
+    if (r_ICount <= loop) goto z80_exit; \
+    Z80_FETCH \
+    goto *op_table[Z80_OPCODE]; \
+  } while (0)
+#endif
+
 word
 Z80Run (Z80Regs * regs, int numcycles)
 {
   /* opcode and temp variables */
-  volatile byte opcode;
+  byte opcode;
   eword tmpreg, ops, mread, tmpreg2;
   unsigned  tempdword;
   register int loop;
+  Z80_LOCALS
   unsigned short tempword;
+#ifdef Z80_THREADED
+  #include "z80_dispatch.h"
+#endif
+  PROFILE_ENTER ();
+  Z80_RELOAD ();
 
-  /* emulate <numcycles> cycles */
-  loop = (regs->ICount - numcycles);
-
-  /* this is the emulation main loop */
-  while (regs->ICount > loop)
-    {
 #ifdef DEBUG
-      /* test if we have reached the trap address */
-      if (regs->PC.W == regs->TrapAddress && regs->dobreak != 0)
-	return (regs->PC.W);
+  /* test if we have reached the trap address */
+#define Z80_TRAP \
+      if (r_PC == regs->TrapAddress && regs->dobreak != 0) \
+	{ Z80_SPILL (); FLAGS_SYNC (); return (regs->PC.W); }
+#else
+#define Z80_TRAP
 #endif
 
-      if (regs->halted == 1)
-	{
-	  r_PC--;
-//	  AddCycles (4);
-	}
+#define Z80_OPCODE opcode
+#define Z80_FETCH \
+      PROFILE_OPCODE (Z80_CORE_C); \
+      Z80_TRAP \
+      if (regs->halted == 1) \
+	r_PC--; \
+      /* read the opcode from memory (pointed by PC) */ \
+      opcode = Z80ReadMem (r_PC); \
+      AddCycles(1); \
+      r_PC++; \
+      /* increment the R register */ \
+      AddR (1);
+// No interrupt checking when emulating memory contention. Should speed up things...
+#define Z80_EPILOGUE
+#define Z80_CAN_REPEAT \
+      (r_ICount > loop)
+#define Z80_CORE Z80_CORE_C
 
-      /* read the opcode from memory (pointed by PC) */
-      opcode = Z80ReadMem (regs->PC.W);
-      AddCycles(1);
-      regs->PC.W++;
+#define Z80_POLICY C
 
-      /* increment the R register and decode the instruction */
-      AddR (1);
-      switch (opcode)
-      {
-         #include "opcodes.c"
+  /* emulate <numcycles> cycles */
+  loop = (r_ICount - numcycles);
 
-         case PREFIX_CB:  AddR (1);
-                          #include "op_cb.c"
-                          break;
+  /* this is the emulation main loop */
+  while (r_ICount > loop)
+    {
+      Z80_FETCH
 
-         case PREFIX_ED:  AddR (1);
-                          #include "op_ed.c" 
-                          break;
+      /* decode the instruction */
+      #define OP_PREFIX op
+      OPCODE_SWITCH (opcode)
+      {
+         #include "opcodes.c"
 
-         case PREFIX_DD:  AddR (1);
+         OPCODE (PREFIX_CB)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX cb
+                           #include "op_cb.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_ED)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX ed
+                           #include "op_ed.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_DD)  AddR (1);
                            #define REGISTER regs->IX
-                           regs->we_are_on_ddfd = WE_ARE_ON_DD;
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX dd
                            #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
 
-         case PREFIX_FD:  AddR (1);
+         OPCODE (PREFIX_FD)  AddR (1);
                            #define REGISTER regs->IY
-                           regs->we_are_on_ddfd = WE_ARE_ON_FD;
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX fd
                            #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
       }
+      #undef OP_PREFIX
 
-// No interrupt checking when emulating memory contention. Should speed up things...
-
-      /* patch ROM loading routine */
-     // Z80Patch (regs);
-     if(tape_playing)
-        loader (regs);
-
-      /* check if it's time to do other hardware emulation */
-//      if (regs->ICount <= 0)
-//	{
-//	  tmpreg.W = Z80Hardware (regs);
-//	  regs->ICount += regs->IPeriod;
-//	  loop = regs->ICount + loop;
-
-	  /* check if we must exit the emulation or there is an INT */
-//	  if (tmpreg.W == INT_QUIT)
-//	    return (regs->PC.W);
-//	  if (tmpreg.W != INT_NOINT)
-//	    Z80Interrupt (regs, tmpreg.W);
-//	    Z80Interrupt (regs);
-
-//	}
+      Z80_EPILOGUE
     }
+#ifdef Z80_THREADED
+z80_exit:
+#endif
 
+#undef Z80_TRAP
+#undef Z80_POLICY
+#undef Z80_OPCODE
+#undef Z80_FETCH
+#undef Z80_EPILOGUE
+#undef Z80_CAN_REPEAT
+#undef Z80_CORE
+
+  Z80_SPILL ();
+  FLAGS_SYNC ();
+  PROFILE_LEAVE (Z80_CORE_C);
   return (regs->PC.W);
 }
 
@@ -244,80 +578,121 @@ word
 Z80Run_NC (Z80Regs * regs, int numcycles)
 {
   /* opcode and temp variables */
-  static byte lastopcode;
-  volatile byte opcode;
+  byte opcode;
   eword tmpreg, ops, mread, tmpreg2;
   unsigned  tempdword;
   register int loop;
+  Z80_LOCALS
   unsigned short tempword;
+#ifdef Z80_THREADED
+  #include "z80_dispatch.h"
+#endif
+  PROFILE_ENTER ();
+  Z80_RELOAD ();
+  IDLE_LOOP_RESET ();
+
+#define Z80_OPCODE lastopcode
+#define Z80_FETCH \
+      PROFILE_OPCODE (Z80_CORE_NC); \
+      if (regs->halted == 1) \
+	r_PC--; \
+      /* read the opcode from memory (pointed by PC) */ \
+      lastopcode = Z80ReadMem_notiming (r_PC); \
+      r_PC++; \
+      /* increment the R register */ \
+      AddR (1);
+#define Z80_EPILOGUE \
+      /* check if it's time to do other hardware emulation */ \
+      if (r_ICount <= 0) \
+	{ \
+	  r_ICount += regs->IPeriod; \
+	  loop = r_ICount + loop; \
+	} \
+      if (r_ICount > regs->IIntTime) \
+	{ \
+	  if (lastopcode!=EI) \
+	    { \
+	      Z80_SPILL (); \
+	      Z80Interrupt_NC (regs); \
+	      Z80_RELOAD (); \
+	      IDLE_LOOP_RESET (); \
+	    } \
+	}
+#define Z80_CAN_REPEAT \
+      (r_ICount > loop && \
+       r_ICount > 0 && r_ICount <= regs->IIntTime)
+#define Z80_CORE Z80_CORE_NC
+
+#define Z80_POLICY NC
 
   /* emulate <numcycles> cycles */
-  loop = (regs->ICount - numcycles);
+  loop = (r_ICount - numcycles);
 
   /* this is the emulation main loop */
-  while (regs->ICount > loop)
+  while (r_ICount > loop)
     {
-      if (regs->halted == 1)
-	{
-	  r_PC--;
-	}
-
-      /* read the opcode from memory (pointed by PC) */
-      lastopcode = Z80ReadMem_notiming (regs->PC.W);
-      regs->PC.W++;
+      Z80_FETCH
 
-      /* increment the R register and decode the instruction */
-      AddR (1);
-      switch (lastopcode)
+      /* decode the instruction */
+      #define OP_PREFIX op
+      OPCODE_SWITCH (lastopcode)
       {
-         #include "opcodes_nc.c"
-
-         case PREFIX_CB:  AddR (1);
-                          #include "op_cb_nc.c"
-                          break;
-
-         case PREFIX_ED:  AddR (1);
-                          #include "op_ed_nc.c"
-                          break;
+         #include "opcodes.c"
 
-         case PREFIX_DD:  AddR (1);
+         OPCODE (PREFIX_CB)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX cb
+                           #include "op_cb.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_ED)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX ed
+                           #include "op_ed.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_DD)  AddR (1);
                            #define REGISTER regs->IX
-                           regs->we_are_on_ddfd = WE_ARE_ON_DD;
-                           #include "op_dd_fd_nc.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX dd
+                           #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
 
-         case PREFIX_FD:  AddR (1);
+         OPCODE (PREFIX_FD)  AddR (1);
                            #define REGISTER regs->IY
-                           regs->we_are_on_ddfd = WE_ARE_ON_FD;
-                           #include "op_dd_fd_nc.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX fd
+                           #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
       }
+      #undef OP_PREFIX
 
-      /* patch ROM loading routine */
-     // Z80Patch (regs);
-     if(tape_playing)
-        loader (regs);
-
-      /* check if it's time to do other hardware emulation */
-      if (regs->ICount <= 0)
-	{
-	  //tmpreg.W = Z80Hardware (regs);
-	  regs->ICount += regs->IPeriod;
-	  loop = regs->ICount + loop;
-	}
-      if (regs->ICount > regs->IIntTime)
-      	{
-      	if (lastopcode!=EI)
-      		{
-	    	Z80Interrupt_NC (regs);
-	    	}
-	}
+      Z80_EPILOGUE
     }
+#ifdef Z80_THREADED
+z80_exit:
+#endif
+
+#undef Z80_POLICY
+#undef Z80_OPCODE
+#undef Z80_FETCH
+#undef Z80_EPILOGUE
+#undef Z80_CAN_REPEAT
+#undef Z80_CORE
 
+  Z80_SPILL ();
+  FLAGS_SYNC ();
+  PROFILE_LEAVE (Z80_CORE_NC);
   return (regs->PC.W);
 }
 
@@ -325,83 +700,105 @@ word
 Z80Run_NCNI (Z80Regs * regs, int numcycles)
 {
   /* opcode and temp variables */
-  volatile byte opcode;
+  byte opcode;
   eword tmpreg, ops, mread, tmpreg2;
   unsigned  tempdword;
   register int loop;
+  Z80_LOCALS
   unsigned short tempword;
+#ifdef Z80_THREADED
+  #include "z80_dispatch.h"
+#endif
+  PROFILE_ENTER ();
+  Z80_RELOAD ();
+  IDLE_LOOP_RESET ();
+
+#define Z80_OPCODE opcode
+#define Z80_FETCH \
+      PROFILE_OPCODE (Z80_CORE_NCNI); \
+      if (regs->halted == 1) \
+	r_PC--; \
+      /* read the opcode from memory (pointed by PC) */ \
+      opcode = Z80ReadMem_notiming (r_PC); \
+      r_PC++; \
+      /* increment the R register */ \
+      AddR (1);
+// No interrupt check unless we're in the screen extremes
+#define Z80_EPILOGUE
+#define Z80_CAN_REPEAT \
+      (r_ICount > loop)
+#define Z80_CORE Z80_CORE_NCNI
+
+#define Z80_POLICY NC
 
   /* emulate <numcycles> cycles */
-  loop = (regs->ICount - numcycles);
+  loop = (r_ICount - numcycles);
 
   /* this is the emulation main loop */
-  while (regs->ICount > loop)
+  while (r_ICount > loop)
     {
-      if (regs->halted == 1)
-	{
-	  r_PC--;
-//	  AddCycles (4);
-	}
-
-      /* read the opcode from memory (pointed by PC) */
-      opcode = Z80ReadMem_notiming (regs->PC.W);
-//      AddCycles(1);
-      regs->PC.W++;
+      Z80_FETCH
 
-      /* increment the R register and decode the instruction */
-      AddR (1);
-      switch (opcode)
+      /* decode the instruction */
+      #define OP_PREFIX op
+      OPCODE_SWITCH (opcode)
       {
-         #include "opcodes_nc.c"
-
-         case PREFIX_CB:  AddR (1);
-                          #include "op_cb_nc.c"
-                          break;
-
-         case PREFIX_ED:  AddR (1);
-                          #include "op_ed_nc.c"
-                          break;
+         #include "opcodes.c"
 
-         case PREFIX_DD:  AddR (1);
+         OPCODE (PREFIX_CB)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX cb
+                           #include "op_cb.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_ED)  AddR (1);
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX ed
+                           #include "op_ed.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
+                          NEXT;
+
+         OPCODE (PREFIX_DD)  AddR (1);
                            #define REGISTER regs->IX
-                           regs->we_are_on_ddfd = WE_ARE_ON_DD;
-                           #include "op_dd_fd_nc.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX dd
+                           #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
 
-         case PREFIX_FD:  AddR (1);
+         OPCODE (PREFIX_FD)  AddR (1);
                            #define REGISTER regs->IY
-                           regs->we_are_on_ddfd = WE_ARE_ON_FD;
-                           #include "op_dd_fd_nc.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX fd
+                           #include "op_dd_fd.c"
+                           #undef  OP_PREFIX
+                           #define OP_PREFIX op
                            #undef  REGISTER
-                          regs->we_are_on_ddfd = 0;
-                          break;
+                          NEXT;
       }
+      #undef OP_PREFIX
 
-      /* patch ROM loading routine */
-     // Z80Patch (regs);
-     if(tape_playing)
-        loader (regs);
-
-// No interrupt check unless we're in the screen extremes...
-
-      /* check if it's time to do other hardware emulation */
-//      if (regs->ICount <= 0)
-//	{
-//	  //tmpreg.W = Z80Hardware (regs);
-//	  regs->ICount += regs->IPeriod;
-//	  loop = regs->ICount + loop;
-
-	  /* check if we must exit the emulation or there is an INT */
-	  //if (tmpreg.W == INT_QUIT)
-	    //return (regs->PC.W);
-	  //if (tmpreg.W != INT_NOINT)
-//	    Z80Interrupt_NC (regs, tmpreg.W);
-//	    Z80Interrupt_NC (regs);
-//	}
+      Z80_EPILOGUE
     }
+#ifdef Z80_THREADED
+z80_exit:
+#endif
+
+#undef Z80_POLICY
+#undef Z80_OPCODE
+#undef Z80_FETCH
+#undef Z80_EPILOGUE
+#undef Z80_CAN_REPEAT
+#undef Z80_CORE
 
+  Z80_SPILL ();
+  FLAGS_SYNC ();
+  PROFILE_LEAVE (Z80_CORE_NCNI);
   return (regs->PC.W);
 }
 
@@ -450,6 +847,15 @@ Z80Run_NCNI (Z80Regs * regs, int numcycles)
 //}
 
 
+/* the rest of the file works on the Z80Regs structure, the cores spill
+   their registers before calling into it */
+#undef  Z80_REGFILE
+#define Z80_REGFILE MEM
+#undef  Z80InPort
+#undef  Z80OutPort
+#define Z80InPort(a,b)     Z80InPort(b)
+#define Z80OutPort(a,b,c)  Z80OutPort(b,c)
+
 void
 Z80Interrupt_NC (Z80Regs * regs)
 {
@@ -461,7 +867,9 @@ Z80Interrupt_NC (Z80Regs * regs)
     if (regs->halted == 1)
       regs->halted = 0;
 
-      PUSH_NC (PC);
+#define Z80_POLICY NC
+      PUSH (PC);
+#undef  Z80_POLICY
       regs->IFF1 = 0;
       switch (regs->IM)
 	{
@@ -178,6 +178,12 @@ byte DecodingErrors;
 
    
 byte Trace, dobreak;
+
+#ifdef Z80_LAZY_FLAGS
+    /* pending F of the last 8 bit ADD/SUB/CP, see z80_macros.h */
+byte lazy_op, lazy_idx, lazy_val;
+word lazy_res;
+#endif
    
 //byte BorderColor;
  
@@ -187,6 +193,20 @@ Z80Regs;
 
 
 
+#ifdef Z80_PROFILE
+/*=== Per-core counters, only built for the headless benchmark ======*/
+enum { Z80_CORE_C, Z80_CORE_NC, Z80_CORE_NCNI, Z80_CORES };
+
+typedef struct
+{
+  unsigned long long calls, ops, tstates, ns;
+}
+Z80Profile;
+
+extern Z80Profile z80_profile[Z80_CORES];
+#endif
+
+
 /*====================================================================
    Function declarations, read the .c file to know what they do.
  ===================================================================*/ 
@@ -203,17 +223,19 @@ word Z80Run_NC (register Z80Regs *, int);
 word Z80Run_NCNI (register Z80Regs *, int);
 
 void Z80Patch (register Z80Regs *);
-inline void loader (register Z80Regs *);//TODO juntarla con la otra
+void loader (register Z80Regs *);//TODO juntarla con la otra
+int loader_next_edge (register Z80Regs *);
 
 byte Z80Debug (register Z80Regs *);
 
 //word Z80Hardware (register Z80Regs *);
 
-inline byte Z80ReadMem (register word);
+inline byte Z80ReadMem (register word, int *);
 inline byte Z80ReadMem_notiming (register word);
 
-inline void Z80WriteMem (register word, register byte);
+inline void Z80WriteMem (register word, register byte, int *);
 inline void Z80WriteMem_notiming (register word, register byte);
+inline void Z80WriteMem_uncontended (register word, register byte, int *);
 
 byte Z80InPort (register word);
 
@@ -0,0 +1,368 @@
+/*=====================================================================
+  z80_dispatch.h -> Label tables for the threaded Z80 dispatch.
+
+  Included inside each Z80Run* function when Z80_THREADED is defined.
+  Every entry is the address of the OPCODE() label for that opcode
+  value, as named by the OP_PREFIX in effect when z80.c includes the
+  opcode file; values with no handler go to the file's OPCODE_DEFAULT.
+  Entries must follow the opcode values in z80_tables.h.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ ======================================================================*/
+
+/* one byte opcodes (opcodes.c and the prefixes in z80.c) */
+static const void *const op_table[256] =
+{
+  /* 00 */ &&op_NOP, &&op_LD_BC_NN, &&op_LD_xBC_A, &&op_INC_BC,
+  /* 04 */ &&op_INC_B, &&op_DEC_B, &&op_LD_B_N, &&op_RLCA,
+  /* 08 */ &&op_EX_AF_AF, &&op_ADD_HL_BC, &&op_LD_A_xBC, &&op_DEC_BC,
+  /* 0C */ &&op_INC_C, &&op_DEC_C, &&op_LD_C_N, &&op_RRCA,
+  /* 10 */ &&op_DJNZ, &&op_LD_DE_NN, &&op_LD_xDE_A, &&op_INC_DE,
+  /* 14 */ &&op_INC_D, &&op_DEC_D, &&op_LD_D_N, &&op_RLA,
+  /* 18 */ &&op_JR, &&op_ADD_HL_DE, &&op_LD_A_xDE, &&op_DEC_DE,
+  /* 1C */ &&op_INC_E, &&op_DEC_E, &&op_LD_E_N, &&op_RRA,
+  /* 20 */ &&op_JR_NZ, &&op_LD_HL_NN, &&op_LD_xNN_HL, &&op_INC_HL,
+  /* 24 */ &&op_INC_H, &&op_DEC_H, &&op_LD_H_N, &&op_DAA,
+  /* 28 */ &&op_JR_Z, &&op_ADD_HL_HL, &&op_LD_HL_xNN, &&op_DEC_HL,
+  /* 2C */ &&op_INC_L, &&op_DEC_L, &&op_LD_L_N, &&op_CPL,
+  /* 30 */ &&op_JR_NC, &&op_LD_SP_NN, &&op_LD_xNN_A, &&op_INC_SP,
+  /* 34 */ &&op_INC_xHL, &&op_DEC_xHL, &&op_LD_xHL_N, &&op_SCF,
+  /* 38 */ &&op_JR_C, &&op_ADD_HL_SP, &&op_LD_A_xNN, &&op_DEC_SP,
+  /* 3C */ &&op_INC_A, &&op_DEC_A, &&op_LD_A_N, &&op_CCF,
+  /* 40 */ &&op_LD_B_B, &&op_LD_B_C, &&op_LD_B_D, &&op_LD_B_E,
+  /* 44 */ &&op_LD_B_H, &&op_LD_B_L, &&op_LD_B_xHL, &&op_LD_B_A,
+  /* 48 */ &&op_LD_C_B, &&op_LD_C_C, &&op_LD_C_D, &&op_LD_C_E,
+  /* 4C */ &&op_LD_C_H, &&op_LD_C_L, &&op_LD_C_xHL, &&op_LD_C_A,
+  /* 50 */ &&op_LD_D_B, &&op_LD_D_C, &&op_LD_D_D, &&op_LD_D_E,
+  /* 54 */ &&op_LD_D_H, &&op_LD_D_L, &&op_LD_D_xHL, &&op_LD_D_A,
+  /* 58 */ &&op_LD_E_B, &&op_LD_E_C, &&op_LD_E_D, &&op_LD_E_E,
+  /* 5C */ &&op_LD_E_H, &&op_LD_E_L, &&op_LD_E_xHL, &&op_LD_E_A,
+  /* 60 */ &&op_LD_H_B, &&op_LD_H_C, &&op_LD_H_D, &&op_LD_H_E,
+  /* 64 */ &&op_LD_H_H, &&op_LD_H_L, &&op_LD_H_xHL, &&op_LD_H_A,
+  /* 68 */ &&op_LD_L_B, &&op_LD_L_C, &&op_LD_L_D, &&op_LD_L_E,
+  /* 6C */ &&op_LD_L_H, &&op_LD_L_L, &&op_LD_L_xHL, &&op_LD_L_A,
+  /* 70 */ &&op_LD_xHL_B, &&op_LD_xHL_C, &&op_LD_xHL_D, &&op_LD_xHL_E,
+  /* 74 */ &&op_LD_xHL_H, &&op_LD_xHL_L, &&op_HALT, &&op_LD_xHL_A,
+  /* 78 */ &&op_LD_A_B, &&op_LD_A_C, &&op_LD_A_D, &&op_LD_A_E,
+  /* 7C */ &&op_LD_A_H, &&op_LD_A_L, &&op_LD_A_xHL, &&op_LD_A_A,
+  /* 80 */ &&op_ADD_B, &&op_ADD_C, &&op_ADD_D, &&op_ADD_E,
+  /* 84 */ &&op_ADD_H, &&op_ADD_L, &&op_ADD_xHL, &&op_ADD_A,
+  /* 88 */ &&op_ADC_B, &&op_ADC_C, &&op_ADC_D, &&op_ADC_E,
+  /* 8C */ &&op_ADC_H, &&op_ADC_L, &&op_ADC_xHL, &&op_ADC_A,
+  /* 90 */ &&op_SUB_B, &&op_SUB_C, &&op_SUB_D, &&op_SUB_E,
+  /* 94 */ &&op_SUB_H, &&op_SUB_L, &&op_SUB_xHL, &&op_SUB_A,
+  /* 98 */ &&op_SBC_B, &&op_SBC_C, &&op_SBC_D, &&op_SBC_E,
+  /* 9C */ &&op_SBC_H, &&op_SBC_L, &&op_SBC_xHL, &&op_SBC_A,
+  /* A0 */ &&op_AND_B, &&op_AND_C, &&op_AND_D, &&op_AND_E,
+  /* A4 */ &&op_AND_H, &&op_AND_L, &&op_AND_xHL, &&op_AND_A,
+  /* A8 */ &&op_XOR_B, &&op_XOR_C, &&op_XOR_D, &&op_XOR_E,
+  /* AC */ &&op_XOR_H, &&op_XOR_L, &&op_XOR_xHL, &&op_XOR_A,
+  /* B0 */ &&op_OR_B, &&op_OR_C, &&op_OR_D, &&op_OR_E,
+  /* B4 */ &&op_OR_H, &&op_OR_L, &&op_OR_xHL, &&op_OR_A,
+  /* B8 */ &&op_CP_B, &&op_CP_C, &&op_CP_D, &&op_CP_E,
+  /* BC */ &&op_CP_H, &&op_CP_L, &&op_CP_xHL, &&op_CP_A,
+  /* C0 */ &&op_RET_NZ, &&op_POP_BC, &&op_JP_NZ, &&op_JP,
+  /* C4 */ &&op_CALL_NZ, &&op_PUSH_BC, &&op_ADD_N, &&op_RST_00,
+  /* C8 */ &&op_RET_Z, &&op_RET, &&op_JP_Z, &&op_PREFIX_CB,
+  /* CC */ &&op_CALL_Z, &&op_CALL, &&op_ADC_N, &&op_RST_08,
+  /* D0 */ &&op_RET_NC, &&op_POP_DE, &&op_JP_NC, &&op_OUT_N_A,
+  /* D4 */ &&op_CALL_NC, &&op_PUSH_DE, &&op_SUB_N, &&op_RST_10,
+  /* D8 */ &&op_RET_C, &&op_EXX, &&op_JP_C, &&op_IN_A_N,
+  /* DC */ &&op_CALL_C, &&op_PREFIX_DD, &&op_SBC_N, &&op_RST_18,
+  /* E0 */ &&op_RET_PO, &&op_POP_HL, &&op_JP_PO, &&op_EX_HL_xSP,
+  /* E4 */ &&op_CALL_PO, &&op_PUSH_HL, &&op_AND_N, &&op_RST_20,
+  /* E8 */ &&op_RET_PE, &&op_JP_xHL, &&op_JP_PE, &&op_EX_DE_HL,
+  /* EC */ &&op_CALL_PE, &&op_PREFIX_ED, &&op_XOR_N, &&op_RST_28,
+  /* F0 */ &&op_RET_P, &&op_POP_AF, &&op_JP_P, &&op_DI,
+  /* F4 */ &&op_CALL_P, &&op_PUSH_AF, &&op_OR_N, &&op_RST_30,
+  /* F8 */ &&op_RET_M, &&op_LD_SP_HL, &&op_JP_M, &&op_EI,
+  /* FC */ &&op_CALL_M, &&op_PREFIX_FD, &&op_CP_N, &&op_RST_38
+};
+
+/* CB xx (op_cb.c) */
+static const void *const cb_table[256] =
+{
+  /* 00 */ &&cb_RLC_B, &&cb_RLC_C, &&cb_RLC_D, &&cb_RLC_E,
+  /* 04 */ &&cb_RLC_H, &&cb_RLC_L, &&cb_RLC_xHL, &&cb_RLC_A,
+  /* 08 */ &&cb_RRC_B, &&cb_RRC_C, &&cb_RRC_D, &&cb_RRC_E,
+  /* 0C */ &&cb_RRC_H, &&cb_RRC_L, &&cb_RRC_xHL, &&cb_RRC_A,
+  /* 10 */ &&cb_RL_B, &&cb_RL_C, &&cb_RL_D, &&cb_RL_E,
+  /* 14 */ &&cb_RL_H, &&cb_RL_L, &&cb_RL_xHL, &&cb_RL_A,
+  /* 18 */ &&cb_RR_B, &&cb_RR_C, &&cb_RR_D, &&cb_RR_E,
+  /* 1C */ &&cb_RR_H, &&cb_RR_L, &&cb_RR_xHL, &&cb_RR_A,
+  /* 20 */ &&cb_SLA_B, &&cb_SLA_C, &&cb_SLA_D, &&cb_SLA_E,
+  /* 24 */ &&cb_SLA_H, &&cb_SLA_L, &&cb_SLA_xHL, &&cb_SLA_A,
+  /* 28 */ &&cb_SRA_B, &&cb_SRA_C, &&cb_SRA_D, &&cb_SRA_E,
+  /* 2C */ &&cb_SRA_H, &&cb_SRA_L, &&cb_SRA_xHL, &&cb_SRA_A,
+  /* 30 */ &&cb_SLL_B, &&cb_SLL_C, &&cb_SLL_D, &&cb_SLL_E,
+  /* 34 */ &&cb_SLL_H, &&cb_SLL_L, &&cb_SLL_xHL, &&cb_SLL_A,
+  /* 38 */ &&cb_SRL_B, &&cb_SRL_C, &&cb_SRL_D, &&cb_SRL_E,
+  /* 3C */ &&cb_SRL_H, &&cb_SRL_L, &&cb_SRL_xHL, &&cb_SRL_A,
+  /* 40 */ &&cb_BIT_0_B, &&cb_BIT_0_C, &&cb_BIT_0_D, &&cb_BIT_0_E,
+  /* 44 */ &&cb_BIT_0_H, &&cb_BIT_0_L, &&cb_BIT_0_xHL, &&cb_BIT_0_A,
+  /* 48 */ &&cb_BIT_1_B, &&cb_BIT_1_C, &&cb_BIT_1_D, &&cb_BIT_1_E,
+  /* 4C */ &&cb_BIT_1_H, &&cb_BIT_1_L, &&cb_BIT_1_xHL, &&cb_BIT_1_A,
+  /* 50 */ &&cb_BIT_2_B, &&cb_BIT_2_C, &&cb_BIT_2_D, &&cb_BIT_2_E,
+  /* 54 */ &&cb_BIT_2_H, &&cb_BIT_2_L, &&cb_BIT_2_xHL, &&cb_BIT_2_A,
+  /* 58 */ &&cb_BIT_3_B, &&cb_BIT_3_C, &&cb_BIT_3_D, &&cb_BIT_3_E,
+  /* 5C */ &&cb_BIT_3_H, &&cb_BIT_3_L, &&cb_BIT_3_xHL, &&cb_BIT_3_A,
+  /* 60 */ &&cb_BIT_4_B, &&cb_BIT_4_C, &&cb_BIT_4_D, &&cb_BIT_4_E,
+  /* 64 */ &&cb_BIT_4_H, &&cb_BIT_4_L, &&cb_BIT_4_xHL, &&cb_BIT_4_A,
+  /* 68 */ &&cb_BIT_5_B, &&cb_BIT_5_C, &&cb_BIT_5_D, &&cb_BIT_5_E,
+  /* 6C */ &&cb_BIT_5_H, &&cb_BIT_5_L, &&cb_BIT_5_xHL, &&cb_BIT_5_A,
+  /* 70 */ &&cb_BIT_6_B, &&cb_BIT_6_C, &&cb_BIT_6_D, &&cb_BIT_6_E,
+  /* 74 */ &&cb_BIT_6_H, &&cb_BIT_6_L, &&cb_BIT_6_xHL, &&cb_BIT_6_A,
+  /* 78 */ &&cb_BIT_7_B, &&cb_BIT_7_C, &&cb_BIT_7_D, &&cb_BIT_7_E,
+  /* 7C */ &&cb_BIT_7_H, &&cb_BIT_7_L, &&cb_BIT_7_xHL, &&cb_BIT_7_A,
+  /* 80 */ &&cb_RES_0_B, &&cb_RES_0_C, &&cb_RES_0_D, &&cb_RES_0_E,
+  /* 84 */ &&cb_RES_0_H, &&cb_RES_0_L, &&cb_RES_0_xHL, &&cb_RES_0_A,
+  /* 88 */ &&cb_RES_1_B, &&cb_RES_1_C, &&cb_RES_1_D, &&cb_RES_1_E,
+  /* 8C */ &&cb_RES_1_H, &&cb_RES_1_L, &&cb_RES_1_xHL, &&cb_RES_1_A,
+  /* 90 */ &&cb_RES_2_B, &&cb_RES_2_C, &&cb_RES_2_D, &&cb_RES_2_E,
+  /* 94 */ &&cb_RES_2_H, &&cb_RES_2_L, &&cb_RES_2_xHL, &&cb_RES_2_A,
+  /* 98 */ &&cb_RES_3_B, &&cb_RES_3_C, &&cb_RES_3_D, &&cb_RES_3_E,
+  /* 9C */ &&cb_RES_3_H, &&cb_RES_3_L, &&cb_RES_3_xHL, &&cb_RES_3_A,
+  /* A0 */ &&cb_RES_4_B, &&cb_RES_4_C, &&cb_RES_4_D, &&cb_RES_4_E,
+  /* A4 */ &&cb_RES_4_H, &&cb_RES_4_L, &&cb_RES_4_xHL, &&cb_RES_4_A,
+  /* A8 */ &&cb_RES_5_B, &&cb_RES_5_C, &&cb_RES_5_D, &&cb_RES_5_E,
+  /* AC */ &&cb_RES_5_H, &&cb_RES_5_L, &&cb_RES_5_xHL, &&cb_RES_5_A,
+  /* B0 */ &&cb_RES_6_B, &&cb_RES_6_C, &&cb_RES_6_D, &&cb_RES_6_E,
+  /* B4 */ &&cb_RES_6_H, &&cb_RES_6_L, &&cb_RES_6_xHL, &&cb_RES_6_A,
+  /* B8 */ &&cb_RES_7_B, &&cb_RES_7_C, &&cb_RES_7_D, &&cb_RES_7_E,
+  /* BC */ &&cb_RES_7_H, &&cb_RES_7_L, &&cb_RES_7_xHL, &&cb_RES_7_A,
+  /* C0 */ &&cb_SET_0_B, &&cb_SET_0_C, &&cb_SET_0_D, &&cb_SET_0_E,
+  /* C4 */ &&cb_SET_0_H, &&cb_SET_0_L, &&cb_SET_0_xHL, &&cb_SET_0_A,
+  /* C8 */ &&cb_SET_1_B, &&cb_SET_1_C, &&cb_SET_1_D, &&cb_SET_1_E,
+  /* CC */ &&cb_SET_1_H, &&cb_SET_1_L, &&cb_SET_1_xHL, &&cb_SET_1_A,
+  /* D0 */ &&cb_SET_2_B, &&cb_SET_2_C, &&cb_SET_2_D, &&cb_SET_2_E,
+  /* D4 */ &&cb_SET_2_H, &&cb_SET_2_L, &&cb_SET_2_xHL, &&cb_SET_2_A,
+  /* D8 */ &&cb_SET_3_B, &&cb_SET_3_C, &&cb_SET_3_D, &&cb_SET_3_E,
+  /* DC */ &&cb_SET_3_H, &&cb_SET_3_L, &&cb_SET_3_xHL, &&cb_SET_3_A,
+  /* E0 */ &&cb_SET_4_B, &&cb_SET_4_C, &&cb_SET_4_D, &&cb_SET_4_E,
+  /* E4 */ &&cb_SET_4_H, &&cb_SET_4_L, &&cb_SET_4_xHL, &&cb_SET_4_A,
+  /* E8 */ &&cb_SET_5_B, &&cb_SET_5_C, &&cb_SET_5_D, &&cb_SET_5_E,
+  /* EC */ &&cb_SET_5_H, &&cb_SET_5_L, &&cb_SET_5_xHL, &&cb_SET_5_A,
+  /* F0 */ &&cb_SET_6_B, &&cb_SET_6_C, &&cb_SET_6_D, &&cb_SET_6_E,
+  /* F4 */ &&cb_SET_6_H, &&cb_SET_6_L, &&cb_SET_6_xHL, &&cb_SET_6_A,
+  /* F8 */ &&cb_SET_7_B, &&cb_SET_7_C, &&cb_SET_7_D, &&cb_SET_7_E,
+  /* FC */ &&cb_SET_7_H, &&cb_SET_7_L, &&cb_SET_7_xHL, &&cb_SET_7_A
+};
+
+/* ED xx (op_ed.c) */
+static const void *const ed_table[256] =
+{
+  /* 00 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 04 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 08 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 0C */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 10 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 14 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 18 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 1C */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 20 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 24 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 28 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 2C */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 30 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 34 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 38 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 3C */ &&ed_default, &&ed_default, &&ed_default, &&ed_TRAPLOAD,
+  /* 40 */ &&ed_IN_B_xC, &&ed_OUT_xC_B, &&ed_SBC_HL_BC, &&ed_LD_xNNe_BC,
+  /* 44 */ &&ed_NEG, &&ed_RETN, &&ed_IM_0, &&ed_LD_I_A,
+  /* 48 */ &&ed_IN_C_xC, &&ed_OUT_xC_C, &&ed_ADC_HL_BC, &&ed_LD_BC_xNNe,
+  /* 4C */ &&ed_ED_4C, &&ed_RETI, &&ed_ED_4E, &&ed_LD_R_A,
+  /* 50 */ &&ed_IN_D_xC, &&ed_OUT_xC_D, &&ed_SBC_HL_DE, &&ed_LD_xNNe_DE,
+  /* 54 */ &&ed_ED_54, &&ed_ED_55, &&ed_IM_1, &&ed_LD_A_I,
+  /* 58 */ &&ed_IN_E_xC, &&ed_OUT_xC_E, &&ed_ADC_HL_DE, &&ed_LD_DE_xNNe,
+  /* 5C */ &&ed_ED_5C, &&ed_ED_5D, &&ed_IM_2, &&ed_LD_A_R,
+  /* 60 */ &&ed_IN_H_xC, &&ed_OUT_xC_H, &&ed_SBC_HL_HL, &&ed_LD_xNNe_HL,
+  /* 64 */ &&ed_ED_64, &&ed_ED_65, &&ed_ED_66, &&ed_RRD,
+  /* 68 */ &&ed_IN_L_xC, &&ed_OUT_xC_L, &&ed_ADC_HL_HL, &&ed_LD_HL_xNNe,
+  /* 6C */ &&ed_ED_6C, &&ed_ED_6D, &&ed_ED_6E, &&ed_RLD,
+  /* 70 */ &&ed_IN_F_xC, &&ed_ED_71, &&ed_SBC_HL_SP, &&ed_LD_xNNe_SP,
+  /* 74 */ &&ed_ED_74, &&ed_ED_75, &&ed_ED_76, &&ed_ED_77,
+  /* 78 */ &&ed_IN_A_xC, &&ed_OUT_xC_A, &&ed_ADC_HL_SP, &&ed_LD_SP_xNNe,
+  /* 7C */ &&ed_ED_7C, &&ed_ED_7D, &&ed_ED_7E, &&ed_ED_7F,
+  /* 80 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 84 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 88 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 8C */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 90 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 94 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 98 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* 9C */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* A0 */ &&ed_LDI, &&ed_CPI, &&ed_INI, &&ed_OUTI,
+  /* A4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* A8 */ &&ed_LDD, &&ed_CPD, &&ed_IND, &&ed_OUTD,
+  /* AC */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* B0 */ &&ed_LDIR, &&ed_CPIR, &&ed_INIR, &&ed_OTIR,
+  /* B4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* B8 */ &&ed_LDDR, &&ed_CPDR, &&ed_INDR, &&ed_OTDR,
+  /* BC */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* C0 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* C4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* C8 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* CC */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* D0 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* D4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* D8 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* DC */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* E0 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* E4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* E8 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* EC */ &&ed_default, &&ed_PREFIX_ED, &&ed_default, &&ed_default,
+  /* F0 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* F4 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* F8 */ &&ed_default, &&ed_default, &&ed_default, &&ed_default,
+  /* FC */ &&ed_default, &&ed_default, &&ed_default, &&ed_default
+};
+
+/* DD xx (op_dd_fd.c with REGISTER = IX) */
+static const void *const dd_table[256] =
+{
+  /* 00 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 04 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 08 */ &&dd_default, &&dd_ADD_IXY_BC, &&dd_default, &&dd_default,
+  /* 0C */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 10 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 14 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 18 */ &&dd_default, &&dd_ADD_IXY_DE, &&dd_default, &&dd_default,
+  /* 1C */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 20 */ &&dd_default, &&dd_LD_IXY_NN, &&dd_LD_xNN_IXY, &&dd_INC_IXY,
+  /* 24 */ &&dd_INC_IXYh, &&dd_DEC_IXYh, &&dd_LD_IXYh_N, &&dd_default,
+  /* 28 */ &&dd_default, &&dd_ADD_IXY_IXY, &&dd_LD_IXY_xNN, &&dd_DEC_IXY,
+  /* 2C */ &&dd_INC_IXYl, &&dd_DEC_IXYl, &&dd_LD_IXYl_N, &&dd_default,
+  /* 30 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 34 */ &&dd_INC_xIXY, &&dd_DEC_xIXY, &&dd_LD_xIXY_N, &&dd_default,
+  /* 38 */ &&dd_default, &&dd_ADD_IXY_SP, &&dd_default, &&dd_default,
+  /* 3C */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 40 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 44 */ &&dd_LD_B_IXYh, &&dd_LD_B_IXYl, &&dd_LD_B_xIXY, &&dd_default,
+  /* 48 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 4C */ &&dd_LD_C_IXYh, &&dd_LD_C_IXYl, &&dd_LD_C_xIXY, &&dd_default,
+  /* 50 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 54 */ &&dd_LD_D_IXYh, &&dd_LD_D_IXYl, &&dd_LD_D_xIXY, &&dd_default,
+  /* 58 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 5C */ &&dd_LD_E_IXYh, &&dd_LD_E_IXYl, &&dd_LD_E_xIXY, &&dd_default,
+  /* 60 */ &&dd_LD_IXYh_B, &&dd_LD_IXYh_C, &&dd_LD_IXYh_D, &&dd_LD_IXYh_E,
+  /* 64 */ &&dd_LD_IXYh_IXYh, &&dd_LD_IXYh_IXYl, &&dd_LD_H_xIXY, &&dd_LD_IXYh_A,
+  /* 68 */ &&dd_LD_IXYl_B, &&dd_LD_IXYl_C, &&dd_LD_IXYl_D, &&dd_LD_IXYl_E,
+  /* 6C */ &&dd_LD_IXYl_IXYh, &&dd_LD_IXYl_IXYl, &&dd_LD_L_xIXY, &&dd_LD_IXYl_A,
+  /* 70 */ &&dd_LD_xIXY_B, &&dd_LD_xIXY_C, &&dd_LD_xIXY_D, &&dd_LD_xIXY_E,
+  /* 74 */ &&dd_LD_xIXY_H, &&dd_LD_xIXY_L, &&dd_default, &&dd_LD_xIXY_A,
+  /* 78 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 7C */ &&dd_LD_A_IXYh, &&dd_LD_A_IXYl, &&dd_LD_A_xIXY, &&dd_default,
+  /* 80 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 84 */ &&dd_ADD_IXYh, &&dd_ADD_IXYl, &&dd_ADD_xIXY, &&dd_default,
+  /* 88 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 8C */ &&dd_ADC_IXYh, &&dd_ADC_IXYl, &&dd_ADC_xIXY, &&dd_default,
+  /* 90 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 94 */ &&dd_SUB_IXYh, &&dd_SUB_IXYl, &&dd_SUB_xIXY, &&dd_default,
+  /* 98 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* 9C */ &&dd_SBC_IXYh, &&dd_SBC_IXYl, &&dd_SBC_xIXY, &&dd_default,
+  /* A0 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* A4 */ &&dd_AND_IXYh, &&dd_AND_IXYl, &&dd_AND_xIXY, &&dd_default,
+  /* A8 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* AC */ &&dd_XOR_IXYh, &&dd_XOR_IXYl, &&dd_XOR_xIXY, &&dd_default,
+  /* B0 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* B4 */ &&dd_OR_IXYh, &&dd_OR_IXYl, &&dd_OR_xIXY, &&dd_default,
+  /* B8 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* BC */ &&dd_CP_IXYh, &&dd_CP_IXYl, &&dd_CP_xIXY, &&dd_default,
+  /* C0 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* C4 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* C8 */ &&dd_default, &&dd_default, &&dd_default, &&dd_PREFIX_CB,
+  /* CC */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* D0 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* D4 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* D8 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* DC */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* E0 */ &&dd_default, &&dd_POP_IXY, &&dd_default, &&dd_EX_IXY_xSP,
+  /* E4 */ &&dd_default, &&dd_PUSH_IXY, &&dd_default, &&dd_default,
+  /* E8 */ &&dd_default, &&dd_JP_IXY, &&dd_default, &&dd_default,
+  /* EC */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* F0 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* F4 */ &&dd_default, &&dd_default, &&dd_default, &&dd_default,
+  /* F8 */ &&dd_default, &&dd_LD_SP_IXY, &&dd_default, &&dd_default,
+  /* FC */ &&dd_default, &&dd_default, &&dd_default, &&dd_default
+};
+
+/* FD xx (op_dd_fd.c with REGISTER = IY) */
+static const void *const fd_table[256] =
+{
+  /* 00 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 04 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 08 */ &&fd_default, &&fd_ADD_IXY_BC, &&fd_default, &&fd_default,
+  /* 0C */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 10 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 14 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 18 */ &&fd_default, &&fd_ADD_IXY_DE, &&fd_default, &&fd_default,
+  /* 1C */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 20 */ &&fd_default, &&fd_LD_IXY_NN, &&fd_LD_xNN_IXY, &&fd_INC_IXY,
+  /* 24 */ &&fd_INC_IXYh, &&fd_DEC_IXYh, &&fd_LD_IXYh_N, &&fd_default,
+  /* 28 */ &&fd_default, &&fd_ADD_IXY_IXY, &&fd_LD_IXY_xNN, &&fd_DEC_IXY,
+  /* 2C */ &&fd_INC_IXYl, &&fd_DEC_IXYl, &&fd_LD_IXYl_N, &&fd_default,
+  /* 30 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 34 */ &&fd_INC_xIXY, &&fd_DEC_xIXY, &&fd_LD_xIXY_N, &&fd_default,
+  /* 38 */ &&fd_default, &&fd_ADD_IXY_SP, &&fd_default, &&fd_default,
+  /* 3C */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 40 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 44 */ &&fd_LD_B_IXYh, &&fd_LD_B_IXYl, &&fd_LD_B_xIXY, &&fd_default,
+  /* 48 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 4C */ &&fd_LD_C_IXYh, &&fd_LD_C_IXYl, &&fd_LD_C_xIXY, &&fd_default,
+  /* 50 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 54 */ &&fd_LD_D_IXYh, &&fd_LD_D_IXYl, &&fd_LD_D_xIXY, &&fd_default,
+  /* 58 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 5C */ &&fd_LD_E_IXYh, &&fd_LD_E_IXYl, &&fd_LD_E_xIXY, &&fd_default,
+  /* 60 */ &&fd_LD_IXYh_B, &&fd_LD_IXYh_C, &&fd_LD_IXYh_D, &&fd_LD_IXYh_E,
+  /* 64 */ &&fd_LD_IXYh_IXYh, &&fd_LD_IXYh_IXYl, &&fd_LD_H_xIXY, &&fd_LD_IXYh_A,
+  /* 68 */ &&fd_LD_IXYl_B, &&fd_LD_IXYl_C, &&fd_LD_IXYl_D, &&fd_LD_IXYl_E,
+  /* 6C */ &&fd_LD_IXYl_IXYh, &&fd_LD_IXYl_IXYl, &&fd_LD_L_xIXY, &&fd_LD_IXYl_A,
+  /* 70 */ &&fd_LD_xIXY_B, &&fd_LD_xIXY_C, &&fd_LD_xIXY_D, &&fd_LD_xIXY_E,
+  /* 74 */ &&fd_LD_xIXY_H, &&fd_LD_xIXY_L, &&fd_default, &&fd_LD_xIXY_A,
+  /* 78 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 7C */ &&fd_LD_A_IXYh, &&fd_LD_A_IXYl, &&fd_LD_A_xIXY, &&fd_default,
+  /* 80 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 84 */ &&fd_ADD_IXYh, &&fd_ADD_IXYl, &&fd_ADD_xIXY, &&fd_default,
+  /* 88 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 8C */ &&fd_ADC_IXYh, &&fd_ADC_IXYl, &&fd_ADC_xIXY, &&fd_default,
+  /* 90 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 94 */ &&fd_SUB_IXYh, &&fd_SUB_IXYl, &&fd_SUB_xIXY, &&fd_default,
+  /* 98 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* 9C */ &&fd_SBC_IXYh, &&fd_SBC_IXYl, &&fd_SBC_xIXY, &&fd_default,
+  /* A0 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* A4 */ &&fd_AND_IXYh, &&fd_AND_IXYl, &&fd_AND_xIXY, &&fd_default,
+  /* A8 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* AC */ &&fd_XOR_IXYh, &&fd_XOR_IXYl, &&fd_XOR_xIXY, &&fd_default,
+  /* B0 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* B4 */ &&fd_OR_IXYh, &&fd_OR_IXYl, &&fd_OR_xIXY, &&fd_default,
+  /* B8 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* BC */ &&fd_CP_IXYh, &&fd_CP_IXYl, &&fd_CP_xIXY, &&fd_default,
+  /* C0 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* C4 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* C8 */ &&fd_default, &&fd_default, &&fd_default, &&fd_PREFIX_CB,
+  /* CC */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* D0 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* D4 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* D8 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* DC */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* E0 */ &&fd_default, &&fd_POP_IXY, &&fd_default, &&fd_EX_IXY_xSP,
+  /* E4 */ &&fd_default, &&fd_PUSH_IXY, &&fd_default, &&fd_default,
+  /* E8 */ &&fd_default, &&fd_JP_IXY, &&fd_default, &&fd_default,
+  /* EC */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* F0 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* F4 */ &&fd_default, &&fd_default, &&fd_default, &&fd_default,
+  /* F8 */ &&fd_default, &&fd_LD_SP_IXY, &&fd_default, &&fd_default,
+  /* FC */ &&fd_default, &&fd_default, &&fd_default, &&fd_default
+};
@@ -22,29 +22,209 @@
  Copyright (c) 1999-2006 Philip Kendall
  ======================================================================*/
 
+/* opcode dispatch: the opcode files use OPCODE(name) for their case
+   labels, NEXT to end a handler and OPCODE_SWITCH() for their switch.
+   With GCC each handler becomes a label and NEXT runs the end-of-opcode
+   work and fetches and jumps to the next handler through the label
+   tables in z80_dispatch.h (Z80_NEXT_OPCODE is set up in z80.c). Other
+   compilers get the plain switch.
+   It is the default for GCC on ARM, where the single indirect jump of
+   the switch mispredicts on almost every instruction. Hosts with a good
+   indirect branch predictor run the switch about as fast or faster, so
+   there it has to be asked for with -DZ80_THREADED (and can be turned
+   off anywhere with -DZ80_NO_THREADED). */
+
+#if defined(__GNUC__) && defined(__arm__) && !defined(Z80_NO_THREADED)
+#define Z80_THREADED
+#endif
+#if defined(Z80_THREADED) && (!defined(__GNUC__) || defined(Z80_NO_THREADED))
+#undef Z80_THREADED
+#endif
+
+#define Z80_LABEL_(prefix,name)  prefix##name
+#define Z80_LABEL(prefix,name)   Z80_LABEL_(prefix,name)
+
+#ifdef Z80_THREADED
+#define OPCODE(name)             Z80_LABEL(OP_PREFIX,_##name):
+#define OPCODE_DEFAULT           Z80_LABEL(OP_PREFIX,_default): __attribute__((unused));
+#define OPCODE_SWITCH(op)        goto *Z80_LABEL(OP_PREFIX,_table)[op];
+#define NEXT                     Z80_NEXT_OPCODE
+#else
+#define OPCODE(name)             case name:
+#define OPCODE_DEFAULT           default:
+#define OPCODE_SWITCH(op)        switch (op)
+#define NEXT                     break
+#endif
+
+/* block instructions (LDIR, CPIR, INIR, OTIR and the decrementing ones):
+   instead of rewinding PC and going round the main loop for every
+   iteration, REPEAT_BLOCK() jumps straight back to the REPEAT_LABEL() at
+   the top of the handler when the core says nothing would happen in
+   between (Z80_CAN_REPEAT, set up in z80.c next to Z80_FETCH) and the
+   last iteration didn't overwrite the instruction. ED and the opcode are
+   refetched as usual, so ICount, contention and R come out the same. */
+#define REPEAT_LABEL(name)   Z80_LABEL(OP_PREFIX,_##name##_repeat):
+#define REPEAT_BLOCK(name) \
+                 if (Z80_CAN_REPEAT && \
+                     Z80ReadMem_notiming (r_PC) == 0xED && \
+                     Z80ReadMem_notiming ((word) (r_PC + 1)) == opcode) \
+                   { \
+                   Z80_FETCH \
+                   AddR (1); \
+                   opcode = READ_MEM (r_PC); \
+                   CONTENDED (AddCycles (1)); \
+                   r_PC++; \
+                   goto Z80_LABEL(OP_PREFIX,_##name##_repeat); \
+                   }
+
+/* LDIR/LDDR and CPIR/CPDR first run as many iterations as come before
+   the end of the slice or the next frame event in one go: 21 T-states
+   and R + 2 each, HL, DE and BC moved once. Z80BlockCount() in z80.c
+   says how many; it leaves the last one, anything near the screen or
+   the instruction itself and contended pages (in Z80Run) to the
+   iteration-by-iteration path below the batch. The flags are left as
+   they are, that iteration sets them. */
+#define BLOCK_BATCH_LD(step) \
+                 tempdword = Z80BlockCount (r_PC, r_HL, r_DE, r_BC, r_ICount, \
+                                            BLOCK_FLOOR (), step, 1, \
+                                            BLOCK_TIMED); \
+                 if (tempdword) \
+                   { \
+                   byte *src_ = MEMr[r_HL >> 14] + r_HL; \
+                   byte *dst_ = MEMw[r_DE >> 14] + r_DE; \
+                   ram_written |= RAM_WRITTEN (dst_); \
+                   for (tempword = tempdword; tempword; tempword--) \
+                     { \
+                     *dst_ = *src_; \
+                     dst_ += step; src_ += step; \
+                     } \
+                   BLOCK_CHARGE (step, step); \
+                   }
+
+#define BLOCK_BATCH_CP(step) \
+                 tempdword = Z80BlockCount (r_PC, r_HL, r_DE, r_BC, r_ICount, \
+                                            BLOCK_FLOOR (), step, 0, \
+                                            BLOCK_TIMED); \
+                 if (tempdword) \
+                   { \
+                   const byte *src_ = MEMr[r_HL >> 14] + r_HL; \
+                   for (tempword = 0; tempword < tempdword; tempword++) \
+                     { \
+                     if (*src_ == r_A) break; \
+                     src_ += step; \
+                     } \
+                   tempdword = tempword; \
+                   BLOCK_CHARGE (step, 0); \
+                   }
+
+#define BLOCK_CHARGE(hl,de) \
+                 r_HL += (hl) * (int) tempdword; \
+                 r_DE += (de) * (int) tempdword; \
+                 r_BC -= tempdword; \
+                 r_ICount -= 21 * tempdword; \
+                 AddR (2 * tempdword) \
+                 PROFILE_OPCODES (Z80_CORE, tempdword);
+
+#define BLOCK_FLOOR()        Z80_POLICY_X(BLOCK_FLOOR,Z80_POLICY)()
+#define BLOCK_TIMED          Z80_POLICY_X(BLOCK_TIMED,Z80_POLICY)
+#define BLOCK_FLOOR_C()      (regs->dobreak ? r_ICount : loop) /* Z80_TRAP */
+#define BLOCK_TIMED_C        1
+#define BLOCK_FLOOR_NC()     (r_ICount > regs->IIntTime ? r_ICount : \
+                              loop > 0 ? loop : 0)
+#define BLOCK_TIMED_NC       0
+
+/* contention policy: the opcode files and the macros below are shared
+   by all the cores, and z80.c picks what they compile to by defining
+   Z80_POLICY before including them:
+     C   memory accesses are timed and contended one by one (Z80Run);
+         the contend_* calls wrapped in CONTENDED() are kept.
+     NC  untimed accesses, and each instruction charges its T-states in
+         one go with the AddCycles() wrapped in UNCONTENDED().
+   A new kind of core only needs its own set of the _<policy> macros. */
+
+#define Z80_POLICY_(name,policy)   name##_##policy
+#define Z80_POLICY_X(name,policy)  Z80_POLICY_(name,policy)
+
+#define READ_MEM(addr)       Z80_POLICY_X(READ_MEM,Z80_POLICY)(addr)
+#define WRITE_MEM(addr,val)  Z80_POLICY_X(WRITE_MEM,Z80_POLICY)(addr,val)
+#define CONTENDED(x)         Z80_POLICY_X(CONTENDED,Z80_POLICY)(x)
+#define UNCONTENDED(x)       Z80_POLICY_X(UNCONTENDED,Z80_POLICY)(x)
+
+#define READ_MEM_C(addr)       Z80ReadMem(addr)
+#define WRITE_MEM_C(addr,val)  Z80WriteMem(addr,val,regs)
+#define CONTENDED_C(x)         x
+#define UNCONTENDED_C(x)
+
+#define READ_MEM_NC(addr)      Z80ReadMem_notiming(addr)
+#define WRITE_MEM_NC(addr,val) Z80WriteMem_uncontended(addr,val,&r_ICount)
+#define CONTENDED_NC(x)
+#define UNCONTENDED_NC(x)      x
+
+/* register file: PC, SP, AF, BC, DE, HL and ICount go through
+   Z80_PAIR()/r_ICount, which z80.c points either at the Z80Regs
+   structure (Z80_REGFILE MEM) or, with -DZ80_LOCAL_REGS, at locals of
+   the running core (Z80_REGFILE LOCAL) that are spilled back around
+   anything that looks at spectrumZ80 (Z80_SPILL/Z80_RELOAD).
+   With lazy flags AF stays in the structure, Z80Flags() works on it.
+   LOCAL is not a speed-up on x86-64: it measured flat for Z80Run and
+   about 15% slower for Z80Run_NCNI, as GCC keeps the eword unions on
+   the stack anyway. It is there for trying on the ARM targets. */
+
+#define Z80_PAIR(rr)         Z80_POLICY_X(Z80_PAIR_##rr,Z80_REGFILE)
+#define r_ICount             Z80_POLICY_X(Z80_ICOUNT,Z80_REGFILE)
+
+#define Z80_PAIR_PC_MEM      regs->PC
+#define Z80_PAIR_SP_MEM      regs->SP
+#define Z80_PAIR_AF_MEM      regs->AF
+#define Z80_PAIR_BC_MEM      regs->BC
+#define Z80_PAIR_DE_MEM      regs->DE
+#define Z80_PAIR_HL_MEM      regs->HL
+#define Z80_ICOUNT_MEM       regs->ICount
+
+#define Z80_PAIR_PC_LOCAL    l_PC
+#define Z80_PAIR_SP_LOCAL    l_SP
+#ifndef Z80_LAZY_FLAGS
+#define Z80_PAIR_AF_LOCAL    l_AF
+#else
+#define Z80_PAIR_AF_LOCAL    regs->AF
+#endif
+#define Z80_PAIR_BC_LOCAL    l_BC
+#define Z80_PAIR_DE_LOCAL    l_DE
+#define Z80_PAIR_HL_LOCAL    l_HL
+#define Z80_ICOUNT_LOCAL     l_ICount
+
 /* defines for the registers: faster access to them when coding... */
 
-#define   r_PC    regs->PC.W
-#define   r_PCl   regs->PC.B.l
-#define   r_PCh   regs->PC.B.h
-#define   r_SP    regs->SP.W
+#define   r_PC    Z80_PAIR(PC).W
+#define   r_PCl   Z80_PAIR(PC).B.l
+#define   r_PCh   Z80_PAIR(PC).B.h
+#define   r_SP    Z80_PAIR(SP).W
 #define   r_IFF1  regs->IFF1
 #define   r_IFF2  regs->IFF2
 #define   r_R     regs->R
 #define   r_R7    regs->R7
 
-#define   r_AF    regs->AF.W
+/* with -DZ80_LAZY_FLAGS the 8 bit ADD, ADC, SUB, SBC and CP leave F
+   pending (see the *_FLAGS macros below) and every use of F or AF goes
+   through Z80Flags() in z80.c, which works it out when it's needed */
+#ifndef Z80_LAZY_FLAGS
+#define   r_AF    Z80_PAIR(AF).W
+#define   r_A     Z80_PAIR(AF).B.h
+#define   r_F     Z80_PAIR(AF).B.l
+#else
+#define   r_AF    (Z80Flags (regs), regs)->AF.W
 #define   r_A     regs->AF.B.h
-#define   r_F     regs->AF.B.l
-#define   r_BC    regs->BC.W
-#define   r_B     regs->BC.B.h
-#define   r_C     regs->BC.B.l
-#define   r_DE    regs->DE.W
-#define   r_D     regs->DE.B.h
-#define   r_E     regs->DE.B.l
-#define   r_HL    regs->HL.W
-#define   r_H     regs->HL.B.h
-#define   r_L     regs->HL.B.l
+#define   r_F     (Z80Flags (regs), regs)->AF.B.l
+#endif
+#define   r_BC    Z80_PAIR(BC).W
+#define   r_B     Z80_PAIR(BC).B.h
+#define   r_C     Z80_PAIR(BC).B.l
+#define   r_DE    Z80_PAIR(DE).W
+#define   r_D     Z80_PAIR(DE).B.h
+#define   r_E     Z80_PAIR(DE).B.l
+#define   r_HL    Z80_PAIR(HL).W
+#define   r_H     Z80_PAIR(HL).B.h
+#define   r_L     Z80_PAIR(HL).B.l
 #define   r_IX    regs->IX.W
 #define   r_IXh   regs->IX.B.h
 #define   r_IXl   regs->IX.B.l
@@ -103,9 +283,9 @@
 //#define Z80ReadMem(A)   ((regs->RAM[(A)]))
 
 /* macros to change the ICount register */
-#define AddCycles(n) { regs->ICount-=(n); }
+#define AddCycles(n) { r_ICount-=(n); }
 
-#define SubCycles(n) regs->ICount+=(n)
+#define SubCycles(n) r_ICount+=(n)
 
 //#define AddR(n) r_R = (r_R+(n))
 #define AddR(n) r_R = r_R + n;
@@ -124,110 +304,57 @@
 
 /* store a given register in the stack (hi and lo bytes) */
 #define PUSH(rreg)                              \
-  Z80WriteMem( --(r_SP), regs->rreg.B.h, regs); \
-  Z80WriteMem( --(r_SP), regs->rreg.B.l, regs)
+  WRITE_MEM( --(r_SP), Z80_PAIR(rreg).B.h); \
+  WRITE_MEM( --(r_SP), Z80_PAIR(rreg).B.l)
 
-#define PUSH_NC(rreg)                              \
-  Z80WriteMem_notiming( --(r_SP), regs->rreg.B.h); \
-  Z80WriteMem_notiming( --(r_SP), regs->rreg.B.l)
-  
 #define POP(rreg)\
-  regs->rreg.B.l = Z80ReadMem(r_SP);r_SP++;\
-  regs->rreg.B.h = Z80ReadMem(r_SP);r_SP++
-
-#define POP_NC(rreg)\
-  regs->rreg.B.l = Z80ReadMem_notiming(r_SP);r_SP++;\
-  regs->rreg.B.h = Z80ReadMem_notiming(r_SP);r_SP++
+  Z80_PAIR(rreg).B.l = READ_MEM(r_SP);r_SP++;\
+  Z80_PAIR(rreg).B.h = READ_MEM(r_SP);r_SP++
 
 #define PUSH_IXYr() \
-  Z80WriteMem( --(r_SP), REGH, regs); \
-  Z80WriteMem( --(r_SP), REGL, regs)
-
-#define PUSH_IXYr_NC() \
-  Z80WriteMem_notiming( --(r_SP), REGH); \
-  Z80WriteMem_notiming( --(r_SP), REGL)
+  WRITE_MEM( --(r_SP), REGH); \
+  WRITE_MEM( --(r_SP), REGL)
 
 #define POP_IXYr()\
-  REGL = Z80ReadMem(r_SP);r_SP++; \
-  REGH = Z80ReadMem(r_SP);r_SP++
-
-#define POP_IXYr_NC()\
-  REGL = Z80ReadMem_notiming(r_SP);r_SP++; \
-  REGH = Z80ReadMem_notiming(r_SP);r_SP++
+  REGL = READ_MEM(r_SP);r_SP++; \
+  REGH = READ_MEM(r_SP);r_SP++
 
 #define RST(rstval)  PUSH(PC); r_PC=(rstval)
 
-#define RST_NC(rstval)  PUSH_NC(PC); r_PC=(rstval)
-
 /*--- Move data to mem or regs --------------------------------------*/
 #define LD_r_r(dreg, sreg)  (dreg) = (sreg)
 
-#define STORE_r(daddreg, sreg)  Z80WriteMem((daddreg), (sreg), regs);
-
-#define STORE_r_NC(daddreg, sreg)  Z80WriteMem_notiming((daddreg), (sreg));
-
+#define STORE_r(daddreg, sreg)  WRITE_MEM((daddreg), (sreg));
 
 #define STORE_nn_rr(dreg) \
-                        r_opl = Z80ReadMem(r_PC);r_PC++;\
-                        r_oph = Z80ReadMem(r_PC);r_PC++;\
+                        r_opl = READ_MEM(r_PC);r_PC++;\
+                        r_oph = READ_MEM(r_PC);r_PC++;\
                         r_tmp = dreg; \
-                        Z80WriteMem((r_op),r_tmpl, regs); \
-                        Z80WriteMem((r_op+1),r_tmph, regs);
-
-
-#define STORE_nn_rr_NC(dreg) \
-                        r_opl = Z80ReadMem_notiming(r_PC);r_PC++;\
-                        r_oph = Z80ReadMem_notiming(r_PC);r_PC++;\
-                        r_tmp = dreg; \
-                        Z80WriteMem_notiming((r_op),r_tmpl); \
-                        Z80WriteMem_notiming((r_op+1),r_tmph);
+                        WRITE_MEM((r_op),r_tmpl); \
+                        WRITE_MEM((r_op+1),r_tmph);
 
 
 #define STORE_nn_r(sreg) \
-                        r_opl = Z80ReadMem(r_PC); r_PC++; \
-                        r_oph = Z80ReadMem(r_PC); r_PC++; \
-                        Z80WriteMem((r_op),(sreg), regs);
+                        r_opl = READ_MEM(r_PC); r_PC++; \
+                        r_oph = READ_MEM(r_PC); r_PC++; \
+                        WRITE_MEM((r_op),(sreg));
                         
-#define STORE_nn_r_NC(sreg) \
-                        r_opl = Z80ReadMem_notiming(r_PC); r_PC++; \
-                        r_oph = Z80ReadMem_notiming(r_PC); r_PC++; \
-                        Z80WriteMem_notiming((r_op),(sreg));
-
-#define LOAD_r(dreg, saddreg)   (dreg)=Z80ReadMem((saddreg))
-
-#define LOAD_r_NC(dreg, saddreg)   (dreg)=Z80ReadMem_notiming((saddreg))
+#define LOAD_r(dreg, saddreg)   (dreg)=READ_MEM((saddreg))
 
-
-#define LOAD_rr_nn(dreg)   r_opl = Z80ReadMem(r_PC); r_PC++; \
-                           r_oph = Z80ReadMem(r_PC); r_PC++; \
-                           r_tmpl = Z80ReadMem(r_op); \
-                           r_tmph = Z80ReadMem((r_op)+1);\
-                           dreg=r_tmp
-
-#define LOAD_rr_nn_NC(dreg)   r_opl = Z80ReadMem_notiming(r_PC); r_PC++; \
-                           r_oph = Z80ReadMem_notiming(r_PC); r_PC++; \
-                           r_tmpl = Z80ReadMem_notiming(r_op); \
-                           r_tmph = Z80ReadMem_notiming((r_op)+1);\
+#define LOAD_rr_nn(dreg)   r_opl = READ_MEM(r_PC); r_PC++; \
+                           r_oph = READ_MEM(r_PC); r_PC++; \
+                           r_tmpl = READ_MEM(r_op); \
+                           r_tmph = READ_MEM((r_op)+1);\
                            dreg=r_tmp
 
-#define LOAD_r_nn(dreg)    r_opl = Z80ReadMem(r_PC); r_PC++; \
-                           r_oph = Z80ReadMem(r_PC); r_PC++; \
-                           dreg = Z80ReadMem(r_op);
-
-#define LOAD_r_nn_NC(dreg)    r_opl = Z80ReadMem_notiming(r_PC); r_PC++; \
-                           r_oph = Z80ReadMem_notiming(r_PC); r_PC++; \
-                           dreg = Z80ReadMem_notiming(r_op);
-
-#define LD_r_n(reg) (reg) = Z80ReadMem(r_PC++);
+#define LOAD_r_nn(dreg)    r_opl = READ_MEM(r_PC); r_PC++; \
+                           r_oph = READ_MEM(r_PC); r_PC++; \
+                           dreg = READ_MEM(r_op);
 
-#define LD_r_n_NC(reg) (reg) = Z80ReadMem_notiming(r_PC++);
+#define LD_r_n(reg) (reg) = READ_MEM(r_PC++);
 
-#define LD_rr_nn(reg)   r_opl = Z80ReadMem(r_PC); r_PC++; \
-                        r_oph = Z80ReadMem(r_PC); r_PC++; \
-                        reg = r_op
-
-#define LD_rr_nn_NC(reg)   r_opl = Z80ReadMem_notiming(r_PC); r_PC++; \
-                        r_oph = Z80ReadMem_notiming(r_PC); r_PC++; \
+#define LD_rr_nn(reg)   r_opl = READ_MEM(r_PC); r_PC++; \
+                        r_oph = READ_MEM(r_PC); r_PC++; \
                         reg = r_op
 
 #define EX(reg1,reg2)        r_opl=(reg1); (reg1)=(reg2); (reg2)=r_opl
@@ -256,33 +383,19 @@
 
 #define BIT_SET(b,reg) reg |= (0x1<<b)
 
-#define BIT_mem_RES(b,addr) r_opl = Z80ReadMem(addr);\
-                            r_opl &= ~(0x1<<b);contend_read(addr);       \
-                            Z80WriteMem(addr, r_opl, regs)
-
-#define BIT_mem_RES_NC(b,addr) r_opl = Z80ReadMem_notiming(addr);	\
-                            r_opl &= ~(0x1<<b);			       	\
-                            Z80WriteMem_notiming(addr, r_opl)
+#define BIT_mem_RES(b,addr) r_opl = READ_MEM(addr);\
+                            r_opl &= ~(0x1<<b);CONTENDED(contend_read(addr));       \
+                            WRITE_MEM(addr, r_opl)
 
-#define BIT_mem_SET(b,addr) r_opl = Z80ReadMem(addr); \
-                            r_opl |= (0x1<<b);contend_read(addr);        \
-                            Z80WriteMem(addr, r_opl, regs)
-
-#define BIT_mem_SET_NC(b,addr) r_opl = Z80ReadMem_notiming(addr); 	\
-                            r_opl |= (0x1<<b);		        \
-                            Z80WriteMem_notiming(addr, r_opl)
+#define BIT_mem_SET(b,addr) r_opl = READ_MEM(addr); \
+                            r_opl |= (0x1<<b);CONTENDED(contend_read(addr));        \
+                            WRITE_MEM(addr, r_opl)
 
 #define BIT_RES_mem(b,addr,reg)  reg &= ~(0x1<<b);    \
-                                 Z80WriteMem((addr), (reg), regs)
+                                 WRITE_MEM((addr), (reg))
                                  
-#define BIT_RES_mem_NC(b,addr,reg)  reg &= ~(0x1<<b);    \
-                                 Z80WriteMem_notiming((addr), (reg))
-
 #define BIT_SET_mem(b,addr,reg) reg |= (0x1<<b);        \
-                                Z80WriteMem((addr), (reg), regs)
-
-#define BIT_SET_mem_NC(b,addr,reg) reg |= (0x1<<b);        \
-                                Z80WriteMem_notiming((addr), (reg))
+                                WRITE_MEM((addr), (reg))
 
 #define BIT_BIT(b,reg)     r_F = ( r_F & FLAG_C ) | \
                            ( (reg) & ( FLAG_3 | FLAG_5 ) ) |\
@@ -294,12 +407,7 @@
                            (((reg) & ( 0x01 << b ) ) ? FLAG_H : \
                            (FLAG_P|FLAG_H|FLAG_Z ) )
 
-#define BIT_mem_BIT(b,reg)  r_opl = Z80ReadMem(reg); \
-                            r_F = ( r_F & FLAG_C ) | \
-                            (((r_opl) & ( 0x01 << b ) ) ? FLAG_H : \
-                            (FLAG_P|FLAG_H|FLAG_Z ) )
-
-#define BIT_mem_BIT_NC(b,reg)  r_opl = Z80ReadMem_notiming(reg); \
+#define BIT_mem_BIT(b,reg)  r_opl = READ_MEM(reg); \
                             r_F = ( r_F & FLAG_C ) | \
                             (((r_opl) & ( 0x01 << b ) ) ? FLAG_H : \
                             (FLAG_P|FLAG_H|FLAG_Z ) )
@@ -315,17 +423,12 @@
                          (((reg) & 0x80 ) ? ( FLAG_H | FLAG_S ) :\
                          ( FLAG_P | FLAG_H | FLAG_Z ) )
 
-#define BIT_mem_BIT7(reg)    r_opl = Z80ReadMem(reg); \
+#define BIT_mem_BIT7(reg)    r_opl = READ_MEM(reg); \
                          r_F = ( r_F & FLAG_C ) | \
                          (((r_opl) & 0x80 ) ? ( FLAG_H | FLAG_S ) :\
                          ( FLAG_P | FLAG_H | FLAG_Z ) )
 
 
-#define BIT_mem_BIT7_NC(reg)    r_opl = Z80ReadMem_notiming(reg); \
-                         r_F = ( r_F & FLAG_C ) | \
-                         (((r_opl) & 0x80 ) ? ( FLAG_H | FLAG_S ) :\
-                         ( FLAG_P | FLAG_H | FLAG_Z ) )
-
 #define RLC(reg)  (reg) = ( (reg)<<1 ) | ( (reg)>>7 );          \
                   r_F = ( (reg) & FLAG_C ) | sz53p_table[(reg)]
 
@@ -360,40 +463,69 @@
 
 
 /*--- JP operations -------------------------------------------------*/
-#define JP_nn()  r_opl = Z80ReadMem(r_PC); \
+#define JP_nn()  r_opl = READ_MEM(r_PC); \
                  r_PC++;                   \
-                 r_oph = Z80ReadMem(r_PC); \
+                 r_oph = READ_MEM(r_PC); \
                  r_PC = r_op
 
-#define JP_nn_NC()  r_opl = Z80ReadMem_notiming(r_PC); \
-                 r_PC++;                   \
-                 r_oph = Z80ReadMem_notiming(r_PC); \
-                 r_PC = r_op
-
-#define JR_n()   r_PC += (offset) (Z80ReadMem(r_PC));contend_read_x5(r_PC); r_PC++;
+#define JR_n()   r_PC += (offset) (READ_MEM(r_PC));CONTENDED(contend_read_x5(r_PC)); r_PC++;
 
-#define JR_n_NC()   r_PC += (offset) (Z80ReadMem_notiming(r_PC));r_PC++;
+/* step over an operand byte that isn't used (condition not met) */
+#define SKIP_BYTE()  CONTENDED(contend_read_jr()); UNCONTENDED(r_PC++)
 
-#define RET_nn()   r_PCl = Z80ReadMem (r_SP);r_SP++; \
-                   r_PCh = Z80ReadMem (r_SP);r_SP++;
+#define RET_nn()   r_PCl = READ_MEM(r_SP);r_SP++; \
+                   r_PCh = READ_MEM(r_SP);r_SP++;
                    
-#define RET_nn_NC()   r_PCl = Z80ReadMem_notiming (r_SP);r_SP++; \
-                   r_PCh = Z80ReadMem_notiming (r_SP);r_SP++;
-
-#define CALL_nn()  r_opl = Z80ReadMem (r_PC); r_PC++; \
-                   r_oph = Z80ReadMem (r_PC); contend_read(r_PC); r_PC++; \
-                   Z80WriteMem( --(r_SP), r_PCh, regs ); \
-                   Z80WriteMem( --(r_SP), r_PCl, regs ); \
+#define CALL_nn()  r_opl = READ_MEM(r_PC); r_PC++; \
+                   r_oph = READ_MEM(r_PC); CONTENDED(contend_read(r_PC)); r_PC++; \
+                   WRITE_MEM( --(r_SP), r_PCh); \
+                   WRITE_MEM( --(r_SP), r_PCl); \
                    r_PC = r_op
 
-#define CALL_nn_NC()  r_opl = Z80ReadMem_notiming (r_PC); r_PC++; \
-                   r_oph = Z80ReadMem_notiming (r_PC); r_PC++; \
-                   Z80WriteMem_notiming( --(r_SP), r_PCh); \
-                   Z80WriteMem_notiming( --(r_SP), r_PCl); \
-                   r_PC = r_op
+/*--- ALU operations ------------------------------------------------*/
 
+/* F after an 8 bit add/subtract, from the 9 bit result in tempword and
+   the half carry/overflow hash in r_oph (add) or r_opl (subtract). The
+   lazy flags build only notes them down for Z80Flags(). */
+#ifndef Z80_LAZY_FLAGS
+#define ADD_FLAGS()  r_F = ( tempword & 0x100 ? FLAG_C : 0 ) |     \
+                     halfcarry_add_table[r_oph & 0x07] |           \
+                     overflow_add_table[r_oph >> 4] |              \
+                     sz53_table[r_A]
+
+#define SUB_FLAGS()  r_F = ( tempword & 0x100 ? FLAG_C : 0 ) | FLAG_N | \
+                     halfcarry_sub_table[r_opl & 0x07] |           \
+                     overflow_sub_table[r_opl >> 4] |              \
+                     sz53_table[r_A]
+
+#define CP_FLAGS(value) \
+  r_F = ( tempword & 0x100 ? FLAG_C : ( tempword ? 0 : FLAG_Z ) ) | FLAG_N |\
+  halfcarry_sub_table[r_opl & 0x07] |                                  \
+  overflow_sub_table[r_opl >> 4] |                                     \
+  ( value & ( FLAG_3 | FLAG_5 ) ) |                                     \
+  ( tempword & FLAG_S )
+
+#define FLAGS_SYNC()
+#else
+#define LAZY_ADD  1
+#define LAZY_SUB  2
+#define LAZY_CP   3
+
+#define ADD_FLAGS()  regs->lazy_res = tempword; regs->lazy_idx = r_oph; \
+                     regs->lazy_op = LAZY_ADD
+
+#define SUB_FLAGS()  regs->lazy_res = tempword; regs->lazy_idx = r_opl; \
+                     regs->lazy_op = LAZY_SUB
+
+#define CP_FLAGS(value) \
+                     regs->lazy_res = tempword; regs->lazy_idx = r_opl; \
+                     regs->lazy_val = (value); regs->lazy_op = LAZY_CP
+
+/* for code that gets at F without r_F: PUSH/POP AF and calls out of
+   the core */
+#define FLAGS_SYNC() Z80Flags (regs)
+#endif
 
-/*--- ALU operations ------------------------------------------------*/
 #define AND(reg)     r_A &= (reg); \
                      r_F = FLAG_H | sz53p_table[r_A]
 
@@ -403,27 +535,15 @@
 #define XOR(reg)     r_A ^= (reg); \
                      r_F = sz53p_table[r_A]
 
-#define AND_mem(raddress)     r_opl = Z80ReadMem(raddress); \
+#define AND_mem(raddress)     r_opl = READ_MEM(raddress); \
                               r_A &= (r_opl);              \
                               r_F = FLAG_H | sz53p_table[r_A]
 
-#define AND_mem_NC(raddress)     r_opl = Z80ReadMem_notiming(raddress); \
-                              r_A &= (r_opl);              \
-                              r_F = FLAG_H | sz53p_table[r_A]
-
-#define OR_mem(raddress)      r_opl = Z80ReadMem(raddress); \
-                              r_A |= (r_opl);               \
-                              r_F = sz53p_table[r_A]
-
-#define OR_mem_NC(raddress)      r_opl = Z80ReadMem_notiming(raddress); \
+#define OR_mem(raddress)      r_opl = READ_MEM(raddress); \
                               r_A |= (r_opl);               \
                               r_F = sz53p_table[r_A]
 
-#define XOR_mem(raddress)     r_opl = Z80ReadMem(raddress); \
-                              r_A ^= (r_opl);               \
-                              r_F = sz53p_table[r_A]
-
-#define XOR_mem_NC(raddress)     r_opl = Z80ReadMem_notiming(raddress); \
+#define XOR_mem(raddress)     r_opl = READ_MEM(raddress); \
                               r_A ^= (r_opl);               \
                               r_F = sz53p_table[r_A]
 
@@ -431,10 +551,7 @@
                    r_oph = ((r_A&0x88)>>3)|(((val)&0x88)>>2) | \
                    ( (tempword & 0x88) >> 1 );                \
                    r_A = tempword;                            \
-                   r_F = ( tempword & 0x100 ? FLAG_C : 0 ) |  \
-                   halfcarry_add_table[ r_oph & 0x07] |        \
-                   overflow_add_table[ r_oph >> 4] |           \
-                   sz53_table[r_A]
+                   ADD_FLAGS()
 
 #define ADD_WORD(value1,value2)                                   \
                    tempdword = (value1) + (value2);               \
@@ -452,10 +569,7 @@
             r_oph = ( (r_A & 0x88) >> 3 ) | ( ( (value) & 0x88 ) >> 2 ) |\
                    ( (tempword & 0x88) >> 1 );                       \
                     r_A = tempword;                                  \
-                    r_F = ( tempword & 0x100 ? FLAG_C : 0 ) |        \
-                   halfcarry_add_table[r_oph & 0x07] |            \
-                   overflow_add_table[r_oph >> 4] |               \
-                   sz53_table[r_A]
+                   ADD_FLAGS()
 
 #define ADC_WORD(value)                                            \
               tempdword= r_HL + (value) + ( r_F & FLAG_C );            \
@@ -475,10 +589,7 @@
               ( ( (value) & 0x88 ) >> 2 ) |                        \
               ( (tempword & 0x88) >> 1 );                             \
               r_A = tempword;                                         \
-              r_F = ( tempword & 0x100 ? FLAG_C : 0 ) | FLAG_N |      \
-              halfcarry_sub_table[r_opl & 0x07] |                 \
-              overflow_sub_table[r_opl >> 4] |                    \
-              sz53_table[r_A]
+              SUB_FLAGS()
 
 #define SBC(value)                                                 \
               tempword = r_A - (value) - ( r_F & FLAG_C );            \
@@ -486,10 +597,7 @@
               ( ( (value) & 0x88 ) >> 2 ) |                        \
               ( (tempword & 0x88) >> 1 );                             \
               r_A = tempword;                                         \
-              r_F = ( tempword & 0x100 ? FLAG_C : 0 ) | FLAG_N |      \
-              halfcarry_sub_table[r_opl & 0x07] |                 \
-              overflow_sub_table[r_opl >> 4] |                    \
-              sz53_table[r_A]
+              SUB_FLAGS()
 
 
 #define SBC_WORD(Rg)      \
@@ -507,18 +615,14 @@
   tempword = r_A - (value);\
   r_opl = ( (r_A & 0x88) >> 3 ) | ( ( (value) & 0x88 ) >> 2 ) |        \
        ( (tempword & 0x88) >> 1 );                                        \
-  r_F = ( tempword & 0x100 ? FLAG_C : ( tempword ? 0 : FLAG_Z ) ) | FLAG_N |\
-  halfcarry_sub_table[r_opl & 0x07] |                                  \
-  overflow_sub_table[r_opl >> 4] |                                     \
-  ( value & ( FLAG_3 | FLAG_5 ) ) |                                     \
-  ( tempword & FLAG_S )
+  CP_FLAGS(value)
 
 #define NEG_A()  r_opl = r_A; r_A=0; SUB(r_opl)
 
 /*--- MISC operations -----------------------------------------------*/
 #define IN_PORT(reg,port)    \
-                 ula_contend_port_early(port); \
-                 ula_contend_port_late(port); \
+                 CONTENDED(ula_contend_port_early(port)); \
+                 CONTENDED(ula_contend_port_late(port)); \
                  reg=Z80InPort(regs,port);  \
                  if( ( port & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) ) \
                         {  \
@@ -526,10 +630,65 @@
                         } \
                  r_F = ( r_F & FLAG_C) | sz53p_table[(reg)];
 
-#define IN_PORT_NC(reg,port)    \
-                 reg=Z80InPort(regs,port);  \
-                 if( ( port & 0x8002 ) == 0 && ( model == ZX_128 || model == ZX_128_USR0 || model == ZX_PLUS2 ) ) \
-                        {  \
-                        Z80OutPort(regs, 0x7ffd, reg ); \
-                        } \
-                 r_F = ( r_F & FLAG_C) | sz53p_table[(reg)];
+/* HALT: rather than fetching the HALT again every 4 T-states, do all
+   the refetches up to the point where the loop would stop or its end
+   of instruction checks would do something (frame wrap, interrupt
+   window) in one go. The contended core still charges the contention
+   of every refetch if the HALT sits in contended memory. */
+#define HALT_FAST_FORWARD()  Z80_POLICY_X(HALT_FAST_FORWARD,Z80_POLICY)()
+
+#define HALT_FAST_FORWARD_C() \
+                 if (r_ICount > loop) \
+                   { \
+                   if (MEMc[(word) (r_PC - 1) >> 14]) \
+                     while (r_ICount > loop) \
+                       { \
+                       r_ICount -= cycles_delay (r_ICount) + 4; \
+                       AddR (1) \
+                       } \
+                   else \
+                     { \
+                     tempdword = (r_ICount - loop + 3) >> 2; \
+                     r_ICount -= tempdword << 2; \
+                     AddR (tempdword) \
+                     } \
+                   }
+
+#define HALT_FAST_FORWARD_NC() \
+                 if (r_ICount <= regs->IIntTime && \
+                     r_ICount > loop && r_ICount > 0) \
+                   { \
+                   tempdword = (r_ICount - (loop > 0 ? loop : 0) + 3) >> 2; \
+                   r_ICount -= tempdword << 2; \
+                   AddR (tempdword) \
+                   }
+
+/* Idle loops: a taken JR/JP back over a few instructions that only read
+   memory, the keyboard or the joystick (LD A,(nn) / CP / JR Z or IN A,(FE)
+   / AND / JR NZ) will keep going round the same way once the registers
+   come back unchanged, until an interrupt, the end of the slice or the
+   tape changes something. Z80IdleLoop() in z80.c checks the loop body and
+   tells how many of those identical iterations can be charged in one go.
+   Used right before the jump is taken, so r_PC - 1 is the jump opcode.
+   The contended core would have to time every read, so it doesn't skip. */
+#define IDLE_LOOP_SKIP()  Z80_POLICY_X(IDLE_LOOP_SKIP,Z80_POLICY)()
+
+#define IDLE_LOOP_SKIP_C()
+
+#define IDLE_LOOP_SKIP_NC() \
+                 if (idle_loop.pc == r_PC && idle_loop.af == r_AF && \
+                     idle_loop.bc == r_BC && idle_loop.de == r_DE && \
+                     idle_loop.hl == r_HL && idle_loop.sp == r_SP) \
+                   { \
+                   tempdword = Z80IdleLoop (regs, r_PC - 1, r_ICount, loop); \
+                   r_ICount -= tempdword * idle_loop.tstates; \
+                   AddR (tempdword * idle_loop.fetches) \
+                   } \
+                 idle_loop.pc = r_PC; idle_loop.af = r_AF; \
+                 idle_loop.bc = r_BC; idle_loop.de = r_DE; \
+                 idle_loop.hl = r_HL; idle_loop.sp = r_SP; \
+                 idle_loop.icount = r_ICount;
+
+/* forget the last iteration, a new slice or an interrupt may have changed
+   what the loop reads: no loop takes that long */
+#define IDLE_LOOP_RESET()  idle_loop.icount = -0x40000000
@@ -130,8 +130,8 @@ fdc_cmd_table_def fdc_cmd_table[MAX_CMD_COUNT] = {
    {0x5d, 9, 7, CPU_TO_FDC, fdc_scan},    // scan high or equal
 };
 
-/*extern*/ t_drive driveA;
-/*extern*/ t_drive driveB;
+static t_drive first_drives[2];
+t_drive *fdc_drives = first_drives;
 t_drive *active_drive; // reference to the currently selected drive
 t_track *active_track; // reference to the currently selected track, of the active_drive
 #undef dword
@@ -139,6 +139,19 @@ t_track *active_track; // reference to the currently selected track, of the acti
 
 dword read_status_delay = 0;
 
+/* the +3 disk controller of the selected machine, see ZX_SelectMachine;
+   its drives are in the machine's own memory, like the DSK their tracks
+   point into */
+MachineVar fdc_vars[] =
+{
+  MACHINE_VAR(FDC),
+  MACHINE_VAR(fdc_drives),
+  MACHINE_VAR(active_drive), MACHINE_VAR(active_track),
+  MACHINE_VAR(pbGPBuffer),
+  MACHINE_VAR(read_status_delay),
+  { NULL, 0 }
+};
+
 
 
 #define LOAD_RESULT_WITH_STATUS \
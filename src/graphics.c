@@ -24,22 +24,18 @@
 
 #include "shared.h"
 
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 extern Z80Regs *spectrumZ80;
 
 extern MCONFIG mconfig;
 
-extern int memwrites;
-extern int memwriteaddr[];
-extern int memwritetime[];
-extern int memwritevalue[];
-
 extern int outwrites;
-extern int outwritetime[];
-extern int outwritevalue[];
-
-extern int pagewrites;
-extern int pagewritetime[];
-extern int pagewritevalue[];
 
 int full_screen=0;
 
@@ -85,676 +81,717 @@ char SpectrumFlashFlag=0;
  Creates tables for direct access to videomemory pixels and attr.
 ------------------------------------------------------------------*/
 
-extern void set_emupalette();
-
 unsigned short Pixeles[192],Atributos[192];
 
+/* ink and paper of every attribute byte: ATTR_STEADY for the normal
+   ULA, ATTR_FLASH for it while flashing cells are inverted and
+   ATTR_ULAPLUS for the 64 colour mode, which doesn't flash */
+enum { ATTR_STEADY, ATTR_FLASH, ATTR_ULAPLUS, ATTR_MODES };
+
+static byte AttrInk[ATTR_MODES][256], AttrPaper[ATTR_MODES][256];
+
+/* 0xFF in the bytes of the pixels that are set in a pixel byte */
+static byte PixelMask[256][8];
+
+byte CellRow[216];
+
 void CreateVideoTables ( void )
 {
-   int y;
+   int y, attr, bit;
 
    for( y=0; y < 192; y++)
    {
     Pixeles[y]   = ((y & 0xC0) << 5) + ((y & 0x7) << 8) + ((y & 0x38) << 2);
     Atributos[y] = 6144+(32 * (y >> 3));
+    CellRow[Pixeles[y] >> 5] = y >> 3;
+   }
+   for( y=0; y < 24; y++)
+    CellRow[(Atributos[y*8] >> 5)] = y;
+
+   for( attr=0; attr < 256; attr++)
+   {
+    AttrInk[ATTR_STEADY][attr]    = (attr&0x7)+((attr>>3)&0x8);
+    AttrPaper[ATTR_STEADY][attr]  = (attr>>3)&0x0F;
+    AttrInk[ATTR_FLASH][attr]     = attr&0x80 ? AttrPaper[ATTR_STEADY][attr] : AttrInk[ATTR_STEADY][attr];
+    AttrPaper[ATTR_FLASH][attr]   = attr&0x80 ? AttrInk[ATTR_STEADY][attr] : AttrPaper[ATTR_STEADY][attr];
+    AttrInk[ATTR_ULAPLUS][attr]   = ((attr&0xC0)>>6)*16+(attr&0x07);
+    AttrPaper[ATTR_ULAPLUS][attr] = ((attr&0xC0)>>6)*16+((attr&0x38)>>3)+8;
+
+    for( bit=0; bit < 8; bit++)
+     PixelMask[attr][bit] = attr & (0x80>>bit) ? 0xFF : 0;
    }
 }
 
-byte ToBeDrawn[6912*2];
+/*-----------------------------------------------------------------
+ Cell drawing.
+ DrawCells() draws n cells of a scanline from their pixel and
+ attribute bytes in the ink and paper of the frame's colours, eight
+ cells at a time with SSE2, one with NEON, through PixelMask[]
+ elsewhere. DrawWideCells() draws them 10 pixels wide for the full
+ screen mode, the 4th and 8th pixel twice.
+------------------------------------------------------------------*/
+
+#if defined(__SSE2__)
+
+/* every one of the 8 low bytes of v 8 times, in 4 vectors */
+static inline void SpreadBytes(__m128i v, __m128i *out)
+{
+    __m128i lo, hi;
+
+    v  = _mm_unpacklo_epi8(v, v);
+    lo = _mm_unpacklo_epi16(v, v);
+    hi = _mm_unpackhi_epi16(v, v);
+    out[0] = _mm_unpacklo_epi32(lo, lo);
+    out[1] = _mm_unpackhi_epi32(lo, lo);
+    out[2] = _mm_unpacklo_epi32(hi, hi);
+    out[3] = _mm_unpackhi_epi32(hi, hi);
+}
+
+#endif
+
+static void DrawCells(byte *out, const byte *pixels, const byte *attrs, int n,
+                      const byte *ink, const byte *paper)
+{
+    unsigned int mask, bg, flip;
+    int i;
+
+#if defined(__SSE2__)
+    const __m128i bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, (char)128,
+                                      1, 2, 4, 8, 16, 32, 64, (char)128);
+    byte bgs[8], flips[8];
+    __m128i pix[4], bgv[4], flipv[4], set;
+
+    for(; n >= 8; n -= 8, out += 64, pixels += 8, attrs += 8)
+    {
+        for(i=0;i<8;i++)
+        {
+            bgs[i] = paper[attrs[i]];
+            flips[i] = ink[attrs[i]] ^ bgs[i];
+        }
+        SpreadBytes(_mm_loadl_epi64((const __m128i *)pixels), pix);
+        SpreadBytes(_mm_loadl_epi64((const __m128i *)bgs), bgv);
+        SpreadBytes(_mm_loadl_epi64((const __m128i *)flips), flipv);
+        for(i=0;i<4;i++)
+        {
+            set = _mm_cmpeq_epi8(_mm_and_si128(pix[i], bits), bits);
+            _mm_storeu_si128((__m128i *)(out + 16*i),
+                             _mm_xor_si128(bgv[i], _mm_and_si128(set, flipv[i])));
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x8_t bits = vcreate_u8(0x0102040810204080ULL);
+
+    for(; n > 0; n--, out += 8, pixels++, attrs++)
+        vst1_u8(out, vbsl_u8(vtst_u8(vdup_n_u8(*pixels), bits),
+                             vdup_n_u8(ink[*attrs]), vdup_n_u8(paper[*attrs])));
+#endif
+
+    for(; n > 0; n--, out += 8, pixels++, attrs++)
+    {
+        bg   = paper[*attrs] * 0x01010101u;
+        flip = (ink[*attrs] ^ paper[*attrs]) * 0x01010101u;
+        for(i=0;i<8;i+=4)
+        {
+            memcpy(&mask, &PixelMask[*pixels][i], 4);
+            mask = bg ^ (flip & mask);
+            memcpy(out + i, &mask, 4);
+        }
+    }
+}
+
+static void DrawWideCells(byte *out, const byte *pixels, const byte *attrs, int n,
+                          const byte *ink, const byte *paper)
+{
+    const byte *mask;
+    byte bg, flip;
+
+    for(; n > 0; n--, out += 10, pixels++, attrs++)
+    {
+        mask = PixelMask[*pixels];
+        bg   = paper[*attrs];
+        flip = ink[*attrs] ^ bg;
+        out[0] = bg ^ (flip & mask[0]);
+        out[1] = bg ^ (flip & mask[1]);
+        out[2] = bg ^ (flip & mask[2]);
+        out[3] = out[4] = bg ^ (flip & mask[3]);
+        out[5] = bg ^ (flip & mask[4]);
+        out[6] = bg ^ (flip & mask[5]);
+        out[7] = bg ^ (flip & mask[6]);
+        out[8] = out[9] = bg ^ (flip & mask[7]);
+    }
+}
+
+typedef void (*CellDrawer)(byte *out, const byte *pixels, const byte *attrs, int n,
+                           const byte *ink, const byte *paper);
+
+/* draw() for the cells of n, width pixels wide, whose bit is set in dirty */
+static void DrawDirtyCells(CellDrawer draw, int width, byte *out, const byte *pixels,
+                           const byte *attrs, int n, unsigned dirty,
+                           const byte *ink, const byte *paper)
+{
+    int i, j;
+
+    if(n < 32)
+        dirty &= (1u << n) - 1;
+    for(i=0;i<n && dirty>>i;i=j)
+    {
+        for(j=i+1;j<n && (dirty>>j & 1)==(dirty>>i & 1);j++);
+        if(dirty>>i & 1)
+            draw(out+width*i,pixels+i,attrs+i,j-i,ink,paper);
+    }
+}
 
 /*-----------------------------------------------------------------
- Redraw the entire screen from the speccy's VRAM.
- It reads the from the 16384 memory address the bytes of the
- VideoRAM needed to rebuild the screen and the border.
+ Dirty cells.
+ Bit x of DirtyCells[screen][row] is set by SCREEN_WRITTEN() when a
+ byte of cell x of that row of screen 5 (0) or 7 (1) is written, and
+ moved to RedrawCells at the start of a frame that is drawn. The
+ cells written since the last frame drawn and the ones written
+ during this one are drawn, the rest of Picture is left as the last
+ frame drew it, and the border only if its colour changed; when the
+ flash phase changes, the cells that flash too. All of it is drawn
+ when vram_touched says the memory was loaded some other way, when
+ the machine, Picture, colours or shown screen aren't the ones drawn
+ last or when the host drew over Picture and called RedrawScreen().
 ------------------------------------------------------------------*/
 
-void
-JustRun(Z80Regs * regs, int do_skip)
+unsigned DirtyCells[2][24];
+
+static unsigned RedrawCells[2][24];
+static int redraw_all = 1;
+static Z80Regs *drawn_z80;
+static byte *drawn_picture;
+static int drawn_mode = -1, drawn_full_screen = -1, drawn_page = -1, drawn_border = -1;
+
+void RedrawScreen(void)
 {
-    int target_tstate, current_tstate,memindex,outindex,direccion,charx,chary,i,repeat;
-    
-    int scanl,x,startbytes,startattr;
-    int idxout,idxmem,idxpage,border,page;
-    volatile byte *offset;
-    register byte fg,bg,attr,bytevalue;
-    
-    outwrites=0;
-    outwritetime[outwrites]=spectrumZ80->ICount;
-    outwritevalue[outwrites++]=BorderColor;
-    
-    Z80Run_NC (spectrumZ80, 50 ); // Trying interruption
-    
-    target_tstate = ( model<ZX_128 ? TIMING_48+1 : TIMING_128+1 ) - 23 ; // 23=max execution time of uncontended instruction
-    Z80Run_NCNI (spectrumZ80, target_tstate - (spectrumZ80->IPeriod - spectrumZ80->ICount) ); // upper border
-    
-    memwrites=0;
-    pagewrites=0;
-    if(!do_skip)
+    redraw_all = 1;
+}
+
+/* the cells written since the last frame drawn are drawn in this one */
+static void TakeDirtyCells(void)
+{
+    if(vram_touched || spectrumZ80 != drawn_z80 || Picture != drawn_picture)
     {
-        register byte *VRAM5,*VRAM7;
-        VRAM5   = (byte *)&RAM_pages[0x4000*5];
-        VRAM7   = (byte *)&RAM_pages[0x4000*7];
-        memcpy(ToBeDrawn,VRAM5,6912);
-        memcpy(ToBeDrawn+6912,VRAM7,6912);
-        pagewritetime[pagewrites]=spectrumZ80->ICount;
-        pagewritevalue[pagewrites++]=pagination_128 & 8;
-        page=pagination_128 & 8;
+        memset(DirtyCells, 0xFF, sizeof(DirtyCells));
+        vram_touched = 0;
+        redraw_all = 1;
     }
-    target_tstate+=192*hwopt.ts_line+23;    // All screen
-    if (mconfig.contention==1 && !(mconfig.speed_loading && tape_playing))
+    memcpy(RedrawCells, DirtyCells, sizeof(RedrawCells));
+    memset(DirtyCells, 0, sizeof(DirtyCells));
+}
+
+/* the flash phase changed, the cells that flash are drawn again */
+static void FlashCells(int screen)
+{
+    const byte *attr = &RAM_pages[0x4000*(screen ? 7 : 5)+6144];
+    int row, x;
+
+    for(row=0;row<24;row++)
+        for(x=0;x<32;x++)
+            if(*attr++ & 0x80)
+                RedrawCells[screen][row] |= 1u << x;
+}
+
+/*-----------------------------------------------------------------
+ ULA catch-up.
+ The paper is drawn while the frame runs, as far as the beam has
+ got. zx.c calls CatchUpScreen() with the T-state since the
+ interrupt just before the Z80 writes to a byte of the shown screen
+ the ULA has already read, flips the shown screen or turns ULAplus
+ on or off. The cells the ULA reaches up to then are drawn from
+ memory as it stands, in the screen and colours of the moment, and
+ JustRun() draws the rest once the frame is over; nothing is logged
+ and nothing is tested per cell. The ULA reaches a cell every 4
+ T-states from TIMING_48/TIMING_128 on.
+ The cores without contention charge an instruction's T-states in
+ one go, so their writes catch up as of the start of the instruction.
+------------------------------------------------------------------*/
+
+static int beam_on;                             // drawing this frame
+static int beam_line, beam_cell, beam_tstate;   // next cell, when the ULA reaches it
+static int beam_first;                          // when it reaches the first
+static int beam_page, beam_mode, beam_border;
+static int beam_all, beam_draw_border;          // all cells, border cells drawn
+static int frame_page, frame_mode, frame_border; // at the start, -1 once changed
+static unsigned row_serial[240];                // see 32 bit colour, 0 once drawn
+
+static int ColourMode(void)
+{
+    return zx_ula64_enabled ? ATTR_ULAPLUS : SpectrumFlashFlag ? ATTR_FLASH : ATTR_STEADY;
+}
+
+static int BorderIndex(void)
+{
+    return BorderColor + (zx_ula64_enabled ? 8 : 0);
+}
+
+/* what changed since the beam was drawn last is drawn whole from here */
+static void FollowChanges(void)
+{
+    int page = pagination_128 & 8, mode = ColourMode();
+
+    if(page != beam_page)
     {
-        Z80Run (spectrumZ80, target_tstate - (spectrumZ80->IPeriod - spectrumZ80->ICount) );
+        beam_page = page;
+        frame_page = -1;
+        beam_all = 1;
     }
-    else    
+    if(mode != beam_mode)
     {
-        Z80Run_NCNI (spectrumZ80, target_tstate - (spectrumZ80->IPeriod - spectrumZ80->ICount) );
+        beam_mode = mode;
+        frame_mode = -1;
+        beam_all = 1;
     }
-    pagewritetime[pagewrites]=spectrumZ80->ICount;
-    memwritetime[memwrites]=spectrumZ80->ICount;
-    
-    Z80Run_NCNI (spectrumZ80, spectrumZ80->ICount-73 ); // Lower border
-    
-    outwritetime[outwrites]=spectrumZ80->ICount;
-    
-    Z80Run_NC (spectrumZ80, spectrumZ80->ICount);       // End & Try interrupt?
-    
-	if(zx_palette_change)
-	{
-	   set_emupalette();
-	   zx_palette_change = 0;
-	}
+}
 
-    if(!do_skip)
+/* the next n cells of the current line */
+static void DrawBeam(int n)
+{
+    const byte *screen = &RAM_pages[0x4000*(beam_page ? 7 : 5)];
+    const byte *pixels = screen + Pixeles[beam_line] + beam_cell;
+    const byte *attrs = screen + Atributos[beam_line] + beam_cell;
+    unsigned dirty;
+    int row;
+
+    dirty = beam_all ? ~0u :
+            RedrawCells[beam_page!=0][beam_line>>3] | DirtyCells[beam_page!=0][beam_line>>3];
+    dirty >>= beam_cell;
+    if(n < 32)
+        dirty &= (1u << n) - 1;
+    if(!dirty)
+        return;
+    if(full_screen)
     {
-        if(!full_screen)
+        row = beam_line + (beam_line+3)/4;
+        DrawDirtyCells(DrawWideCells,10,(byte *)Picture + 320*row + 10*beam_cell,
+                       pixels,attrs,n,dirty,AttrInk[beam_mode],AttrPaper[beam_mode]);
+    }
+    else
+    {
+        row = 24 + beam_line;
+        DrawDirtyCells(DrawCells,8,(byte *)Picture + 320*row + 8*(4+beam_cell),
+                       pixels,attrs,n,dirty,AttrInk[beam_mode],AttrPaper[beam_mode]);
+    }
+    row_serial[row] = 0;
+}
+
+void CatchUpScreen(int tstate)
+{
+    int n;
+
+    if(!beam_on || tstate < beam_tstate)
+        return;
+    FollowChanges();
+    while(beam_line < 192 && beam_tstate <= tstate)
+    {
+        n = (tstate - beam_tstate)/4 + 1;
+        if(n > 32 - beam_cell)
+            n = 32 - beam_cell;
+        DrawBeam(n);
+        beam_cell += n;
+        beam_tstate += 4*n;
+        if(beam_cell == 32)
         {
-            idxout=0;
-            idxpage=0;
-            idxmem=0;
-    
-            target_tstate = ( model<ZX_128 ? (TIMING_48 - 16) : (TIMING_128 - 16) ) - 24 * hwopt.ts_line ;
-            do  
-            {
-                border=outwritevalue[idxout];
-                idxout++;
-            }
-            while((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY);
-            
-            offset=(byte *)Picture;
-    
-            for (scanl = 0; scanl < 24; scanl++)
-            {
-                for(x=0;x<40;x++)
-                {
-                    if((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                    {
-                        border=outwritevalue[idxout++];
-                    }
-                    if(zx_ula64_enabled)
-                    {
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-                    }
-                    else
-                    {
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                    }
-                    target_tstate+=4;
-                }
-                target_tstate+=hwopt.ts_line-160;
-                while((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                {
-                    border=outwritevalue[idxout++];
-                }
-            }
-    
-            for (scanl = 0; scanl < 192; scanl++)
-            {
-                startbytes=Pixeles[scanl];
-                startattr=Atributos[scanl];
-    
-                for(x=0;x<4;x++)
-                {
-                    if((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                    {
-                        border=outwritevalue[idxout++];
-                    }
-                    if(zx_ula64_enabled)
-                    {
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-                    }
-                    else
-                    {
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                    }
-                    target_tstate+=4;
-                }
-                while((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                {
-                    page=864*pagewritevalue[idxpage++];
-                }
-                while((spectrumZ80->IPeriod - memwritetime[idxmem])  < target_tstate)
-                {
-                    ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                    idxmem++;
-                }
-                bytevalue=ToBeDrawn[startbytes+page];
-                attr=ToBeDrawn[startattr+page];
-                if(SpectrumFlashFlag)
-                {
-                    if(! zx_ula64_enabled)
-                    {
-                       if(attr&0x80)
-                       {
-                          bg=(attr&0x7)+((attr>>3)&0x8); fg=((attr>>3)&0x0F);
-                       }
-                       else
-                       {
-                          fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                       }
-                    }
-                    else
-                    {
-
-                    	if(zx_palette_change)
-                    	{
-                    	   set_emupalette();
-                    	   zx_palette_change = 0;
-                    	}
-
-                    	byte ink = attr & 0x07;
-                    	byte paper = (attr & 0x38)>>3;
-                    	byte table = (attr & 0xC0)>>6;
-
-                    	fg = table*16+ink;
-                    	bg = table*16+paper+8;
-
-                    }
-                    *(offset++)=bytevalue & 0x80 ? fg : bg;
-                    *(offset++)=bytevalue & 0x40 ? fg : bg;
-                    *(offset++)=bytevalue & 0x20 ? fg : bg;
-                    *(offset++)=bytevalue & 0x10 ? fg : bg;
-                    *(offset++)=bytevalue & 0x8  ? fg : bg;
-                    *(offset++)=bytevalue & 0x4  ? fg : bg;
-                    *(offset++)=bytevalue & 0x2  ? fg : bg;
-                    *(offset++)=bytevalue & 0x1  ? fg : bg;
-                    target_tstate+=4;
-                    for(x=1;x<32;x++)
-                    {
-                        if((spectrumZ80->IPeriod - memwritetime[idxmem] ) < target_tstate)
-                        {
-                            ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                            idxmem++;
-                        }
-                        if((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                        {
-                            page=864*pagewritevalue[idxpage++];
-                        }
-                        bytevalue=ToBeDrawn[startbytes+x+page];
-                        attr=ToBeDrawn[startattr+x+page];
-
-                        if(! zx_ula64_enabled)
-                        {
-                           if(attr&0x80)
-                           {
-                              bg=(attr&0x7)+((attr>>3)&0x8); fg=((attr>>3)&0x0F);
-                           }
-                           else
-                           {
-                              fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                           }
-                        }
-                        else
-                        {
-
-                        	if(zx_palette_change)
-                        	{
-                        	   set_emupalette();
-                        	   zx_palette_change = 0;
-                        	}
-
-                        	byte ink = attr & 0x07;
-                        	byte paper = (attr & 0x38)>>3;
-                        	byte table = (attr & 0xC0)>>6;
-
-                        	fg = table*16+ink;
-                        	bg = table*16+paper+8;
-
-                        }
-                        *(offset++)=bytevalue & 0x80 ? fg : bg;
-                        *(offset++)=bytevalue & 0x40 ? fg : bg;
-                        *(offset++)=bytevalue & 0x20 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x8  ? fg : bg;
-                        *(offset++)=bytevalue & 0x4  ? fg : bg;
-                        *(offset++)=bytevalue & 0x2  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        target_tstate+=4;
-                    }
-                }
-                else    
-                {
-                    if(! zx_ula64_enabled)
-                    {
-                    	fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                    }
-                    else
-                    {
-
-                    	if(zx_palette_change)
-                    	{
-                    	   set_emupalette();
-                    	   zx_palette_change = 0;
-                    	}
-
-                    	byte ink = attr & 0x07;
-                    	byte paper = (attr & 0x38)>>3;
-                    	byte table = (attr & 0xC0)>>6;
-
-                    	fg = table*16+ink;
-                    	bg = table*16+paper+8;
-
-                    }
-                    *(offset++)=bytevalue & 0x80 ? fg : bg;
-                    *(offset++)=bytevalue & 0x40 ? fg : bg;
-                    *(offset++)=bytevalue & 0x20 ? fg : bg;
-                    *(offset++)=bytevalue & 0x10 ? fg : bg;
-                    *(offset++)=bytevalue & 0x8  ? fg : bg;
-                    *(offset++)=bytevalue & 0x4  ? fg : bg;
-                    *(offset++)=bytevalue & 0x2  ? fg : bg;
-                    *(offset++)=bytevalue & 0x1  ? fg : bg;
-                    target_tstate+=4;
-                    for(x=1;x<32;x++)
-                    {
-                        if((spectrumZ80->IPeriod - memwritetime[idxmem] ) < target_tstate)
-                        {
-                            ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                            idxmem++;
-                        }
-                        if((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                        {
-                            page=864*pagewritevalue[idxpage++];
-                        }
-                        bytevalue=ToBeDrawn[Pixeles[scanl]+x+page];
-                        attr=ToBeDrawn[Atributos[scanl]+x+page];
-
-                        if(! zx_ula64_enabled)
-                        {
-                        	fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                        }
-                        else
-                        {
-
-                        	if(zx_palette_change)
-                        	{
-                        	   set_emupalette();
-                        	   zx_palette_change = 0;
-                        	}
-
-                        	byte ink = attr & 0x07;
-                        	byte paper = (attr & 0x38)>>3;
-                        	byte table = (attr & 0xC0)>>6;
-
-                        	fg = table*16+ink;
-                        	bg = table*16+paper+8;
-
-                        }
-                        *(offset++)=bytevalue & 0x80 ? fg : bg;
-                        *(offset++)=bytevalue & 0x40 ? fg : bg;
-                        *(offset++)=bytevalue & 0x20 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x8  ? fg : bg;
-                        *(offset++)=bytevalue & 0x4  ? fg : bg;
-                        *(offset++)=bytevalue & 0x2  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        target_tstate+=4;
-                    }
-                }
-    
-                for(x=0;x<4;x++)
-                {
-                    while((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                    {
-                        border=outwritevalue[idxout++];
-                    }
-                    if(zx_ula64_enabled)
-                    {
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-                    }
-                    else
-                    {
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                    }
-                    target_tstate+=4;
-                }
-                target_tstate+=hwopt.ts_line-160;
-            }
-    
-            for (scanl = 0; scanl < 24; scanl++)
+            // every 4th line twice, to fill 240 lines
+            if(full_screen && !(beam_line % 4))
             {
-                while((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                {
-                    border=outwritevalue[idxout];
-                    idxout++;
-                }
-                if(zx_ula64_enabled)
-                {
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-					*(offset++)=border+8;
-                }
-                else
-                {
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                    *(offset++)=border;
-                }
-                target_tstate+=4;
-                for(x=1;x<40;x++)
-                {
-                    if((spectrumZ80->IPeriod - outwritetime[idxout])<target_tstate+BORDERDELAY)
-                    {
-                        border=outwritevalue[idxout++];
-                    }
-                    if(zx_ula64_enabled)
-                    {
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-						*(offset++)=border+8;
-                    }
-                    else
-                    {
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                        *(offset++)=border;
-                    }
-                    target_tstate+=4;
-                }
-                target_tstate+=hwopt.ts_line-160;
+                byte *line = (byte *)Picture + 320*(beam_line + beam_line/4);
+                memcpy(line+320,line,320);
+                if(!row_serial[beam_line + beam_line/4])
+                    row_serial[beam_line + beam_line/4 + 1] = 0;
             }
+            beam_line++;
+            beam_cell = 0;
+            beam_tstate += hwopt.ts_line - 128;
         }
-        else /* Full Screen */
+    }
+}
+
+/*-----------------------------------------------------------------
+ Border.
+ The window has 24 lines of 40 border cells above and below the
+ paper and 4 at each side, which the ULA reaches 4 T-states apart
+ from 16 T-states before each line's paper on; an OUT shows in them
+ BORDERDELAY T-states late. Only an OUT to 0xFE that changes the
+ colour (or ULAplus going on or off) calls CatchUpBorder(), and
+ JustRun() at the end of the frame: the cells from where the last
+ call stopped up to then are filled in the colour they had, as runs
+ that go on for as long as Picture has border. That is the lines
+ above and below the paper whole, and the right side of a line
+ with the left of the next. A frame with no change fills the whole
+ border at its end that way, and one that keeps the colour drawn
+ last doesn't touch it.
+------------------------------------------------------------------*/
+
+#define BORDER_CELLS (40*(24+192+24))
+
+static int border_on;       // drawing it this frame
+static int border_pos;      // next cell, 40 a line
+static int border_tstate;   // when the ULA reaches the first
+
+/* the border cells from border_pos up to end, in colour */
+static void FillBorder(int end, int colour)
+{
+    int line, cell, next, row;
+
+    while(border_pos < end)
+    {
+        line = border_pos / 40;
+        cell = border_pos % 40;
+        if(line < 24)
+            next = 24*40 + 4;
+        else if(line >= 24+192)
+            next = BORDER_CELLS;
+        else if(cell < 4)
+            next = line*40 + 4;
+        else if(cell < 36)
         {
-            int n;
+            border_pos = line*40 + 36;  // the paper
+            continue;
+        }
+        else
+            next = line < 24+191 ? (line+1)*40 + 4 : BORDER_CELLS;
+        if(next > end)
+            next = end;
+        memset((byte *)Picture + 8*border_pos, colour, 8*(next - border_pos));
+        for(row=line;row<=(next-1)/40;row++)
+            row_serial[row] = 0;
+        border_pos = next;
+    }
+}
 
-            idxpage=0;
-            idxmem=0;
-    
-            target_tstate = ( model<ZX_128 ? TIMING_48+1 : TIMING_128+1 );
-            offset=(byte *)Picture;
-            for (scanl = 0; scanl < 192; scanl++)
-            {
-                n = 0;
-                while ( n < 2 )
-                {
-                    startbytes=Pixeles[scanl];
-                    startattr=Atributos[scanl];
-                    if ( !n )
-                    {
-                        while((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                        {
-                            page=864*pagewritevalue[idxpage++];
-                        }
-                        while((spectrumZ80->IPeriod - memwritetime[idxmem])  < target_tstate)
-                        {
-                            ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                            idxmem++;
-                        }
-                    }
-                    bytevalue=ToBeDrawn[startbytes+page];
-                    attr=ToBeDrawn[startattr+page];
-                    if(SpectrumFlashFlag)
-                    {
-                        if(! zx_ula64_enabled)
-                        {
-                          if(attr&0x80)
-                          {
-                            bg=(attr&0x7)+((attr>>3)&0x8); fg=((attr>>3)&0x0F);
-                          }
-                          else
-                          {
-                            fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                          }
-                        }
-                        else
-                        {
-
-                        	if(zx_palette_change)
-                        	{
-                        	   set_emupalette();
-                        	   zx_palette_change = 0;
-                        	}
-
-                        	byte ink = attr & 0x07;
-                        	byte paper = (attr & 0x38)>>3;
-                        	byte table = (attr & 0xC0)>>6;
-
-                        	fg = table*16+ink;
-                        	bg = table*16+paper+8;
-
-                        }
-                        *(offset++)=bytevalue & 0x80 ? fg : bg;
-                        *(offset++)=bytevalue & 0x40 ? fg : bg;
-                        *(offset++)=bytevalue & 0x20 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x8  ? fg : bg;
-                        *(offset++)=bytevalue & 0x4  ? fg : bg;
-                        *(offset++)=bytevalue & 0x2  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        if ( !n ) target_tstate+=4;
-                        for(x=1;x<32;x++)
-                        {
-                            if ( !n )
-                            {
-                                if((spectrumZ80->IPeriod - memwritetime[idxmem] ) < target_tstate)
-                                {
-                                    ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                                    idxmem++;
-                                }
-                                if((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                                {
-                                    page=864*pagewritevalue[idxpage++];
-                                }
-                            }
-                            bytevalue=ToBeDrawn[startbytes+x+page];
-                            attr=ToBeDrawn[startattr+x+page];
-
-
-                            if(! zx_ula64_enabled)
-                            {
-                                if(attr&0x80)
-                                {
-                                    bg=(attr&0x7)+((attr>>3)&0x8); fg=((attr>>3)&0x0F);
-                                }
-                                else
-                                {
-                                    fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                                }
-                            }
-                            else
-                            {
-                            	if(zx_palette_change)
-                            	{
-                            	   set_emupalette();
-                            	   zx_palette_change = 0;
-                            	}
-
-                            	byte ink = attr & 0x07;
-                            	byte paper = (attr & 0x38)>>3;
-                            	byte table = (attr & 0xC0)>>6;
-
-                            	fg = table*16+ink;
-                            	bg = table*16+paper+8;
-
-                            }
-                            *(offset++)=bytevalue & 0x80 ? fg : bg;
-                            *(offset++)=bytevalue & 0x40 ? fg : bg;
-                            *(offset++)=bytevalue & 0x20 ? fg : bg;
-                            *(offset++)=bytevalue & 0x10 ? fg : bg;
-                            *(offset++)=bytevalue & 0x10 ? fg : bg;
-                            *(offset++)=bytevalue & 0x8  ? fg : bg;
-                            *(offset++)=bytevalue & 0x4  ? fg : bg;
-                            *(offset++)=bytevalue & 0x2  ? fg : bg;
-                            *(offset++)=bytevalue & 0x1  ? fg : bg;
-                            *(offset++)=bytevalue & 0x1  ? fg : bg;
-
-                            if ( !n ) target_tstate+=4;
-                        }
-                    }
-                    else    
-                    {
-                        if(! zx_ula64_enabled)
-                        {
-                        	fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                        }
-                        else
-                        {
-                        	if(zx_palette_change)
-                        	{
-                        	   set_emupalette();
-                        	   zx_palette_change = 0;
-                        	}
-
-                        	byte ink = attr & 0x07;
-                        	byte paper = (attr & 0x38)>>3;
-                        	byte table = (attr & 0xC0)>>6;
-
-                        	fg = table*16+ink;
-                        	bg = table*16+paper+8;
-                        }
-
-                        *(offset++)=bytevalue & 0x80 ? fg : bg;
-                        *(offset++)=bytevalue & 0x40 ? fg : bg;
-                        *(offset++)=bytevalue & 0x20 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x10 ? fg : bg;
-                        *(offset++)=bytevalue & 0x8  ? fg : bg;
-                        *(offset++)=bytevalue & 0x4  ? fg : bg;
-                        *(offset++)=bytevalue & 0x2  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        *(offset++)=bytevalue & 0x1  ? fg : bg;
-                        if ( !n ) target_tstate+=4;
-                        for(x=1;x<32;x++)
-                        {
-                            if ( !n ) 
-                            {
-                                if((spectrumZ80->IPeriod - memwritetime[idxmem] ) < target_tstate)
-                                {
-                                    ToBeDrawn[memwriteaddr[idxmem]]=memwritevalue[idxmem];
-                                    idxmem++;
-                                }
-                                if((spectrumZ80->IPeriod - pagewritetime[idxpage]) < target_tstate)
-                                {
-                                    page=864*pagewritevalue[idxpage++];
-                                }
-                            }
-                            bytevalue=ToBeDrawn[startbytes+x+page];
-                            attr=ToBeDrawn[startattr+x+page];
-
-                            if(! zx_ula64_enabled)
-                            {
-                            	fg=(attr&0x7)+((attr>>3)&0x8); bg=((attr>>3)&0x0F);
-                            }
-                            else
-                            {
-
-                            	if(zx_palette_change)
-                            	{
-                            	   set_emupalette();
-                            	   zx_palette_change = 0;
-                            	}
-
-                            	byte ink = attr & 0x07;
-                            	byte paper = (attr & 0x38)>>3;
-                            	byte table = (attr & 0xC0)>>6;
-
-                            	fg = table*16+ink;
-                            	bg = table*16+paper+8;
-
-                            }
-                            *(offset++)=bytevalue & 0x80 ? fg : bg;
-                            *(offset++)=bytevalue & 0x40 ? fg : bg;
-                            *(offset++)=bytevalue & 0x20 ? fg : bg;
-                            *(offset++)=bytevalue & 0x10 ? fg : bg;
-                            *(offset++)=bytevalue & 0x10 ? fg : bg;
-                            *(offset++)=bytevalue & 0x8  ? fg : bg;
-                            *(offset++)=bytevalue & 0x4  ? fg : bg;
-                            *(offset++)=bytevalue & 0x2  ? fg : bg;
-                            *(offset++)=bytevalue & 0x1  ? fg : bg;
-                            *(offset++)=bytevalue & 0x1  ? fg : bg;
-
-                            if ( !n ) target_tstate+=4;
-                        }
-                    }
-                    if ( !n ) target_tstate+=hwopt.ts_line-128;
-
-                    n++;
-                    if (!full_screen || (scanl % 4)) break;
-                }
-            }
+void CatchUpBorder(int tstate)
+{
+    int border = BorderIndex(), line, cell, end;
+
+    if(!border_on)
+        return;
+    if(border != beam_border)
+    {
+        beam_border = border;
+        frame_border = -1;
+        beam_draw_border = 1;
+    }
+
+    tstate -= border_tstate + BORDERDELAY;
+    if(tstate < 0)
+        return;
+    line = tstate / hwopt.ts_line;
+    cell = (tstate - line*hwopt.ts_line)/4 + 1;
+    end = line*40 + (cell < 40 ? cell : 40);
+    if(end > BORDER_CELLS)
+        end = BORDER_CELLS;
+
+    if(beam_draw_border)
+        FillBorder(end, beam_border);
+    else if(border_pos < end)
+        border_pos = end;
+}
+
+/*-----------------------------------------------------------------
+ 32 bit colour.
+ A host that shows the picture in 32 bit colour, rather than through
+ the palette set_emupalette() gives it, points Picture32 at 320x240
+ pixels of 0xRRGGBB. Each line of Picture is turned into them once
+ the beam is done with it, in the colours its indices have then, so
+ a ULAplus palette written while the frame runs shows from the line
+ the beam is on. port_0xff3b calls CatchUpColours() before it
+ changes the palette: that draws the picture up to then and turns
+ the lines it finishes into colour, and JustRun() the rest. A line
+ that wasn't drawn again and whose colours didn't change since it
+ was last turned is left as it is.
+------------------------------------------------------------------*/
+
+#define ULA64_LEVEL(x) (((x)<<5)+((x)<<2)+((x)&0x03))
+
+unsigned *Picture32;
+
+static unsigned Colour32[256];                  // of every index of Picture
+static byte colour_ula64 = 2, colour_palette[64]; // what they were made from
+static unsigned colour_serial;                  // changes with Colour32
+static int colour_row;                          // next line to turn
+static unsigned *drawn_picture32;
+
+/* Colour32 for the palette as it is now */
+static void FollowColours(void)
+{
+    int i, v;
+
+    if(colour_ula64 == zx_ula64_enabled &&
+       (!zx_ula64_enabled || !memcmp(colour_palette, zx_ula64_palette, 64)))
+        return;
+    colour_ula64 = zx_ula64_enabled;
+    memcpy(colour_palette, zx_ula64_palette, 64);
+    memset(Colour32, 0, sizeof(Colour32));
+    if(zx_ula64_enabled)
+        for(i=0;i<64;i++)
+        {
+            v = zx_ula64_palette[i];
+            Colour32[i] = ULA64_LEVEL((v & 0x1C) >> 2) << 16 |
+                          ULA64_LEVEL((v & 0xE0) >> 5) << 8 |
+                          ULA64_LEVEL(((v & 0x03) << 1) | (v & 0x01));
+        }
+    else
+        for(i=0;i<17;i++)
+            Colour32[i] = zx_colours[i][0] << 16 | zx_colours[i][1] << 8 | zx_colours[i][2];
+    if(++colour_serial == 0)
+        colour_serial = 1;
+}
+
+/* lines of Picture the beam is done with at tstate */
+static int LinesDone(int tstate)
+{
+    int lines;
+
+    if(full_screen)
+    {
+        tstate -= beam_first + 4*31;
+        lines = tstate < 0 ? 0 : tstate/hwopt.ts_line + 1;
+        if(lines > 192)
+            lines = 192;
+        return lines + (lines+3)/4;
+    }
+    tstate -= border_tstate + 4*39 + BORDERDELAY;
+    lines = tstate < 0 ? 0 : tstate/hwopt.ts_line + 1;
+    return lines < 240 ? lines : 240;
+}
+
+void CatchUpColours(int tstate)
+{
+    const byte *in;
+    unsigned *out;
+    int end, x;
+
+    if(!beam_on || Picture32 == NULL)
+        return;
+    CatchUpScreen(tstate);
+    CatchUpBorder(tstate);
+    FollowColours();
+    for(end=LinesDone(tstate);colour_row<end;colour_row++)
+    {
+        if(row_serial[colour_row] == colour_serial)
+            continue;
+        row_serial[colour_row] = colour_serial;
+        in = (byte *)Picture + 320*colour_row;
+        out = Picture32 + 320*colour_row;
+        for(x=0;x<320;x++)
+            out[x] = Colour32[in[x]];
+    }
+}
+
+/*-----------------------------------------------------------------
+ Frame.
+------------------------------------------------------------------*/
+
+/* the beam to the top of the picture, with what has to be drawn */
+static void StartBeam(void)
+{
+    TakeDirtyCells();
+    beam_page = pagination_128 & 8;
+    beam_mode = ColourMode();
+    beam_border = BorderIndex();
+
+    beam_all = redraw_all || full_screen != drawn_full_screen || beam_page != drawn_page;
+    if(!beam_all && beam_mode != drawn_mode)
+    {
+        if(beam_mode == ATTR_ULAPLUS || drawn_mode < 0 || drawn_mode == ATTR_ULAPLUS)
+            beam_all = 1;
+        else
+            FlashCells(beam_page != 0);
+    }
+    beam_draw_border = beam_all || beam_border != drawn_border;
+    frame_page = beam_page;
+    frame_mode = beam_mode;
+    frame_border = beam_border;
+
+    beam_line = beam_cell = 0;
+    beam_tstate = beam_first = ( model<ZX_128 ? TIMING_48 : TIMING_128 ) + (full_screen ? 1 : 0);
+    beam_on = 1;
+
+    border_pos = 0;
+    border_tstate = ( model<ZX_128 ? (TIMING_48 - 16) : (TIMING_128 - 16) ) - 24 * hwopt.ts_line ;
+    border_on = !full_screen;
+
+    if(Picture32 != drawn_picture32)
+        memset(row_serial, 0, sizeof(row_serial));
+    colour_row = 0;
+}
+
+/* the rest of the picture, and what it shows now */
+static void FinishBeam(void)
+{
+    CatchUpScreen(spectrumZ80->IPeriod);
+    CatchUpBorder(spectrumZ80->IPeriod);
+    CatchUpColours(spectrumZ80->IPeriod);
+    beam_on = border_on = 0;
+
+    redraw_all = 0;
+    drawn_z80 = spectrumZ80;
+    drawn_picture = Picture;
+    drawn_picture32 = Picture32;
+    drawn_mode = frame_mode;
+    drawn_full_screen = full_screen;
+    drawn_page = frame_page;
+    drawn_border = full_screen ? -1 : frame_border;
+}
+
+/* where the selected machine is drawn and what was drawn there, see
+   ZX_SelectMachine; the frame events are rebuilt by every frame */
+MachineVar graphics_vars[] =
+{
+  MACHINE_VAR(Picture), MACHINE_VAR(Picture32),
+  MACHINE_VAR(DirtyCells), MACHINE_VAR(RedrawCells), MACHINE_VAR(redraw_all),
+  MACHINE_VAR(drawn_z80), MACHINE_VAR(drawn_picture), MACHINE_VAR(drawn_mode),
+  MACHINE_VAR(drawn_full_screen), MACHINE_VAR(drawn_page), MACHINE_VAR(drawn_border),
+  MACHINE_VAR(beam_on), MACHINE_VAR(beam_line), MACHINE_VAR(beam_cell),
+  MACHINE_VAR(beam_tstate), MACHINE_VAR(beam_first), MACHINE_VAR(beam_page),
+  MACHINE_VAR(beam_mode), MACHINE_VAR(beam_border), MACHINE_VAR(beam_all),
+  MACHINE_VAR(beam_draw_border), MACHINE_VAR(frame_page), MACHINE_VAR(frame_mode),
+  MACHINE_VAR(frame_border), MACHINE_VAR(row_serial),
+  MACHINE_VAR(border_on), MACHINE_VAR(border_pos), MACHINE_VAR(border_tstate),
+  MACHINE_VAR(Colour32), MACHINE_VAR(colour_ula64), MACHINE_VAR(colour_palette),
+  MACHINE_VAR(colour_serial), MACHINE_VAR(colour_row), MACHINE_VAR(drawn_picture32),
+  { NULL, 0 }
+};
+
+/*-----------------------------------------------------------------
+ Frame events.
+ What the Z80 has to be run with changes at a few points of every
+ frame: the interrupt is only accepted for the first irqtime
+ T-states, memory is only contended while the screen is drawn, and
+ the frame wraps at IPeriod. BuildFrameEvents() puts those points,
+ in T-states since the interrupt, in frame_event[] sorted on time,
+ and JustRun() runs the core that suits each stretch up to the next
+ one. A core only stops between instructions, so an event that has
+ to be met by a different core is scheduled EV_GUARD T-states (the
+ longest instruction) early. That costs no accuracy: the core that
+ takes over is the one that times everything, contention is looked
+ up by T-state and is nil before the screen, and Z80Run_NC only
+ takes the interrupt once ICount has wrapped.
+ The tape's edges are the other events. RunSlice() stops the core
+ at the first instruction boundary on or after the next edge and
+ lets it through with loader(), so no core looks at the tape after
+ every instruction. The edge loading hooks and the auto-loading sit
+ on IN in loader_hook(); when one of them starts or stops the tape
+ or brings an edge forward the core returns (Z80_TAPE_BREAK in z80.c)
+ and the stretch goes on with the core and the edge worked out again.
+ The disk has no timing of its own to schedule.
+------------------------------------------------------------------*/
+
+#define EV_GUARD 23
+
+enum { EV_INT_END, EV_SCREEN_START, EV_SCREEN_END, EV_FRAME_END };
+
+typedef struct
+{
+    int tstate;
+    int type;
+}
+FrameEvent;
+
+typedef word (*Z80Core)(Z80Regs *, int);
+
+#define MAX_FRAME_EVENTS 8
+
+static FrameEvent frame_event[MAX_FRAME_EVENTS];
+static int frame_events;
+
+static void ScheduleFrameEvent(int tstate, int type)
+{
+    int i;
+
+    for(i=frame_events;i>0 && frame_event[i-1].tstate>tstate;i--)
+        frame_event[i]=frame_event[i-1];
+    frame_event[i].tstate=tstate;
+    frame_event[i].type=type;
+    frame_events++;
+}
+
+static void BuildFrameEvents(Z80Regs * regs)
+{
+    int screen = ( model<ZX_128 ? TIMING_48+1 : TIMING_128+1 );
+
+    frame_events=0;
+    ScheduleFrameEvent(regs->IPeriod - regs->IIntTime, EV_INT_END);
+    ScheduleFrameEvent(screen - EV_GUARD, EV_SCREEN_START);
+    ScheduleFrameEvent(screen + 192*hwopt.ts_line, EV_SCREEN_END);
+    ScheduleFrameEvent(regs->IPeriod - EV_GUARD - 1, EV_FRAME_END);
+}
+
+/* the core for the stretch that ends at an event of this type */
+static Z80Core EventCore(int type)
+{
+    if (type == EV_INT_END)             // Trying interruption
+        return Z80Run_NC;
+    if (type == EV_SCREEN_END &&        // All screen
+        mconfig.contention==1 && !(mconfig.speed_loading && tape_playing))
+        return Z80Run;
+    return Z80Run_NCNI;                 // upper and lower border
+}
+
+/* run core for cycles T-states, or up to the next tape edge, which is
+   let through; returns the T-states run, across the wrap too */
+static int RunSlice(Z80Core core, int cycles)
+{
+    int icount = spectrumZ80->ICount, edge;
+
+    if(tape_playing)
+    {
+        edge = loader_next_edge(spectrumZ80);
+        if(edge < cycles)
+            cycles = edge > 1 ? edge : 1;
+    }
+    tape_reschedule = 0;
+    core(spectrumZ80, cycles);
+    if(tape_playing)
+        loader(spectrumZ80);
+
+    icount -= spectrumZ80->ICount;
+    return icount < 0 ? icount + spectrumZ80->IPeriod : icount;
+}
+
+/* run from wherever the last event left the Z80 up to event n */
+static void RunToEvent(int n)
+{
+    int tstates;
+
+    while((tstates = frame_event[n].tstate -
+           (spectrumZ80->IPeriod - spectrumZ80->ICount)) > 0)
+        RunSlice(EventCore(frame_event[n].type), tstates);
+}
+
+/*-----------------------------------------------------------------
+ Run a frame, drawing the screen and the border as it goes unless
+ do_skip.
+------------------------------------------------------------------*/
+
+void
+JustRun(Z80Regs * regs, int do_skip)
+{
+    int i, cycles;
+
+    outwrites=0;
+    if(!do_skip)
+        StartBeam();
+
+    BuildFrameEvents(spectrumZ80);
+    for(i=0;i<frame_events;i++)
+    {
+        RunToEvent(i);
+        switch(frame_event[i].type)
+        {
+            case EV_SCREEN_END:
+                // the lower border's writes aren't timed
+                CatchUpScreen(spectrumZ80->IPeriod - spectrumZ80->ICount);
+                break;
+
+            case EV_FRAME_END:              // end & try interrupt
+                if(!do_skip)
+                    FinishBeam();
+                for(cycles=spectrumZ80->ICount;cycles>0;)
+                    cycles -= RunSlice(Z80Run_NC, cycles);
+                break;
         }
     }
 }
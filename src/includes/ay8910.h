@@ -5,6 +5,18 @@
  */
 
 extern int sound_enabled;
+extern int ay_is_in_use;
+extern int ay_change_count;     /* sound changes logged this frame */
+extern int beep_change_count;
+
+/* the generators, saved with the registers by ZX_StateSave() */
+extern unsigned char sound_ay_registers[16];
+extern unsigned int ay_tone_tick[3],ay_tone_high[3],ay_noise_tick;
+extern unsigned int ay_tone_subcycles,ay_env_subcycles;
+extern unsigned int ay_env_internal_tick,ay_env_tick;
+extern unsigned int ay_tone_period[3],ay_noise_period,ay_env_period;
+extern int rng,noise_toggle;
+extern int env_first,env_rev,env_counter;
 extern int sound_freq;
 extern int sound_stereo;
 extern int sound_stereo_beeper;
@@ -272,3 +272,11 @@ unsigned char fdc_read_data(void);
 void fdc_init (int a, int b);
 void fdc_motor(unsigned char on);
 int dsk_load (void *pchFileName);
+
+extern t_FDC FDC;
+extern t_track *active_track;
+
+//drives A and B of the selected machine, see ZX_SelectMachine
+extern t_drive *fdc_drives;
+#define driveA (fdc_drives[0])
+#define driveB (fdc_drives[1])
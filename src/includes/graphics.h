@@ -25,5 +25,22 @@
 extern char SpectrumFlashFlag;
 void DrawZXtoScreen(byte * target, byte * source, int scale, int align);
 void JustRun(Z80Regs * regs, int do_skip);
+void RedrawScreen(void);
+void CatchUpScreen(int tstate);
+void CatchUpBorder(int tstate);
+void CatchUpColours(int tstate);
+
+extern unsigned *Picture32;
+
+extern unsigned DirtyCells[2][24];
+extern byte CellRow[216];
+
+/* marks the cell a write at p is in if it's on screen 5 or 7 */
+#define SCREEN_WRITTEN(p) \
+    do { \
+        unsigned at_ = (unsigned)((p) - RAM_pages) - 0x4000*5; \
+        if((at_ & ~0x8000u) < 6912) \
+            DirtyCells[at_ >> 15][CellRow[(at_ & 0x1FFF) >> 5]] |= 1u << (at_ & 31); \
+    } while(0)
 
 #endif
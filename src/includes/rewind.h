@@ -0,0 +1,42 @@
+/*=====================================================================
+  rewind.h    -> Header file for rewind.c.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#ifndef REWIND_H
+#define REWIND_H
+
+#ifndef REWIND_SECONDS
+#define REWIND_SECONDS  30                  /* history kept at most */
+#endif
+#ifndef REWIND_BUDGET
+#define REWIND_BUDGET   (4*1024*1024)       /* bytes for it, the oldest frames go first */
+#endif
+
+#define REWIND_FPS      50
+#define REWIND_KEYFRAME (5*REWIND_FPS)      /* frames between whole states */
+
+int  rewind_init (int seconds, int budget);
+void rewind_free (void);
+void rewind_detach (void);
+void rewind_reset (void);
+void rewind_push (void);
+int  rewind_seek (int back);
+int  rewind_frames (void);
+int  rewind_used (void);
+
+#endif
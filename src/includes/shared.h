@@ -26,12 +26,15 @@ extern Z80Regs * spectrumZ80;
 
 #include "zxtape.h"
 
+#include "rewind.h"
+
 typedef struct
 {
 unsigned id;
 int zx_screen_mode;
 int battery_icon;
-int reserved[30];
+int runahead;                   //frames run ahead of the one heard, 0 off
+int reserved[29];
 int frameskip;
 int contention;
 int sound_volume;
@@ -28,8 +28,9 @@
 #define TYPE_SCR 6
 
 extern int fast_edge_loading;
+extern int tstates_prev_A;
 
-char LoadSP (Z80Regs *, void *);
+char LoadSP (Z80Regs *, void *, byte *);
 char LoadSNA48 (Z80Regs *, void *);
 char LoadSNA128 (Z80Regs *, void *);
 
@@ -42,6 +43,11 @@ char LoadSNA128 (Z80Regs *, void *);
 
 int  LoadZ80 (Z80Regs *, byte *, byte *);
 
+byte *MapFile(const char *name, long max, long *size);
+void UnmapFile(byte *p, long size);
+byte *GameBuffer(void);
+int  LoadGameFile(const char *name);
+
  int SaveSCR (void * fp);
 void LoadSCR (Z80Regs * regs, void * fp);
 
@@ -0,0 +1,35 @@
+/*=====================================================================
+  statewriter.h -> Header file for statewriter.c.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#ifndef STATEWRITER_H
+#define STATEWRITER_H
+
+enum
+{
+  STATE_WRITER_IDLE,
+  STATE_WRITER_BUSY,
+  STATE_WRITER_DONE,            /* on disk, told once */
+  STATE_WRITER_FAILED           /* told once, the old file is still there */
+};
+
+int  state_writer_start (void *data, int size, const char *name, const char *old_name);
+int  state_writer_poll (void);
+void state_writer_wait (void);
+
+#endif
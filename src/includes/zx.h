@@ -38,6 +38,7 @@ extern byte zx_ula64_palette[64];
   void ZX_Init(void);
   void ZX_Reset(int);
   void ZX_Frame(int);
+  void ZX_RunAhead(int frames, int do_skip);
   void ZX_Patch_ROM(void);
   void ZX_Unpatch_ROM(void);
 
@@ -48,18 +49,69 @@ extern byte zx_ula64_palette[64];
   void ZX_LoadGame(int preferred_model, unsigned long crc, int quick_if_possible);
 
 extern byte  kempston, fuller;
-extern byte  GAME[1*1024*1024]; extern long GAME_size;
+#define GAME_MAX (1*1024*1024)
+extern byte *GAME; extern long GAME_size; //the game being loaded, see LoadGameFile
 extern byte *MEMr[4]; //solid block of 16*4 = 64kb for reading
 extern byte *MEMw[4]; //solid block of 16*4 = 64kb for writing
-extern byte  RAM_dummy[16384*1];
-extern byte  RAM_pages[16384*16];
-extern byte  ROM_pages[16384*4];
+extern byte *RAM_dummy;
+extern byte *RAM_pages;       //16 pages, in the selected machine
+extern byte *ROM_pages;       //4 pages
+extern byte *DSK;             //disk image in drive A
+extern unsigned ram_written;  //bit n: RAM page n written, cleared by whoever reads it
+extern int vram_touched;      //screens changed other than by the Z80, drawn again
+
+//the ram_written bit for a write at p, above bit 15 for the dummy pages
+#define RAM_WRITTEN(p) (1u << ((unsigned)((p) - RAM_pages) >> 14))
 extern byte  model, pagination_128, pagination_plus2a, BorderColor;
 //extern byte  trap_rom_loading;
 extern byte tape_format;
 extern void  port_0x7ffd (byte);
-extern byte  cycles_delay[76000];
-extern unsigned short floating_bus[76000];
+/* ULA timing of the current model, set up by ZX_Reset. Contention, the
+   floating bus and when the ULA fetches a screen byte are all worked
+   out from the line of the screen and the position within it; the
+   contention itself is an 8 T-state pattern over the first 128
+   T-states of each of the 192 lines. */
+
+typedef struct
+{
+  int first;                    /* ICount at the first contended T-state */
+  unsigned length;              /* contended lines * line, 0 for none */
+  unsigned line;                /* T-states per scanline */
+  unsigned recip;               /* 2^24 / line, rounded up */
+  int screen;                   /* ICount when the ULA reads 0x4000 */
+  byte floating_bus;            /* the ULA fetches show on idle ports */
+  byte delay2;                  /* contention without a memory access */
+  const byte *delay;            /* by position & 7, 8 bytes */
+} ULATiming;
+
+extern ULATiming ula_timing;
+
+/* One emulated Spectrum. Machine state lives in globals while the machine
+   runs: every module lists its globals that belong to the machine rather
+   than to the host in a MachineVar table, and ZX_SelectMachine stores the
+   ones of the running machine and puts back those of the next. RAM, ROM,
+   the disk image and the rewind history are allocated per machine and
+   just repointed. GAME is a load workspace shared by all, so is the
+   frame_event[] list of graphics.c, which every frame builds anew. Any
+   number of machines can be kept and stepped in turn, ZX_Frame runs the
+   selected one; they are selected from one thread, never run from two
+   at once. */
+typedef struct
+{
+  void *data;
+  unsigned size;
+} MachineVar;
+
+#define MACHINE_VAR(v)  { (void *) &(v), sizeof (v) }
+
+extern MachineVar zx_vars[], z80_vars[], graphics_vars[], snaps_vars[],
+  ay_vars[], fdc_vars[], tape_vars[], rewind_vars[];
+
+typedef struct ZXMachine ZXMachine;
+
+ZXMachine *ZX_NewMachine (int model);          /* selected and reset */
+ZXMachine *ZX_SelectMachine (ZXMachine *);     /* NULL: the first one */
+void ZX_FreeMachine (ZXMachine *);
 extern byte  mic_on;
 
 //#define Z80MEMWRITE(where,A) *((byte *)(MEMw[where>>14]+(where&0x3FFF)))=A
@@ -72,6 +124,37 @@ extern byte  mic_on;
 extern int ZX_LoadState(void *mem);
 extern int ZX_SaveState(void *mem);
 
+/* In-memory states, see ZX_StateSave in zx.c: a run of chunks, each a
+   ZXChunk header and length bytes of data padded to 4. Only good for
+   the build that made them, take and put back between ZX_Frame calls. */
+enum
+{
+  ZX_CHUNK_ULA,                 /* model, paging, border: comes first */
+  ZX_CHUNK_CPU,                 /* Z80Regs */
+  ZX_CHUNK_AY,
+  ZX_CHUNK_ULAPLUS,             /* ULA64 palette */
+  ZX_CHUNK_FDC,                 /* +3 controller and drive A head */
+  ZX_CHUNK_RAM0,                /* RAM pages 0-7, those of the model */
+  ZX_CHUNK_RAM7 = ZX_CHUNK_RAM0 + 7,
+  ZX_CHUNKS
+};
+
+#define ZX_CHUNK(type)  (1u << (type))
+#define ZX_CHUNK_ALL    (ZX_CHUNK(ZX_CHUNKS) - 1)
+#define ZX_STATE_MAX    (8 * (16384 + 8) + 2048)   /* any state fits */
+
+typedef struct
+{
+  unsigned type;
+  unsigned length;
+} ZXChunk;
+
+int ZX_StateSize (unsigned chunks);
+int ZX_StateSave (void *buffer, int size, unsigned chunks);
+int ZX_StateLoad (const void *buffer, int size);
+int ZX_StateLoadChunks (const void *buffer, int size, unsigned chunks);
+const ZXChunk *ZX_StateFind (const void *buffer, int size, unsigned type);
+
 void port_0xfffd (byte value);
 void port_0xbffd (byte value);
 void port_0x1ffd (byte value);
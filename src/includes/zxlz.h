@@ -0,0 +1,37 @@
+/*=====================================================================
+  zxlz.h      -> Header file for zxlz.c.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#ifndef ZXLZ_H
+#define ZXLZ_H
+
+#define ZXLZ_MAGIC      "ZXLZ"
+#define ZXLZ_EXT        ".zxlz"
+#define ZXLZ_BLOCK      16384               /* bytes packed on their own */
+
+/* room zxlz_compress needs for n bytes at worst */
+#define ZXLZ_BOUND(n)   (4 + (n) + 4 * ((n) / ZXLZ_BLOCK + 1) + 4)
+
+int zxlz_block (unsigned char *out, const unsigned char *in, int n);
+int zxlz_end (unsigned char *out);
+int zxlz_compress (unsigned char *out, const unsigned char *in, int n);
+int zxlz_is (const unsigned char *in, int length);
+int zxlz_size (const unsigned char *in, int length);
+int zxlz_uncompress (unsigned char *out, int size, const unsigned char *in, int length);
+
+#endif
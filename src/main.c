@@ -64,6 +64,8 @@
 //#include "fdc.h"
 #include "empty_dsk.h"
 #include "shared.h"
+#include "statewriter.h"
+#include "zxlz.h"
 
 #if defined(IPHONE)
 char globalpath[247]="/var/mobile/Media/ROMs/iXpectrum/";
@@ -90,8 +92,7 @@ extern int full_screen;
 
 char * get_name(char *name);
 
-extern byte  DSK[1*1024*1024];
-extern t_drive driveA;
+extern byte *DSK;
 extern t_FDC FDC;
 extern t_track *active_track;
 
@@ -127,6 +128,8 @@ int dsk_format ();
 #define DEFAULT_SPEED_NOFSNC 250
 #define DEFAULT_SPEED_FS1NC 250
 
+#define RUNAHEAD_MAX 3 // frames que ofrece el menu
+
 struct
 {
     unsigned header;
@@ -429,6 +432,9 @@ void __v_putchar( unsigned x, unsigned y, int color, unsigned char ch) // rutina
 
     font = &msx[ (int)ch * 8];
     p = &video_screen8[y*320+x];
+#ifdef __I386__
+    video_overlay(x, y, 8, 8);
+#endif
     if (col != col2 && col2 != -1 )
     {
         for (i = 0; i < 8; i++, font++)
@@ -556,6 +562,9 @@ void mask_out(int  x,int y)
 {
     int n, m;
     volatile unsigned char *p,*p2,v;
+#ifdef __I386__
+    video_overlay(x, y, 32*8, 11*8);
+#endif
     for(n = 0;n<11*8;n++)
     {
         p = &video_screen8[(y+n)*320+x];
@@ -872,7 +881,8 @@ void read_list_rom()
                       is_ext(files[nfiles].file,".sp")  ||
                       is_ext(files[nfiles].file,".dsk") ||
                       is_ext(files[nfiles].file,".sav") ||
-                      is_ext(files[nfiles].file,".bz2")
+                      is_ext(files[nfiles].file,".bz2") ||
+                      is_ext(files[nfiles].file,ZXLZ_EXT)
 #if defined( USE_ZIP) || defined( USE_ZLIB)
                      ||
                      is_ext(files[nfiles].file,".zip")
@@ -938,13 +948,98 @@ int zip_load(char *name);
 byte  scrbuff[2*16*16384 * 2]; //TODO He aumentado el buffer * 2 ver porque petaba antes los z80 al cargarlos
 char last_rom_name[512];
 
-int load_scr(char *name, byte * buffer, int size)
+// lee un fichero .zxlz entero, devuelve lo desempaquetado (con malloc) o NULL
+unsigned char *zxlz_read(FILE *fp, int *size)
 {
+    unsigned char *packed, *data = NULL;
+    int n;
+
+    fseek(fp,0,SEEK_END);
+    n = ftell(fp);
+    fseek(fp,0,SEEK_SET);
+    packed = malloc(n);
+    if (packed == NULL) return NULL;
+    if ((int)fread(packed,1,n,fp) == n && (*size = zxlz_size(packed,n)) >= 0)
+    {
+        data = malloc(*size + 1);
+        if (data != NULL && zxlz_uncompress(data,*size,packed,n) != *size) {free(data);data = NULL;}
+    }
+    free(packed);
+    return data;
+}
+
+// lee size bytes de un .zxlz en buffer, devuelve los leidos
+int zxlz_load(FILE *fp, byte *buffer, int size)
+{
+    unsigned char *data;
+    int n;
+
+    data = zxlz_read(fp,&n);
+    if (data == NULL) return 0;
+    if (n > size) n = size;
+    memcpy(buffer,data,n);
+    free(data);
+    return n;
+}
+
+// los .sav se graban con zxlz, los de antes van en bzip2
+typedef struct
+{
+    BZFILE *bzip;
+    unsigned char *data;
+    int size, pos;
+} SAVFILE;
+
+void sav_open(SAVFILE *sav, FILE *fp)
+{
+    unsigned char magic[4];
+    int bzip_err = 0;
+
+    memset(sav,0,sizeof(*sav));
+    if (fread(magic,1,4,fp) == 4 && zxlz_is(magic,4))
+    {
+        sav->data = zxlz_read(fp,&sav->size);
+        return;
+    }
+    fseek(fp,0,SEEK_SET);
+    sav->bzip = BZ2_bzReadOpen( &bzip_err, fp, 0, 1, NULL, 0 );
+}
+
+int sav_read(SAVFILE *sav, void *buffer, int size)
+{
+    int bzip_err = 0;
+
+    if (sav->bzip) return BZ2_bzRead (&bzip_err, sav->bzip, buffer, size);
+    if (size > sav->size - sav->pos) size = sav->size - sav->pos;
+    if (sav->data) memcpy(buffer,sav->data + sav->pos,size);
+    sav->pos += size;
+    return size;
+}
+
+void sav_close(SAVFILE *sav)
+{
+    int bzip_err = 0;
+
+    if (sav->bzip) BZ2_bzReadClose (&bzip_err, sav->bzip);
+    free(sav->data);
+    memset(sav,0,sizeof(*sav));
+}
+
+// la vista previa: sin comprimir se mapea el fichero, si no va a scrbuff.
+// Devuelve donde esta y en length cuanto, NULL si no se puede leer
+byte *load_scr(char *name, long *length)
+{
+    static byte *scr = NULL, *scr_map = NULL;
+    static long scr_length = 0;
     FILE *fp;
 
-    if(strcmp(name,last_rom_name)==0)return 0;
+    if(strcmp(name,last_rom_name)==0) {*length = scr_length;return scr;}
     strcpy(last_rom_name,name);
 
+    UnmapFile(scr_map, scr_length);
+    scr = scr_map = NULL;
+    *length = scr_length = 0;
+
 	//if(zx_ula64_enabled !=0 && (mconfig.ula64 == 1 || mconfig.ula64 == 0))
     if(zx_ula64_enabled !=0 && (mconfig.ula64 != 2))
 	{
@@ -953,28 +1048,43 @@ int load_scr(char *name, byte * buffer, int size)
 	}
 
     fp = fopen(name,"rb");
-    if (fp == NULL) return 1;
+    if (fp == NULL) return NULL;
 
 #if defined( USE_ZIP) || defined( USE_ZLIB)
     if (is_ext (name, ".zip"))
     {
-        zip_load(name); return 0;
+        zip_load(name); *length = scr_length = sizeof(scrbuff); return scr = scrbuff;
     }
 #endif
-    if (is_ext (name, ".bz2"))
+    if (is_ext (name, ZXLZ_EXT))
+    {
+        scr_length = zxlz_load(fp, scrbuff, sizeof(scrbuff));
+        fclose(fp);
+    }
+    else if (is_ext (name, ".bz2"))
     {
         BZFILE * my_bzip;
         int bzip_err = 0;
 
         my_bzip = BZ2_bzReadOpen( &bzip_err, fp, 0, 1, NULL, 0 );
-        BZ2_bzRead (&bzip_err, my_bzip, buffer, size);
+        scr_length = BZ2_bzRead (&bzip_err, my_bzip, scrbuff, sizeof(scrbuff));
         BZ2_bzReadClose (&bzip_err, my_bzip);
         fclose(fp);
-        return 0;
+        if (scr_length < 0) scr_length = 0;
     }
-    fread(buffer, 1, size, fp);
-    fclose(fp);
-    return 0;
+    else if ((scr_map = MapFile(name, sizeof(scrbuff), &scr_length)) != NULL)
+    {
+        fclose(fp);
+        *length = scr_length;
+        return scr = scr_map;
+    }
+    else
+    {
+        scr_length = fread(scrbuff, 1, sizeof(scrbuff), fp);
+        fclose(fp);
+    }
+    *length = scr_length;
+    return scr = scrbuff;
 }
 
 
@@ -990,21 +1100,20 @@ int load_savsrc(char *name, byte * buffer, int size)
     fp = fopen(name,"rb");
     if (fp == NULL) return 1;
 
-    BZFILE * my_bzip;
-    int bzip_err = 0;
+    SAVFILE sav;
 
 
-    my_bzip = BZ2_bzReadOpen( &bzip_err, fp, 0, 1, NULL, 0 );
+    sav_open(&sav, fp);
 
-    BZ2_bzRead (&bzip_err, my_bzip, (void *)&state_header, sizeof(state_header));
+    sav_read(&sav, (void *)&state_header, sizeof(state_header));
 
-    if (state_header.header != 0x12345678) {BZ2_bzReadClose (&bzip_err, my_bzip);fclose(fp);return 0;}
+    if (state_header.header != 0x12345678) {sav_close(&sav);fclose(fp);return 0;}
 
     if(state_header.ulaplus[0]=='u' && state_header.ulaplus[1]=='l' && state_header.ulaplus[2]=='a'
        && state_header.ulaplus[3]=='6' && state_header.ulaplus[4]=='4' )
 
     {
-    	BZ2_bzRead (&bzip_err, my_bzip, (void *)&ula64colors, 64);
+    	sav_read(&sav, (void *)&ula64colors, 64);
     	if(mconfig.ula64 != 2)
     	{
    	      zx_ula64_enabled = 1;
@@ -1038,11 +1147,11 @@ int load_savsrc(char *name, byte * buffer, int size)
     if (state_header.have_fd_info == 1)
     {
     	byte tmp[4+4+4+4+ sizeof (t_FDC)+sizeof (t_track)];
-    	BZ2_bzRead (&bzip_err, my_bzip, (void *) &tmp,sizeof(tmp));
+    	sav_read(&sav, (void *) &tmp,sizeof(tmp));
     }
 
-    BZ2_bzRead (&bzip_err, my_bzip, buffer, size);
-    BZ2_bzReadClose (&bzip_err, my_bzip);
+    sav_read(&sav, buffer, size);
+    sav_close(&sav);
     fclose(fp);
     return 0;
 
@@ -1133,13 +1242,15 @@ int get_rom(int tape)
         if (!files[posfile].is_directory)
         {
             int l  = strlen(files[posfile].file);
+            byte *scr;
+            long scr_length;
 
 
-            if ( !strcasecmp(files[posfile].file+l-4,".sna") || !strcasecmp(files[posfile].file+l-8,".sna.bz2") )
+            if ( !strcasecmp(files[posfile].file+l-4,".sna") || !strcasecmp(files[posfile].file+l-8,".sna.bz2") || !strcasecmp(files[posfile].file+l-9,".sna"ZXLZ_EXT) )
             {
-                if (!load_scr(files[posfile].file, scrbuff, sizeof(scrbuff)))
+                if ((scr = load_scr(files[posfile].file, &scr_length)) != NULL && scr_length >= 27+6912)
                 {
-                    DrawZXtoScreen(video_screen8, &scrbuff[27], scale, 2);
+                    DrawZXtoScreen(video_screen8, &scr[27], scale, 2);
                 }
             }
             else if ( !strcasecmp(files[posfile].file+l-4,".sav") )
@@ -1157,28 +1268,28 @@ int get_rom(int tape)
 
                 }
              }
-            if ( !strcasecmp(files[posfile].file+l-3,".sp") || !strcasecmp(files[posfile].file+l-7,".sp.bz2") )
+            if ( !strcasecmp(files[posfile].file+l-3,".sp") || !strcasecmp(files[posfile].file+l-7,".sp.bz2") || !strcasecmp(files[posfile].file+l-8,".sp"ZXLZ_EXT) )
             {
-                if (!load_scr(files[posfile].file, scrbuff, sizeof(scrbuff)))
+                if ((scr = load_scr(files[posfile].file, &scr_length)) != NULL && scr_length >= 38+6912)
                 {
-                   DrawZXtoScreen(video_screen8, &scrbuff[38], scale, 2);
+                   DrawZXtoScreen(video_screen8, &scr[38], scale, 2);
                 }
             }
             else
-            if ( !strcasecmp(files[posfile].file+l-4,".z80") || !strcasecmp(files[posfile].file+l-8,".z80.bz2") )
+            if ( !strcasecmp(files[posfile].file+l-4,".z80") || !strcasecmp(files[posfile].file+l-8,".z80.bz2") || !strcasecmp(files[posfile].file+l-9,".z80"ZXLZ_EXT) )
             {
-                if (!load_scr(files[posfile].file, scrbuff, sizeof(scrbuff)))
+                if ((scr = load_scr(files[posfile].file, &scr_length)) != NULL && scr_length >= 87)
                 {
-                    if ((scrbuff[6] != 0)||(scrbuff[7] != 0))
+                    if ((scr[6] != 0)||(scr[7] != 0))
                     {
-                        UncompressZ80 (&scrbuff[512*1024], (scrbuff[12] & 0x20) ? 1 /*Z80BL_V1COMPRE*/ : 0/*Z80BL_V1UNCOMP*/, 0, NULL, &scrbuff[30]);
+                        UncompressZ80 (&scrbuff[512*1024], (scr[12] & 0x20) ? 1 /*Z80BL_V1COMPRE*/ : 0/*Z80BL_V1UNCOMP*/, scr_length-30, NULL, &scr[30]);
                         DrawZXtoScreen(video_screen8, &scrbuff[512*1024], scale, 2);
                     }
                     else
                     {
                         int f, tam, sig, ver = 0, scr_page = 0, hdr_sz;
                         byte pag;
-                        byte *source=(byte *)scrbuff;
+                        byte *source=scr;
 
                         hdr_sz = source[30] + source[31] * 256 ;
                         switch(hdr_sz)
@@ -1231,7 +1342,8 @@ int get_rom(int tape)
 
                         for (f = 0; f < 16 ; f++) //up 16 pages (ZS Scorpion)
                         {
-                            source=&scrbuff[sig];
+                            if (sig + 3 > scr_length) break;
+                            source=&scr[sig];
                             tam = *(source++) ;
                             tam += (*(source++)) * 256 ;
                             pag = *(source++);
@@ -1239,6 +1351,7 @@ int get_rom(int tape)
                                 sig += ( 3 + 16384 );
                             else
                                 sig += ( 3 + tam );
+                            if (sig > scr_length) break;
 
                             if (pag == scr_page)
                             {
@@ -2335,6 +2448,7 @@ int disk_manager()
 }
 
 void tape_browser(void);
+void rewind_browser(void);
 
 /****************************************************************************************************************/
 // config screen
@@ -2376,7 +2490,7 @@ int Config_SCR()
         ClearScreen(COLORFONDO);speccy_corner();
 
         v_putcad(14,1,132,"CONFIGURATION");
-        if (model == ZX_PLUS3) y = 3; else y = 4;
+        if (model == ZX_PLUS3) y = 2; else y = 3;
 
         //opcion 0
         if (op == 0) COLORFONDO = 129; else COLORFONDO = 128;
@@ -2410,6 +2524,17 @@ int Config_SCR()
             v_putcad(10,y,130,"Ula+64 without Color Reset");y += 1;
         }
 
+        //opcion 5
+        if (op == 5) COLORFONDO = 129; else COLORFONDO = 128;
+        sprintf(menustring,"Rewind (%i s kept)",rewind_frames() / REWIND_FPS);
+        v_putcad(10,y,130,menustring);y += 1;
+
+        //opcion 6
+        if (op == 6) COLORFONDO = 129; else COLORFONDO = 128;
+        if (mconfig.runahead) sprintf(menustring,"Run-ahead %i Frames",mconfig.runahead);
+        else sprintf(menustring,"Run-ahead OFF");
+        v_putcad(10,y,130,menustring);y += 1;
+
         //if (mconfig.ula64_reset) v_putcad(10,y,130,"Ula64 Reset ON");
         //else v_putcad(10,y,130,"Ula64 Reset OFF"); y += 1;
 
@@ -2494,7 +2619,6 @@ int Config_SCR()
         sprintf(menustring,"Sound Rate %i KHz",mconfig.sound_freq);
         v_putcad(10,y,130,menustring);y += 1;
 
-        y += 1;///SALTO
         //opcion 18
         if (op == 18) COLORFONDO = 129; else COLORFONDO = 128;
         if (mconfig.speed_loading)
@@ -2580,13 +2704,13 @@ int Config_SCR()
             else if (!(g & 1)) g = 1;
             else {g += 2;if (g>81) {g = 69; new_key |= JOY_BUTTON_DOWN;}}
         }
-        if (new_key & JOY_BUTTON_UP) {op--;if (model != ZX_PLUS3 && op == 11) op = 4; if (model == ZX_PLUS3 && op == 8) op = 4;if (op<0) op = 25;
+        if (new_key & JOY_BUTTON_UP) {op--;if (model != ZX_PLUS3 && op == 11) op = 6; if (model == ZX_PLUS3 && op == 8) op = 6;if (op<0) op = 25;
 #if defined(IPHONE) || defined(ANDROID)
         if(op==23)op--;
 #endif
         }
 
-        if (new_key & JOY_BUTTON_DOWN) {op++;if (model != ZX_PLUS3 && op == 5) op = 12; if (model == ZX_PLUS3 && op == 5) op = 9; if (op>25) op = 0;
+        if (new_key & JOY_BUTTON_DOWN) {op++;if (model != ZX_PLUS3 && op == 7) op = 12; if (model == ZX_PLUS3 && op == 7) op = 9; if (op>25) op = 0;
 #if defined(IPHONE) || defined(ANDROID)
         if(op==23)op++;
 #endif
@@ -2734,6 +2858,9 @@ int Config_SCR()
                     mconfig.ula64 = 0;
             }
 
+            if (op == 5) {rewind_browser();break;}
+            if (op == 6) {mconfig.runahead = (mconfig.runahead + 1) % (RUNAHEAD_MAX + 1);}
+
             if (op == 9) {load_empty_dsk();dsk_load((void *) DSK);break;}
             if (op == 10) {if (driveA.sides) {dsk_flipped ^= 1;driveA.flipped = dsk_flipped;} else driveA.flipped = 0;}
             if (op == 11) {disk_manager();}
@@ -3136,6 +3263,7 @@ int display_keyboard()
                 case 4:ZX_Reset(ZX_PLUS3);dsk_load((void *) DSK);break;
                 default:ZX_Reset(ZX_48);break;
             }
+            rewind_reset();
             menu_mode = 0;
         }
         return -1;
@@ -3314,6 +3442,11 @@ int zip_load(char *name)
     	return -2;
     }
 
+    if (GameBuffer() == NULL || file_info.uncompressed_size > GAME_MAX)
+    {
+    	unzClose(uf);
+    	return -2;
+    }
     GAME_size = file_info.uncompressed_size;
     err = unzOpenCurrentFile(uf);
     if (err!=UNZ_OK)
@@ -3470,6 +3603,7 @@ int zip_load(char *name)
 
     zip_stat_index(za, idx , 0, &st);
 
+    if (GameBuffer() == NULL || st.size > GAME_MAX) {zip_close(za);return -2;}
     GAME_size = st.size;
     //st.crc;
 
@@ -3513,69 +3647,70 @@ int load_game(char *name)
         zip_load(name); return 0;
     }
 #endif
+    if (is_ext (name, ZXLZ_EXT))
+    {
+        if (GameBuffer() != NULL) GAME_size = zxlz_load(fp, GAME, GAME_MAX);
+        fclose(fp);
+        return 0;
+    }
     if (is_ext (name, ".bz2"))
     {
         BZFILE * my_bzip;
         int bzip_err = 0;
         int n,m;
 
+        if (GameBuffer() == NULL) {fclose(fp);return 0;}
         my_bzip = BZ2_bzReadOpen( &bzip_err, fp, 0, 1, NULL, 0 );
 
-        GAME_size = BZ2_bzRead (&bzip_err, my_bzip, GAME, 1*1024*1024);
+        GAME_size = BZ2_bzRead (&bzip_err, my_bzip, GAME, GAME_MAX);
 
         BZ2_bzReadClose (&bzip_err, my_bzip);
         fclose(fp);
         return 0;
     }
-    fseek(fp,0,SEEK_END);
-    GAME_size = ftell(fp);
-    fseek(fp,0,SEEK_SET);
-    fread(GAME, 1, GAME_size, fp);
     fclose(fp);
+    LoadGameFile(name); // sin comprimir se mapea y se lee alli mismo
     return 0;
 }
 
-int compress_rom(char *name)
+int compress_rom(char *name) // con zxlz, mucho mas rapido que bzip2; los .bz2 se siguen leyendo
 {
     int i,n,m;
     char filename[256];
-    BZFILE * my_bzip;
-    int bzip_err = 0;
-    char *temp;
-    FILE *fp, *fp_bzip;
+    char *temp, *packed;
+    FILE *fp, *fp_zxlz;
     strcpy(filename,name);
 
     temp = malloc(1024*2048);
     if (!temp) return -3;
+    packed = malloc(ZXLZ_BOUND(1024*2048));
+    if (!packed) {free(temp);return -3;}
 
-    strcat(filename,".bz2");
+    strcat(filename,ZXLZ_EXT);
 
     fp = fopen(name, "rb");
-    if (fp ==  NULL) {free(temp);return -1;}
+    if (fp ==  NULL) {free(temp);free(packed);return -1;}
 
-    fp_bzip = fopen(filename, "wb");
-    if (fp_bzip ==  NULL) {free(temp);fclose(fp);return -2;}
+    fp_zxlz = fopen(filename, "wb");
+    if (fp_zxlz ==  NULL) {free(temp);free(packed);fclose(fp);return -2;}
 
     fseek(fp,0,SEEK_END);
     m = ftell(fp);
     fseek(fp,0,SEEK_SET);
-    if (m>(1024*2048)) {free(temp);fclose(fp);fclose(fp_bzip);return -3;}
+    if (m>(1024*2048)) {free(temp);free(packed);fclose(fp);fclose(fp_zxlz);return -3;}
     n = fread(temp,1,m,fp);
     fclose(fp);
-    if (n<m) {free(temp);fclose(fp_bzip);return -4;}
-
-    my_bzip = BZ2_bzWriteOpen( &bzip_err, fp_bzip, 4, 0,30);
-    if (bzip_err != BZ_OK)  {free(temp);fclose(fp_bzip);return -5;}
+    if (n<m) {free(temp);free(packed);fclose(fp_zxlz);return -4;}
 
-    BZ2_bzWrite (&bzip_err, my_bzip, temp,  m);
-    i = bzip_err;
-    BZ2_bzWriteClose (&bzip_err, my_bzip,0,(void*)&n,(void*)&m);
-    fclose(fp_bzip);
+    n = zxlz_compress((unsigned char *)packed, (unsigned char *)temp, m);
+    i = (int)fwrite(packed,1,n,fp_zxlz) == n;
+    if (fclose(fp_zxlz) != 0) i = 0;
     free(temp);
+    free(packed);
 #ifndef SPMP
     sync();
 #endif
-    if (i != BZ_OK || bzip_err != BZ_OK)
+    if (!i)
     {
         remove(filename);
         return -5;
@@ -3592,31 +3727,23 @@ t_track  track_temp;
 #define SUMA_PUNT(a) if ((int) a != -1)  a += (unsigned) DSK; else a = (void*)/*(unsigned)*/ 0
 int save_state(int st)
 {
-    FILE * fp; unsigned char *mem;
-    int count,n,m;
+    unsigned char *mem, *p;
+    int n;
     char *mname;
     char savefile[256];
     char old_savefile[256];
-    BZFILE * my_bzip;
-    int bzip_err = 0;
-    int file_error = 0;
 
     mname = get_name(MY_filename);
     // obten nombre sin extension
     n = 0;while(mname[n] != 0) n++;
     while(n>0) {if (mname[n] == '.') {mname[n] = 0;break;} n--;}
 
-	sprintf(photo_name,"%s/saves/%s.tmp",globalpath,mname);
     sprintf(savefile,"%s/saves/%s.sav",globalpath,mname);
     sprintf(old_savefile,"%s/saves/%s-old.sav",globalpath,mname);
-    fp = fopen(photo_name,"wb");
-    if (fp == NULL) return 0;
 
-    my_bzip = BZ2_bzWriteOpen( &bzip_err, fp, 4, 0,30);
-    if (bzip_err != BZ_OK)  {fclose(fp);return 0;}
-
-    mem = (unsigned char*) malloc(16384*16+SIZEOFZ80REGS+100);
-    if (mem == NULL) {BZ2_bzWriteClose (&bzip_err, my_bzip,0,(void*)&n,(void*)&m);fclose(fp);return 0;}
+    // el estado se copia a memoria aqui, statewriter.c lo comprime y graba sin parar el juego
+    mem = (unsigned char*) malloc(sizeof(state_header)+64+4*4+sizeof(t_FDC)+sizeof(t_track)+16384*16+SIZEOFZ80REGS+100);
+    if (mem == NULL) return 0;
 
     state_header.header = 0x12345678;
 
@@ -3636,63 +3763,41 @@ int save_state(int st)
     else
     	strcpy((void*)state_header.ulaplus,"nope");
 
-    BZ2_bzWrite (&bzip_err, my_bzip, (void *)&state_header,  sizeof(state_header));
+    p = mem;
+    memcpy(p, &state_header, sizeof(state_header)); p += sizeof(state_header);
 
-
-    if (bzip_err != BZ_OK) {file_error = 1;}
-    else
+    if(zx_ula64_enabled)
     {
-        if(zx_ula64_enabled)
-        {
-        	  BZ2_bzWrite (&bzip_err, my_bzip, (void *)&zx_ula64_palette,64);
-        }
+        memcpy(p, zx_ula64_palette, 64); p += 64;
+    }
 
-    	if (state_header.have_fd_info == 1)
-        {
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &driveA.current_track,  4);
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &driveA.current_side,  4);
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &driveA.current_sector,  4);
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &driveA.flipped,  4);
-            RESTA_PUNT(FDC.buffer_ptr);
-            RESTA_PUNT(FDC.buffer_endptr);
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &FDC,  sizeof (t_FDC));
-            SUMA_PUNT(FDC.buffer_ptr);
-            SUMA_PUNT(FDC.buffer_endptr);
-            if (active_track) memcpy(&track_temp,active_track,sizeof (t_track)); else memset(&track_temp,0,sizeof (t_track));
-            RESTA_PUNT(track_temp.data);
-            for(n = 0;n<(int)track_temp.sectors;n++)
-            {
-                RESTA_PUNT(track_temp.sector[n].data);
-            }
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *) &track_temp,  sizeof (t_track));
-            //if (bzip_err != BZ_OK) {file_error = 1;}
-        }
-        if (!file_error)
+    if (state_header.have_fd_info == 1)
+    {
+        memcpy(p, &driveA.current_track, 4); p += 4;
+        memcpy(p, &driveA.current_side, 4); p += 4;
+        memcpy(p, &driveA.current_sector, 4); p += 4;
+        memcpy(p, &driveA.flipped, 4); p += 4;
+        RESTA_PUNT(FDC.buffer_ptr);
+        RESTA_PUNT(FDC.buffer_endptr);
+        memcpy(p, &FDC, sizeof (t_FDC)); p += sizeof (t_FDC);
+        SUMA_PUNT(FDC.buffer_ptr);
+        SUMA_PUNT(FDC.buffer_endptr);
+        if (active_track) memcpy(&track_temp,active_track,sizeof (t_track)); else memset(&track_temp,0,sizeof (t_track));
+        RESTA_PUNT(track_temp.data);
+        for(n = 0;n<(int)track_temp.sectors;n++)
         {
-            count = ZX_SaveState(mem);
-
-            BZ2_bzWrite (&bzip_err, my_bzip, (void *)mem,  count);
-            if (bzip_err != BZ_OK) {file_error = 1;}
+            RESTA_PUNT(track_temp.sector[n].data);
         }
+        memcpy(p, &track_temp, sizeof (t_track)); p += sizeof (t_track);
     }
 
-    BZ2_bzWriteClose (&bzip_err, my_bzip,0,(void*)&n,(void*)&m);
-    if (bzip_err != BZ_OK) {file_error = 1;}
-    fclose(fp);
-    if (!file_error)
-    {
+    p += ZX_SaveState(p);
 
-        //remove(savefile);
-    	remove(old_savefile);
-    	rename(savefile,old_savefile);
-        rename(photo_name,savefile);
+    if (!state_writer_start(mem, p - mem, savefile, old_savefile))
+    {
+        free(mem);
+        return 0;
     }
-    else remove(photo_name);
-#ifndef SPMP
-    sync();
-#endif
-
-    free(mem);
 
     return 1;
 }
@@ -3711,9 +3816,10 @@ int load_state(int st)
 
     char *mname;
 
-    BZFILE * my_bzip;
-    int bzip_err = 0;
+    SAVFILE sav;
     int n;
+    state_writer_wait(); // si se esta grabando, que acabe
+
     mname = get_name(MY_filename);
     // obten nombre sin extension
     n = 0;while(mname[n] != 0) n++;
@@ -3724,27 +3830,27 @@ int load_state(int st)
     fp = fopen(photo_name,"rb");
     if (fp == NULL) return 0;
 
-    my_bzip = BZ2_bzReadOpen( &bzip_err, fp, 0, 1, NULL, 0 );
+    sav_open(&sav, fp);
 
-    size = BZ2_bzRead (&bzip_err, my_bzip, (void *)&state_header, sizeof(state_header));
+    size = sav_read(&sav, (void *)&state_header, sizeof(state_header));
 
-    if (state_header.header != 0x12345678) {BZ2_bzReadClose (&bzip_err, my_bzip);fclose(fp);return 0;}
+    if (state_header.header != 0x12345678) {sav_close(&sav);fclose(fp);return 0;}
 
     if(state_header.ulaplus[0]=='u' && state_header.ulaplus[1]=='l' && state_header.ulaplus[2]=='a'
        && state_header.ulaplus[3]=='6' && state_header.ulaplus[4]=='4')
     {
     	ula64=1;
-    	BZ2_bzRead (&bzip_err, my_bzip, (void *)&ula64Colors, 64);
+    	sav_read(&sav, (void *)&ula64Colors, 64);
     }
 
     if (state_header.have_fd_info == 1)
     {
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &disk_temp.current_track,  4);
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &disk_temp.current_side,  4);
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &disk_temp.current_sector,  4);
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &disk_temp.flipped,  4);
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &FDC_temp,  sizeof (t_FDC));
-        BZ2_bzRead (&bzip_err, my_bzip, (void *) &track_temp,  sizeof (t_track));
+        sav_read(&sav, (void *) &disk_temp.current_track,  4);
+        sav_read(&sav, (void *) &disk_temp.current_side,  4);
+        sav_read(&sav, (void *) &disk_temp.current_sector,  4);
+        sav_read(&sav, (void *) &disk_temp.flipped,  4);
+        sav_read(&sav, (void *) &FDC_temp,  sizeof (t_FDC));
+        sav_read(&sav, (void *) &track_temp,  sizeof (t_track));
         SUMA_PUNT(track_temp.data);
         for(n = 0;n<(int)track_temp.sectors;n++)
         {
@@ -3753,11 +3859,11 @@ int load_state(int st)
     }
 
     mem = (unsigned char*) malloc(16384*16+SIZEOFZ80REGS+100);
-    if (mem == NULL) {BZ2_bzReadClose (&bzip_err, my_bzip);fclose(fp);return 0;}
+    if (mem == NULL) {sav_close(&sav);fclose(fp);return 0;}
 
-    size = BZ2_bzRead (&bzip_err, my_bzip, (void *)mem, 16384*16+SIZEOFZ80REGS+100);
+    size = sav_read(&sav, (void *)mem, 16384*16+SIZEOFZ80REGS+100);
 
-    BZ2_bzReadClose (&bzip_err, my_bzip);fclose(fp);
+    sav_close(&sav);fclose(fp);
     mJoystick = state_header.mJoystick;
     for(n = 0;n<12;n++) map_keys[n] = state_header.map_keys[n];
     if (map_keys[8] == 0) map_keys[8] = SPECKEY_SHIFT;
@@ -3784,6 +3890,7 @@ int load_state(int st)
     {
         int code = 0;
         code = ZX_LoadState(mem);
+        rewind_reset();
 
         free(mem);
 
@@ -3920,6 +4027,7 @@ tape_browser()
             }
 
             ZX_LoadGame(-1,0,0);
+            rewind_reset();
             while(nKeys & (JOY_BUTTON_B | JOY_BUTTON_X)) nKeys = joystick_read(); // para quieto!!
             num_entries = tape_blocks_entries(block_entries,38);
             posfile = tape_get_current_block();
@@ -3951,6 +4059,48 @@ tape_browser()
 }
 
 
+void
+rewind_browser()
+{
+    char cad[256];
+    unsigned new_key = 0,old_key = 0;
+    int back = 0;
+    int step;
+
+    COLORFONDO = 128;
+    while(nKeys & JOY_BUTTON_B) nKeys = joystick_read(); // para quieto!!
+    while(1)
+    {
+        ClearScreen(COLORFONDO);
+        DrawZXtoScreen(video_screen8, &RAM_pages[0x4000 * (pagination_128 & 8 ? 7 : 5)], 0, 1);
+        sprintf(cad,"REWIND -%i.%02i s OF %i s",back / REWIND_FPS,back % REWIND_FPS * 100 / REWIND_FPS,rewind_frames() / REWIND_FPS);
+        v_putcad(1,1,132,cad);
+        v_putcad(1,26,132,"Left/Right a Frame, L/R a Second");
+        v_putcad(1,28,132,"B to Play from Here, X to Exit");
+
+        SyncFreq2();
+        dump_video();
+
+        nKeys = joystick_read();
+        new_key = nKeys & (~old_key);
+        old_key = nKeys;
+
+        if (new_key & JOY_BUTTON_B) break; // la emulacion sigue desde aqui
+        if (new_key & (JOY_BUTTON_X | JOY_BUTTON_MENU)) {rewind_seek(0);break;}
+
+        // mantener pulsado para ir frame a frame
+        step = 0;
+        if (old_key & JOY_BUTTON_LEFT) step = 1;
+        if (old_key & JOY_BUTTON_RIGHT) step = -1;
+        if (new_key & JOY_BUTTON_L) step = REWIND_FPS;
+        if (new_key & JOY_BUTTON_R) step = -REWIND_FPS;
+        if (step && rewind_frames()) back = rewind_seek(back + step);
+    }
+
+    while(nKeys & (JOY_BUTTON_A | JOY_BUTTON_B | JOY_BUTTON_X | JOY_BUTTON_Y | JOY_BUTTON_MENU)) nKeys = joystick_read();
+}
+
+
 unsigned oldtime = 0;
 unsigned fpstime = 0;
 unsigned autoskiptime = 0;
@@ -4108,6 +4258,7 @@ int main(int argc, char *argv[])
 
     unsigned time;
     int nvol = 0;
+    int nsaved = 0, saved = STATE_WRITER_IDLE;
     Z80Regs regs_z80;
     char *mname;
     FILE *fp;
@@ -4169,6 +4320,7 @@ int main(int argc, char *argv[])
     tape_init();
 
     ZX_Init();
+    rewind_init(REWIND_SECONDS, REWIND_BUDGET);
 
 
 
@@ -4247,11 +4399,13 @@ int main(int argc, char *argv[])
 
         //GAME_size = MyGameSize;
         if (ret != 666) ZX_LoadGame(ZX_128, /*MyGameCRC*/0, 0/*mQuick*/);
+        rewind_reset();
 
         skip = 0;
         count_fps = 0;
         count_fps_draw = 0;
         emulating = 1;
+        RedrawScreen(); // en la pantalla estaba la lista de juegos
         while(1)
         {
 #ifdef  CAPTURE
@@ -4263,9 +4417,16 @@ int main(int argc, char *argv[])
             }
 #endif
             Picture = video_screen8;
+#ifdef __I386__
+            Picture32 = video_screen32;
+#endif
             full_screen = tape_playing ? 0 : mconfig.zx_screen_mode;
             //full_screen =  mconfig.zx_screen_mode;
-            ZX_Frame(skip);
+            ZX_RunAhead(mconfig.runahead, skip);
+#ifdef __I386__
+            if (skip == 0) video_frame_drawn(); // lo que se pinte encima desde aqui es de los menus
+#endif
+            rewind_push();
 
             Sound_Loop();
 
@@ -4277,6 +4438,7 @@ int main(int argc, char *argv[])
             	if (Config_SCR() == 1) break;
             	//printf("Salida llamada a ConfigSCR\n");
             	emulating = 1;
+                RedrawScreen();
                 skip = 0;
                 prev_measure = 0;
                 frameskip = 0;
@@ -4312,6 +4474,9 @@ int main(int argc, char *argv[])
                 v_forcebreakcad = 0;
                 v_putcad(35,27,129,result);
 
+#ifdef __I386__
+                video_overlay(72, 217, (volume+1)/2*4, 6);
+#endif
                 for ( x = 0; x < volume; x++ )
                 {
                     for ( y = 217; y < 223; y++ )
@@ -4323,8 +4488,25 @@ int main(int argc, char *argv[])
                 }
                 COLORFONDO = tmp;
                 nvol--;
+                RedrawScreen();
             }
 #endif
+
+            // el estado se graba en segundo plano, avisa cuando esta en la tarjeta
+            n = state_writer_poll();
+            if (n != STATE_WRITER_IDLE) {saved = n; nsaved = (n == STATE_WRITER_BUSY) ? 1 : 50*2;}
+            if (nsaved != 0)
+            {
+                int tmp = COLORFONDO;
+
+                COLORFONDO = 134;
+                if (saved == STATE_WRITER_BUSY) v_putcad(2,25,129,"SAVING STATE...");
+                else if (saved == STATE_WRITER_DONE) v_putcad(2,25,129,"STATE SAVED");
+                else v_putcad(2,25,131,"STATE NOT SAVED");
+                COLORFONDO = tmp;
+                nsaved--;
+                RedrawScreen();
+            }
             if (mconfig.show_fps)
             {
                 if (getTicks() - fpstime > 1000)
@@ -4363,6 +4545,7 @@ int main(int argc, char *argv[])
                 v_putcad(0,0,129,result);
 #endif
                 COLORFONDO = tmp;
+                RedrawScreen();
             }
 
             cur_frame++;
@@ -4427,6 +4610,7 @@ int main(int argc, char *argv[])
 
                 COLORFONDO = tmp;
                 tape_stop_delay = 3000;
+                RedrawScreen();
             }
             else if (tape_stop_delay >= 0)
             {
@@ -4442,6 +4626,7 @@ int main(int argc, char *argv[])
                 v_putcad(x/8-5,y/8-2,131,"STOP");
 #endif
                 COLORFONDO = tmp;
+                RedrawScreen();
             }
 
             if (new_key & JOY_BUTTON_SELECT)
@@ -4562,7 +4747,10 @@ int main(int argc, char *argv[])
                 if(ext_keyboard)
                 	keyboard_on = 0;
                 else
+                {
             	    sel_key = display_keyboard();
+                    RedrawScreen();
+                }
 /*
                 if ((old_key & JOY_BUTTON_Y)&&(unprogram == 0))
                 {
@@ -4591,6 +4779,8 @@ int main(int argc, char *argv[])
             {
 #ifdef SPMP
                 dump_video_nosync();
+#elif defined(__I386__)
+                dump_video32();
 #else
                 dump_video();
 #endif
@@ -4608,6 +4798,7 @@ int main(int argc, char *argv[])
 
     save_mconfig();
 
+    state_writer_wait();
     tape_finish();
 
     sound_volume(70,70);
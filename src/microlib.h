@@ -64,6 +64,12 @@ extern unsigned char  *video_screen8;
 void dump_video();
 void dump_video_nosync(void);
 
+// SDL on a PC: a 32 bit screen, that shows Picture32
+extern unsigned       *video_screen32;
+void video_frame_drawn(void);
+void video_overlay(int x, int y, int w, int h);
+void dump_video32(void);
+
 //init,end, Seleuco
 void microlib_init();
 void microlib_end();
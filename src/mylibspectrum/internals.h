@@ -87,5 +87,9 @@ libspectrum_error
 libspectrum_bzip2_inflate( const libspectrum_byte *bzptr, size_t bzlength,
 			   libspectrum_byte **outptr, size_t *outlength );
 
+libspectrum_error
+libspectrum_zxlz_inflate( const libspectrum_byte *zxptr, size_t zxlength,
+			  libspectrum_byte **outptr, size_t *outlength );
+
 
 #endif				/* #ifndef LIBSPECTRUM_INTERNALS_H */
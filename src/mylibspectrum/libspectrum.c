@@ -43,6 +43,7 @@ static const char *MIN_GCRYPT_VERSION = "1.1.42";
 static const char *gcrypt_version;
 
 #include "internals.h"
+#include "zxlz.h"
 
 #if defined AMIGA || defined __MORPHOS__
 #include <proto/exec.h>
@@ -288,6 +289,7 @@ libspectrum_identify_file_raw( libspectrum_id_t *type, const char *filename,
 
       { LIBSPECTRUM_ID_COMPRESSED_BZ2,"bz2", 3, "BZh",		    0, 3, 4 },
       { LIBSPECTRUM_ID_COMPRESSED_GZ, "gz",  3, "\x1f\x8b",	    0, 2, 4 },
+      { LIBSPECTRUM_ID_COMPRESSED_ZXLZ,"zxlz",3, ZXLZ_MAGIC,	    0, 4, 4 },
 
       { LIBSPECTRUM_ID_TAPE_Z80EM,    "raw", 1, "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0Raw tape sample",  0, 64, 0 },
       { LIBSPECTRUM_ID_TAPE_CSW,      "csw", 2, "Compressed Square Wave\x1a",  0, 23, 4 },
@@ -408,6 +410,7 @@ libspectrum_identify_class( libspectrum_class_t *libspectrum_class,
   case LIBSPECTRUM_ID_COMPRESSED_BZ2:
   case LIBSPECTRUM_ID_COMPRESSED_GZ:
   case LIBSPECTRUM_ID_COMPRESSED_XFD:
+  case LIBSPECTRUM_ID_COMPRESSED_ZXLZ:
     *libspectrum_class = LIBSPECTRUM_CLASS_COMPRESSED; return 0;
 
   case LIBSPECTRUM_ID_DISK_DSK:
@@ -552,6 +555,24 @@ libspectrum_uncompress_file( unsigned char **new_buffer, size_t *new_length,
 
     break;
 
+  case LIBSPECTRUM_ID_COMPRESSED_ZXLZ:
+
+    if( new_filename && *new_filename ) {
+      if( strlen( *new_filename ) >= 5 &&
+	  !strcasecmp( &(*new_filename)[ strlen( *new_filename ) - 5 ],
+		       ZXLZ_EXT ) )
+	(*new_filename)[ strlen( *new_filename ) - 5 ] = '\0';
+    }
+
+    error = libspectrum_zxlz_inflate( old_buffer, old_length,
+				      new_buffer, new_length );
+    if( error ) {
+      if( new_filename ) free( *new_filename );
+      return error;
+    }
+
+    break;
+
 #if defined AMIGA || defined __MORPHOS__
   case LIBSPECTRUM_ID_COMPRESSED_XFD:
     {
@@ -635,6 +656,41 @@ libspectrum_uncompress_file( unsigned char **new_buffer, size_t *new_length,
   return LIBSPECTRUM_ERROR_NONE;
 }
 
+libspectrum_error
+libspectrum_zxlz_inflate( const libspectrum_byte *zxptr, size_t zxlength,
+			  libspectrum_byte **outptr, size_t *outlength )
+/* Unpacks a .zxlz file (zxlz.c), which is always available.
+ * Output:	*outptr		-> unpacked data (malloced in this fn)
+ *		*outlength	== length of the unpacked data
+ */
+{
+  int size;
+
+  size = zxlz_size( zxptr, zxlength );
+  if( size < 0 ) {
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
+			     "libspectrum_zxlz_inflate: corrupt file" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+  }
+
+  *outptr = malloc( size + 1 );
+  if( !( *outptr ) ) {
+    libspectrum_print_error( LIBSPECTRUM_ERROR_MEMORY,
+			     "out of memory at %s:%d", __FILE__, __LINE__ );
+    return LIBSPECTRUM_ERROR_MEMORY;
+  }
+
+  if( zxlz_uncompress( *outptr, size, zxptr, zxlength ) != size ) {
+    free( *outptr );
+    libspectrum_print_error( LIBSPECTRUM_ERROR_CORRUPT,
+			     "libspectrum_zxlz_inflate: corrupt file" );
+    return LIBSPECTRUM_ERROR_CORRUPT;
+  }
+
+  *outlength = size;
+  return LIBSPECTRUM_ERROR_NONE;
+}
+
 /* Ensure there is room for `requested' characters after the current
    position `ptr' in `buffer'. If not, realloc() and update the
    pointers as necessary */
@@ -208,6 +208,9 @@ typedef enum libspectrum_id_t {
   LIBSPECTRUM_ID_DISK_IMG,		/* .img DISCiPLE/+D disk image */
   LIBSPECTRUM_ID_DISK_MGT,		/* .mgt DISCiPLE/+D disk image */
 
+  /* Below here, xpectrum only */
+  LIBSPECTRUM_ID_COMPRESSED_ZXLZ,	/* zxlz.c compressed file */
+
 } libspectrum_id_t;
 
 /* And 'classes' of file */
@@ -0,0 +1,396 @@
+/*=====================================================================
+  rewind.c    -> Keeps the last seconds of play to go back to.
+
+  rewind_push() is called after every ZX_Frame and stores what the
+  frame changed: the chunks of ZX_StateSave before the RAM ones and the
+  RAM pages ram_written says were written to, each XORed with the copy
+  kept from the frame before and packed as runs of unchanged bytes and
+  of literal bytes. XOR goes both ways, so the same delta takes a state
+  one frame back or one frame forward, and a frame nothing was written
+  in costs a few hundred bytes. Every REWIND_KEYFRAME frames the whole
+  state is packed too, so a long seek doesn't walk every frame between.
+  The frames live in a ring of budget bytes, the oldest go when it's
+  full. Every machine keeps its own (rewind_vars): rewind_init, push and
+  seek work on the selected one, a new machine has none until
+  rewind_init is called with it selected.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+
+typedef struct
+{
+  unsigned offset;              //in ring
+  unsigned delta;               //bytes of patches from the frame before
+  unsigned key;                 //bytes of the whole state after them, 0 if none
+} RewindFrame;
+
+typedef struct
+{
+  unsigned offset;              //in the state
+  unsigned length;              //packed bytes that follow, then padding to 4
+} RewindPatch;
+
+#define PATCH_ALIGN(n)  (((n) + 3) & ~3u)
+
+//packed size of n bytes at worst, with its patch header
+#define PACK_MAX(n)     (sizeof(RewindPatch) + PATCH_ALIGN((n) + (n) / 128 + 4))
+
+//a delta of every chunk and a key, the most one frame can take
+#define RECORD_MAX      (2 * PACK_MAX(ZX_STATE_MAX) + ZX_CHUNKS * sizeof(RewindPatch))
+
+//unpacking a key costs about as much as this many deltas
+#define KEY_COST        8
+
+static byte *ring;
+static int ring_size, ring_pos;
+
+static RewindFrame *frames;
+static int max_frames, first, count;   //count frames from first, the last one is state
+static int since_key;
+
+static byte *state, *work, *record;
+static int state_size;                 //0 when there's no state yet
+static int ram_offset[8];              //of each RAM page in state, 0 if not saved
+static int work_frame;                 //frame in work, -1 if none
+static int loaded;                     //frame put back by rewind_seek, -1 if none
+
+//every machine has a history of its own, see ZX_SelectMachine
+MachineVar rewind_vars[] =
+{
+  MACHINE_VAR(ring), MACHINE_VAR(ring_size), MACHINE_VAR(ring_pos),
+  MACHINE_VAR(frames), MACHINE_VAR(max_frames), MACHINE_VAR(first),
+  MACHINE_VAR(count), MACHINE_VAR(since_key),
+  MACHINE_VAR(state), MACHINE_VAR(work), MACHINE_VAR(record),
+  MACHINE_VAR(state_size), MACHINE_VAR(ram_offset),
+  MACHINE_VAR(work_frame), MACHINE_VAR(loaded),
+  { NULL, 0 }
+};
+
+#define FRAME(n) (&frames[(first + (n)) % max_frames])
+
+/*-----------------------------------------------------------------
+ Packing: the bytes of new XORed with old, 0x00-0x7f followed by that
+ many plus one literal bytes, 0x80-0xfe skip that many minus 0x7f
+ unchanged ones, 0xff skip the 16 bit count after it. old ends up as
+ new. Literal runs only stop at two unchanged bytes, one isn't worth
+ a code of its own.
+------------------------------------------------------------------*/
+static int rewind_pack(byte *out, byte *old, const byte *new, int n)
+{
+ byte *o = out;
+ int aligned = !(((unsigned long)old | (unsigned long)new) & 3);
+ int i = 0, j, k, skip;
+
+ while(i < n)
+ {
+  j = i;
+  while(j < n)
+  {
+   if(aligned && !(j & 3) && j + 4 <= n &&
+      *(const unsigned *)(old + j) == *(const unsigned *)(new + j)) j += 4;
+   else if(old[j] == new[j]) j++;
+   else break;
+  }
+  if(j == n) break;             //nothing to skip to
+
+  for(skip = j - i; skip > 0x7f; skip -= k)
+  {
+   k = skip < 0xffff ? skip : 0xffff;
+   *o++ = 0xff; *o++ = k & 0xff; *o++ = k >> 8;
+  }
+  if(skip) *o++ = 0x7f + skip;
+
+  for(k = j; k < n && k - j < 128; k++)
+   if(old[k] == new[k] && (k + 1 == n || old[k+1] == new[k+1])) break;
+  *o++ = k - j - 1;
+  for(; j < k; j++)
+  {
+   *o++ = old[j] ^ new[j];
+   old[j] = new[j];
+  }
+  i = k;
+ }
+ return o - out;
+}
+
+static void rewind_unpack(byte *dst, const byte *in, int length)
+{
+ const byte *end = in + length;
+ int n;
+
+ while(in < end)
+ {
+  n = *in++;
+  if(n < 0x80)
+   for(n++; n; n--) *dst++ ^= *in++;
+  else if(n < 0xff)
+   dst += n - 0x7f;
+  else
+  {
+   dst += in[0] | in[1] << 8;
+   in += 2;
+  }
+ }
+}
+
+//packs the n bytes at offset that went from old to new into out as a
+//patch, none if they didn't change; returns the end of out
+static byte *rewind_patch(byte *out, unsigned offset, byte *old, const byte *new, int n)
+{
+ RewindPatch *patch = (RewindPatch *)out;
+ int length;
+
+ length = rewind_pack((byte *)(patch + 1), old, new, n);
+ if(length == 0) return out;
+ patch->offset = offset;
+ patch->length = length;
+ return out + sizeof(RewindPatch) + PATCH_ALIGN(length);
+}
+
+//applies size bytes of patches to dst
+static void rewind_apply(byte *dst, const byte *in, unsigned size)
+{
+ const byte *end = in + size;
+ const RewindPatch *patch;
+
+ while(in < end)
+ {
+  patch = (const RewindPatch *)in;
+  rewind_unpack(dst + patch->offset, (const byte *)(patch + 1), patch->length);
+  in += sizeof(RewindPatch) + PATCH_ALIGN(patch->length);
+ }
+}
+
+static void rewind_drop(void)
+{
+ first = (first + 1) % max_frames;
+ if(--count == 0) ring_pos = 0;
+}
+
+//room for size bytes in ring, dropping the oldest frames in the way
+static int rewind_alloc(int size)
+{
+ int pos = ring_pos;
+
+ if(pos + size > ring_size)
+ {
+  //the frames after ring_pos are the oldest, those at 0 come next
+  while(count && (int)FRAME(0)->offset >= pos) rewind_drop();
+  pos = 0;
+ }
+ while(count && (int)FRAME(0)->offset >= pos && (int)FRAME(0)->offset < pos + size)
+  rewind_drop();
+ ring_pos = pos + size;
+ return pos;
+}
+
+//makes the frame rewind_seek put back the last one, dropping those after it
+static void rewind_resume(void)
+{
+ RewindFrame *frame;
+ int n;
+
+ count = loaded + 1;
+ frame = FRAME(loaded);
+ ring_pos = frame->offset + frame->delta + frame->key;
+ memcpy(state, work, state_size);
+ for(n = loaded; n > 0 && !FRAME(n)->key; n--);
+ since_key = loaded - n;
+ loaded = -1;
+}
+
+/*-----------------------------------------------------------------
+ Public side.
+------------------------------------------------------------------*/
+//keeps up to seconds of history in budget bytes, returns 0 without memory
+int rewind_init(int seconds, int budget)
+{
+ rewind_free();
+ max_frames = seconds * REWIND_FPS + 1;
+ ring_size = budget & ~3;
+ ring = (byte *)malloc(ring_size);
+ frames = (RewindFrame *)malloc(max_frames * sizeof(RewindFrame));
+ state = (byte *)malloc(ZX_STATE_MAX);
+ work = (byte *)malloc(ZX_STATE_MAX);
+ record = (byte *)malloc(RECORD_MAX);
+ if(!ring || !frames || !state || !work || !record)
+ {
+  rewind_free();
+  return 0;
+ }
+ rewind_reset();
+ return 1;
+}
+
+void rewind_free(void)
+{
+ free(ring); free(frames); free(state); free(work); free(record);
+ rewind_detach();
+}
+
+//leaves the selected machine with no history and its buffers to the
+//machine its variables were copied from, see ZX_NewMachine
+void rewind_detach(void)
+{
+ ring = NULL; frames = NULL; state = work = record = NULL;
+ rewind_reset();
+}
+
+//forgets the history, for when another game or state is loaded
+void rewind_reset(void)
+{
+ first = count = 0;
+ ring_pos = 0;
+ state_size = 0;
+ work_frame = loaded = -1;
+}
+
+//stores the frame just run
+void rewind_push(void)
+{
+ RewindFrame *frame;
+ byte *p = record;
+ unsigned delta;
+ int n, size;
+
+ if(ring == NULL) return;
+
+ if(loaded >= 0) rewind_resume();
+ work_frame = -1;
+
+ size = ZX_StateSize(ZX_CHUNK_ALL);
+ if(size != state_size) rewind_reset(); //other RAM pages, nothing to XOR with
+
+ if(count == 0)
+ {
+  const ZXChunk *chunk;
+
+  state_size = ZX_StateSave(state, ZX_STATE_MAX, ZX_CHUNK_ALL);
+  for(n = 0; n < 8; n++)
+  {
+   chunk = ZX_StateFind(state, state_size, ZX_CHUNK_RAM0 + n);
+   ram_offset[n] = chunk ? (const byte *)(chunk + 1) - state : 0;
+  }
+  since_key = REWIND_KEYFRAME;
+ }
+ else
+ {
+  //the chunks before RAM0 come first in state
+  size = ZX_StateSave(work, ZX_STATE_MAX, ZX_CHUNK(ZX_CHUNK_RAM0) - 1);
+  p = rewind_patch(p, 0, state, work, size);
+  for(n = 0; n < 8; n++)
+   if((ram_written & (1u << n)) && ram_offset[n])
+    p = rewind_patch(p, ram_offset[n], state + ram_offset[n], &RAM_pages[0x4000*n], 16384);
+ }
+ ram_written = 0;
+ delta = p - record;
+
+ if(++since_key >= REWIND_KEYFRAME)
+ {
+  memset(work, 0, state_size);
+  p = rewind_patch(p, 0, work, state, state_size);
+  since_key = 0;
+ }
+
+ size = p - record;
+ if(size > ring_size)
+ {
+  rewind_reset();
+  return;
+ }
+ if(count == max_frames) rewind_drop();
+ n = rewind_alloc(size);
+ memcpy(ring + n, record, size);
+
+ frame = FRAME(count);
+ count++;
+ frame->offset = n;
+ frame->delta = delta;
+ frame->key = size - delta;
+}
+
+//puts the machine back the state of back frames before the last
+//pushed one; the next push goes on from there. Returns how far it went
+//back, -1 without history
+int rewind_seek(int back)
+{
+ RewindFrame *frame;
+ int target, best, n, key;
+
+ if(ring == NULL || count == 0) return -1;
+ if(back < 0) back = 0;
+ if(back > count - 1) back = count - 1;
+ target = count - 1 - back;
+
+ //from the nearest of what's in work, the last state and a key
+ best = work_frame >= 0 ? abs(work_frame - target) : count;
+ if(back < best)
+ {
+  memcpy(work, state, state_size);
+  work_frame = count - 1;
+  best = back;
+ }
+ for(n = 0; n + KEY_COST < best; n++)
+ {
+  key = target - n >= 0 && FRAME(target - n)->key ? target - n :
+        target + n < count && FRAME(target + n)->key ? target + n : -1;
+  if(key >= 0)
+  {
+   frame = FRAME(key);
+   memset(work, 0, state_size);
+   rewind_apply(work, ring + frame->offset + frame->delta, frame->key);
+   work_frame = key;
+   break;
+  }
+ }
+
+ for(; work_frame > target; work_frame--)
+ {
+  frame = FRAME(work_frame);
+  rewind_apply(work, ring + frame->offset, frame->delta);
+ }
+ while(work_frame < target)
+ {
+  frame = FRAME(++work_frame);
+  rewind_apply(work, ring + frame->offset, frame->delta);
+ }
+
+ ZX_StateLoad(work, state_size);
+ ram_written = 0;
+ loaded = target;
+ return back;
+}
+
+//frames rewind_seek can go back
+int rewind_frames(void)
+{
+ return count ? count - 1 : 0;
+}
+
+//bytes of the budget in use
+int rewind_used(void)
+{
+ int n, used = 0;
+
+ for(n = 0; n < count; n++)
+  used += FRAME(n)->delta + FRAME(n)->key;
+ return used;
+}
@@ -30,6 +30,13 @@
 
 #include "shared.h"
 
+#ifndef SPMP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 extern MCONFIG mconfig;
 
 extern void msg(char *);
@@ -42,11 +49,99 @@ extern void msg(char *);
 
 
 /*-----------------------------------------------------------------
- char LoadSP( Z80Regs *regs, void *fp );
+ byte *MapFile(const char *name, long max, long *size);
+ Maps a file of max bytes at most into memory, so it's parsed where
+ it is instead of read into a buffer first. Private and writable:
+ a page written to gets copied, the file stays as it was. NULL if
+ it can't (no mmap on the SPMP), then it has to be read.
+
+ GAME is the file being loaded, mapped by LoadGameFile when it's a
+ plain one. Packed ones are unpacked into GameBuffer(), GAME_MAX
+ bytes allocated the first time one is.
+------------------------------------------------------------------*/
+static byte *game_buffer;
+static long  game_mapped;      //bytes mapped at GAME, 0 if it isn't
+
+byte *MapFile(const char *name, long max, long *size)
+{
+#ifndef SPMP
+    struct stat st;
+    void *p;
+    int fd;
+
+    fd = open(name, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > max) {close(fd); return NULL;}
+    p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+    *size = st.st_size;
+    return (byte *)p;
+#else
+    return NULL;
+#endif
+}
+
+void UnmapFile(byte *p, long size)
+{
+#ifndef SPMP
+    if (p != NULL) munmap(p, size);
+#endif
+}
+
+static void game_release(void)
+{
+    if (game_mapped) UnmapFile(GAME, game_mapped);
+    game_mapped = 0;
+    GAME = game_buffer;
+    GAME_size = 0;
+}
+
+/* GAME as GAME_MAX bytes to unpack a game into, NULL without memory */
+byte *GameBuffer(void)
+{
+    game_release();
+    if (game_buffer == NULL) game_buffer = (byte *)calloc(1, GAME_MAX);
+    GAME = game_buffer;
+    return GAME;
+}
+
+/* A plain file as GAME, mapped where it can be; 0 if it can't be read */
+int LoadGameFile(const char *name)
+{
+    FILE *fp;
+    long size;
+    byte *p;
+
+    game_release();
+    p = MapFile(name, GAME_MAX, &size);
+    //the AY player keeps its track table in GAME after the file
+    if (p != NULL && size >= 8 && memcmp(p, "ZXAYEMUL", 8) == 0)
+    {
+        UnmapFile(p, size);
+        p = NULL;
+    }
+    if (p != NULL)
+    {
+        GAME = p;
+        GAME_size = game_mapped = size;
+        return 1;
+    }
+
+    fp = fopen(name, "rb");
+    if (fp == NULL) return 0;
+    if (GameBuffer() != NULL) GAME_size = fread(GAME, 1, GAME_MAX, fp);
+    fclose(fp);
+    return GAME_size > 0;
+}
+
+
+/*-----------------------------------------------------------------
+ char LoadSP( Z80Regs *regs, void *fp, byte *fp_end );
  This loads a .SP file from disk to the Z80 registers/memory.
 ------------------------------------------------------------------*/
 char
-LoadSP (Z80Regs * regs, void *fp)
+LoadSP (Z80Regs * regs, void *fp, byte *fp_end)
 {
   unsigned short length, start, sword;
   int f;
@@ -116,7 +211,8 @@ LoadSP (Z80Regs * regs, void *fp)
   }
   */
 
-  for (f = 0; f <= length; f++)
+  // la cabecera no manda: GAME es un mapeo del tamao justo
+  for (f = 0; f <= length && source < fp_end; f++)
     if (start + f < 65536)
       Z80WriteMem_notiming(start+f,*source++);
 
@@ -493,7 +589,12 @@ LoadSNA (Z80Regs * regs, void * fp, int cmodel)
  This loads a .Z80 file from disk to the Z80 registers/memory.
 
  void UncompressZ80 (int tipo, int pc, Z80Regs *regs, FILE *fp)
- This load and uncompres a Z80 block to pc adress memory.
+ This load and uncompres a Z80 block to pc adress memory. The bytes
+ up to the next ED go in one memcpy and ED ED n b in one memset,
+ straight into the page. tam is the size of a V2 block and the bytes
+ left in the file for V1. Whatever would go past the page is left out
+ (3D Stock Cars has a page that unpacks to 16385 bytes), whatever the
+ block doesn't fill is zeroed.
 
  The Z80 Load Routine is (C) 2001 Alvaro Alea Fdz.
  e-mail: ALEAsoft@yahoo.com  Distributed under GPL2
@@ -506,88 +607,45 @@ LoadSNA (Z80Regs * regs, void * fp, int cmodel)
 void
 UncompressZ80 (byte *dest, int tipo, int tam, Z80Regs * regs, void * fp)
 {
-  byte c, c2;
-  int  limit, pc=0, count=0;
-  byte *source=(byte *)fp;
+  byte *source=(byte *)fp, *end, *ed;
+  byte *pc=dest, *limit;
+  int  n;
+
+  limit = dest + (tipo == Z80BL_V1UNCOMP || tipo == Z80BL_V1COMPRE ? 0xc000 : 0x4000);
+  end = source + (tipo == Z80BL_V2UNCOMP ? 0x4000 : tam);
 
   if (tipo == Z80BL_V1UNCOMP || tipo == Z80BL_V2UNCOMP)
   {
-    limit = (tipo == Z80BL_V1UNCOMP ? 0xc000 : 0x4000 );
-
-    memset(dest,0,limit);
-
-    while (pc < limit) dest[ pc++ ] = *source++;
-
+    n = limit - dest;
+    if (n > end - source) n = end - source;
+    memcpy(dest, source, n);
+    memset(dest + n, 0, limit - dest - n);
     return;
   }
-  else
-  if (tipo == Z80BL_V1COMPRE)
-  {
-   memset(dest,0,0xc000);
-   limit = 0 + 0xc000;
-  }
-  else
-  //if (tipo == Z80BL_V2COMPRE)
-  {
-   memset(dest,0,0x4000);
-   limit = 0 + tam; //0x4000; //(tam>0x4000?0x4000:tam); //ultimo!
-  }
 
-
-    {
-    while(1)
+  while (pc < limit && source < end)
+  {
+    n = limit - pc;
+    if (n > end - source) n = end - source;
+    ed = (byte *)memchr(source, 0xed, n);
+    if (ed == NULL) ed = source + n;
+    memcpy(pc, source, ed - source); /* not ED... */
+    pc += ed - source;
+    source = ed;
+    if (pc == limit || source == end) break;
+
+    if (end - source >= 4 && source[1] == 0xed) /* is ED ED code */
     {
-        c=source[count++];
-
-        if(c==237) /* is ED... */
-        {
-            c2=source[count++];
-
-            if (c2==237) /* is ED ED code */
-            {
-                byte i, val; int x;
-
-                i=source[count++];
-                val=source[count++];
-
-                for(x=0;x<i;x++)
-                {
-                 dest[pc++]=val;
-                }
-            }
-            else
-            {
-                dest[pc++]=c; /* is ED ?? */
-                dest[pc++]=c2;
-            }
-        }
-        else
-        {
-            dest[pc++]=c;   /* not ED... */
-        }
-
-#if 0
-        if(pc>16385 && (tipo != Z80BL_V1UNCOMP) )
-        {
-            /* The above is a scam to get 3D Stock Cars */
-            /* snaps to work, the encoding routine on V2 */
-            /* and V3 files seems to save 'page 4' in such */
-            /* a way that it decompresses to a length of */
-            /* 16385, it does this with snaps saved on both */
-            /* Z80 and X128, so it could be a fault with */
-            /* the encoding system, or a fault with James' McKay */
-            /* decoding routine */
-
-            return ; /* fail */
-        }
-#endif
-
-      if (tipo == Z80BL_V1COMPRE)    if(pc>=limit) return;
-      if (tipo == Z80BL_V2COMPRE) if(count>=limit) return;
-
-    } //while (count<limit); //ultimo! pc<limit
-
+      n = source[2];
+      if (n > limit - pc) n = limit - pc;
+      memset(pc, source[3], n);
+      pc += n;
+      source += 4;
     }
+    else *pc++ = *source++; /* is ED ??, the ?? goes on as it is */
+  }
+
+  memset(pc, 0, limit - pc);
 }
 
 
@@ -600,7 +658,8 @@ LoadZ80 (Z80Regs * regs, byte * fp, byte * fp_end)
 
     ZX_Reset(ZX_48);
 
-    memcpy(buffer, source, /*86*/87);//fix by MetalBrain
+    memset(buffer, 0, sizeof(buffer));
+    memcpy(buffer, source, fp_end - source < 87 ? fp_end - source : /*86*/87);//fix by MetalBrain
 
     if (buffer[12]==255) buffer[12]=1; /*as told in CSS FAQ / .z80 section */
 
@@ -609,7 +668,7 @@ LoadZ80 (Z80Regs * regs, byte * fp, byte * fp_end)
     {
         // .z80 v1.45 or earlier
         source=source_; source+=30;
-        UncompressZ80 (&RAM_pages[0x4000*5],(buffer[12] & 0x20 ? Z80BL_V1COMPRE : Z80BL_V1UNCOMP), 0, regs, (void *)source);
+        UncompressZ80 (&RAM_pages[0x4000*5],(buffer[12] & 0x20 ? Z80BL_V1COMPRE : Z80BL_V1UNCOMP), fp_end - source, regs, (void *)source);
 
         regs->PC.B.l = buffer[6]; //set PC
         regs->PC.B.h = buffer[7];
@@ -751,6 +810,8 @@ LoadZ80 (Z80Regs * regs, byte * fp, byte * fp_end)
 
                 source=source_; source+=sig;
 
+                if(source + 3 > fp_end) break; //cut short
+
                 tam = *source++;
                 tam = tam + ((*source++) << 8);
                 pag = *source++;
@@ -781,6 +842,8 @@ LoadZ80 (Z80Regs * regs, byte * fp, byte * fp_end)
                                         target=(byte *)&RAM_pages[0x4000*(pag-3)]; break;
                     }
 
+                if(source + (tam == 0xffff ? 0x4000 : tam) > fp_end) break; //cut short
+
                 if(target!=NULL)
                     UncompressZ80(target, (tam == 0xffff ? Z80BL_V2UNCOMP : Z80BL_V2COMPRE), tam, regs, source);
 
@@ -1575,7 +1638,28 @@ unsigned int _IN_A_hook[2][2];//={{0x05f1-2,0x0000};
 short new_IN_A_pos=1;
 
 
-void inline
+//cuenta los T-states pasados desde la ultima vez que se miro la cinta
+static void loader_elapsed (register Z80Regs *spectrumZ80)
+{
+    int tstates=spectrumZ80->IPeriod-spectrumZ80->ICount;//pasados!
+    int tstates_elapsed = tstates - tstates_prev_A;
+    if (tstates_elapsed<0) tstates_elapsed+=spectrumZ80->IPeriod;
+
+    tstates_prev_A=tstates;
+    tape_edge_tstates_current+=tstates_elapsed;
+}
+
+//T-states que faltan para el siguiente edge, JustRun() para el Z80 ahi
+int loader_next_edge (register Z80Regs *spectrumZ80)
+{
+    int tstates_elapsed = spectrumZ80->IPeriod-spectrumZ80->ICount-tstates_prev_A;
+    if (tstates_elapsed<0) tstates_elapsed+=spectrumZ80->IPeriod;
+
+    return tape_edge_tstates_target-tape_edge_tstates_current-tstates_elapsed;
+}
+
+//JustRun() la llama en cada edge de la cinta, no tras cada instruccion
+void
 loader (register Z80Regs *spectrumZ80)
 {
     /*
@@ -1615,24 +1699,45 @@ loader (register Z80Regs *spectrumZ80)
       return;
     }
     */
-    int tstates=spectrumZ80->IPeriod-spectrumZ80->ICount;//pasados!
-    int tstates_elapsed = tstates - tstates_prev_A;
-    if (tstates_elapsed<0) tstates_elapsed+=spectrumZ80->IPeriod;
+    loader_elapsed(spectrumZ80);
 
-    tstates_prev_A=tstates;
-    tape_edge_tstates_current+=tstates_elapsed;
+    if(tape_edge_tstates_current>=tape_edge_tstates_target)
+    {
+        int edge_tstates=0;
+        tape_next_edge(spectrumZ80,&edge_tstates,&bit);
+        tape_edge_tstates_target = /*edge_tstates_target*//*edge_tstates_current+*/edge_tstates;//arregla las cintas largas
+        tape_edge_tstates_current=0;
+
+        fast_edge_loading = bit!=-1 && mconfig.edge_loading;
+    }
+}
+
+int tstates_prev_B = 0;
+int successive_reads = 0;
+byte last_b_read = 0;
 
+/* loader trap state of the selected machine, see ZX_SelectMachine */
+MachineVar snaps_vars[] =
+{
+  MACHINE_VAR(tstates_prev_A), MACHINE_VAR(bit),
+  MACHINE_VAR(fast_edge_loading),
+  MACHINE_VAR(_IN_A_hook), MACHINE_VAR(new_IN_A_pos),
+  MACHINE_VAR(tstates_prev_B), MACHINE_VAR(successive_reads),
+  MACHINE_VAR(last_b_read),
+  { NULL, 0 }
+};
+
+//en el IN de un edge loader enganchado adelanta el edge a ahora mismo:
+//la primera vuelta tras un edge normal se deja pasar
+static void loader_fast_edge (register Z80Regs *spectrumZ80)
+{
     if(fast_edge_loading==1)
-    {
-    if(spectrumZ80->PC.W==_IN_A_hook[0][0] ||spectrumZ80->PC.W==_IN_A_hook[1][0])
     {
        fast_edge_loading = 2;//consumimos el _IN del edge normal y hemos detectado un hook
     }
-    }
     else if(fast_edge_loading==2)
     {
-    if(spectrumZ80->PC.W==_IN_A_hook[0][0] ||spectrumZ80->PC.W==_IN_A_hook[1][0])
-    {
+       loader_elapsed(spectrumZ80);
        spectrumZ80->BC.B.h = (bit ?  0xfA : 0x05); //forces edge trigger zero or one
        int edge_tstates=0;
        tape_next_edge(spectrumZ80,&edge_tstates,&bit);
@@ -1640,24 +1745,10 @@ loader (register Z80Regs *spectrumZ80)
           fast_edge_loading = 0;
        tape_edge_tstates_target = /*edge_tstates_current+*/edge_tstates;
        tape_edge_tstates_current=0;
-    }
-    }
-
-    if(tape_edge_tstates_current>=tape_edge_tstates_target)
-    {
-        int edge_tstates=0;
-        tape_next_edge(spectrumZ80,&edge_tstates,&bit);
-        tape_edge_tstates_target = /*edge_tstates_target*//*edge_tstates_current+*/edge_tstates;//arregla las cintas largas
-        tape_edge_tstates_current=0;
-
-        fast_edge_loading = bit!=-1 && mconfig.edge_loading;
+       tape_reschedule=1;//el edge siguiente ya no es el que esperaba JustRun()
     }
 }
 
-int tstates_prev_B = 0;
-int successive_reads = 0;
-byte last_b_read = 0;
-
 void loader_hook (register Z80Regs *spectrumZ80)
 {
     if(!tape_is_tape())
@@ -1665,6 +1756,10 @@ void loader_hook (register Z80Regs *spectrumZ80)
 
     unsigned int _IN_pos = spectrumZ80->PC.W-1;
 
+    //antes que nada, como si fuera la instruccion anterior al IN
+    if(tape_playing && (_IN_A_hook[0][1] == _IN_pos || _IN_A_hook[1][1] == _IN_pos))
+      loader_fast_edge(spectrumZ80);
+
     if(mconfig.auto_loading)//detector de autoarranque de cinta
     {
     byte b_diff = spectrumZ80->BC.B.h - last_b_read;
@@ -0,0 +1,244 @@
+/*=====================================================================
+  statewriter.c -> Writes a save state out without stopping the game.
+
+  save_state() captures the state into memory and hands it over with
+  state_writer_start(). It's packed with zxlz.c into name.tmp, which
+  is fsync'd, the old file is hard linked as old_name and name.tmp
+  renamed over name, so a crash leaves either state whole under name.
+  The SPMP has no link(), there name is moved to old_name first and a
+  crash right then leaves the state only in old_name. Where there are
+  threads that runs on one of its own; on the SPMP a slice of it runs
+  every time the main loop calls state_writer_poll(). Only one state
+  is written at a time.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SPMP
+#define STATE_WRITER_THREAD
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "zxlz.h"
+#include "statewriter.h"
+
+typedef struct
+{
+  char name[256], old_name[256], tmp_name[260];
+  unsigned char *data;
+  int size, done;
+  FILE *fp;
+  unsigned char block[ZXLZ_BLOCK + 4];
+} StateWriter;
+
+static StateWriter writer;
+static volatile int writer_status = STATE_WRITER_IDLE;
+
+#ifdef STATE_WRITER_THREAD
+static pthread_t writer_thread;
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void writer_set_status(int status)
+{
+#ifdef STATE_WRITER_THREAD
+ pthread_mutex_lock(&writer_mutex);
+ writer_status = status;
+ pthread_mutex_unlock(&writer_mutex);
+#else
+ writer_status = status;
+#endif
+}
+
+static int writer_get_status(void)
+{
+ int status;
+
+#ifdef STATE_WRITER_THREAD
+ pthread_mutex_lock(&writer_mutex);
+ status = writer_status;
+ pthread_mutex_unlock(&writer_mutex);
+#else
+ status = writer_status;
+#endif
+ return status;
+}
+
+//only this file is flushed to the card, not every filesystem like sync()
+static int writer_sync_file(FILE *fp)
+{
+#ifdef STATE_WRITER_THREAD
+ return fsync(fileno(fp)) == 0;
+#else
+ return 1;
+#endif
+}
+
+//and the renames in the directory of name
+static void writer_sync_dir(const char *name)
+{
+#ifdef STATE_WRITER_THREAD
+ char dir[256];
+ char *slash;
+ int fd;
+
+ strcpy(dir, name);
+ slash = strrchr(dir, '/');
+ if(slash == NULL) strcpy(dir, ".");
+ else *slash = 0;
+ fd = open(dir, O_RDONLY);
+ if(fd >= 0)
+ {
+  fsync(fd);
+  close(fd);
+ }
+#endif
+}
+
+static void writer_finish(int ok)
+{
+ if(writer.fp)
+ {
+  if(fflush(writer.fp) != 0) ok = 0;
+  if(ok && !writer_sync_file(writer.fp)) ok = 0;
+  if(fclose(writer.fp) != 0) ok = 0;
+  writer.fp = NULL;
+ }
+ if(ok)
+ {
+  remove(writer.old_name);
+#ifdef STATE_WRITER_THREAD
+  //name stays in place until the rename below replaces it in one go
+  link(writer.name, writer.old_name);
+#else
+  //no hard links on the SPMP, name is missing until the rename is done
+  rename(writer.name, writer.old_name);
+#endif
+  ok = rename(writer.tmp_name, writer.name) == 0;
+ }
+ if(ok) writer_sync_dir(writer.name);
+ else remove(writer.tmp_name);
+
+ free(writer.data);
+ writer.data = NULL;
+ writer_set_status(ok ? STATE_WRITER_DONE : STATE_WRITER_FAILED);
+}
+
+//packs and writes the next block, returns 0 once it's all written or failed
+static int writer_step(void)
+{
+ int n;
+
+ if(writer.fp == NULL)
+ {
+  writer.fp = fopen(writer.tmp_name, "wb");
+  if(writer.fp == NULL || fwrite(ZXLZ_MAGIC, 1, 4, writer.fp) != 4)
+  {
+   writer_finish(0);
+   return 0;
+  }
+ }
+ if(writer.done < writer.size)
+ {
+  n = writer.size - writer.done;
+  if(n > ZXLZ_BLOCK) n = ZXLZ_BLOCK;
+  writer.done += n;
+  n = zxlz_block(writer.block, writer.data + writer.done - n, n);
+ }
+ else n = zxlz_end(writer.block);
+ if(fwrite(writer.block, 1, n, writer.fp) != (size_t)n)
+ {
+  writer_finish(0);
+  return 0;
+ }
+ if(n > 4) return 1;
+ writer_finish(1);
+ return 0;
+}
+
+#ifdef STATE_WRITER_THREAD
+static void *writer_run(void *arg)
+{
+ while(writer_step());
+ return NULL;
+}
+#endif
+
+//writes size bytes of data, malloc'd and freed when done, to name; returns 0
+//if it can't start, data isn't taken then
+int state_writer_start(void *data, int size, const char *name, const char *old_name)
+{
+ state_writer_wait();
+
+ memset(&writer, 0, sizeof(writer));
+ strncpy(writer.name, name, sizeof(writer.name) - 1);
+ strncpy(writer.old_name, old_name, sizeof(writer.old_name) - 1);
+ sprintf(writer.tmp_name, "%s.tmp", writer.name);
+ writer.data = (unsigned char *)data;
+ writer.size = size;
+ writer_set_status(STATE_WRITER_BUSY);
+
+#ifdef STATE_WRITER_THREAD
+ if(pthread_create(&writer_thread, NULL, writer_run, NULL) != 0)
+ {
+  writer.data = NULL;
+  writer_set_status(STATE_WRITER_IDLE);
+  return 0;
+ }
+#endif
+ return 1;
+}
+
+//called every frame: moves the write on if there's no thread, and tells
+//when it's finished (STATE_WRITER_DONE or _FAILED, once)
+int state_writer_poll(void)
+{
+ int status;
+
+#ifndef STATE_WRITER_THREAD
+ if(writer_status == STATE_WRITER_BUSY) writer_step();
+#endif
+ status = writer_get_status();
+ if(status == STATE_WRITER_DONE || status == STATE_WRITER_FAILED)
+ {
+#ifdef STATE_WRITER_THREAD
+  pthread_join(writer_thread, NULL);
+#endif
+  writer_set_status(STATE_WRITER_IDLE);
+ }
+ return status;
+}
+
+//finishes the write under way, if any, before a load or quitting
+void state_writer_wait(void)
+{
+#ifdef STATE_WRITER_THREAD
+ if(writer_get_status() != STATE_WRITER_IDLE)
+ {
+  pthread_join(writer_thread, NULL);
+  writer_set_status(STATE_WRITER_IDLE);
+ }
+#else
+ while(writer_status == STATE_WRITER_BUSY) writer_step();
+ writer_status = STATE_WRITER_IDLE;
+#endif
+}
@@ -73,32 +73,85 @@
 
 extern MCONFIG mconfig;
 
-byte inline Z80ReadMem(register word where);
+byte inline Z80ReadMem(register word where, int *icount);
 byte inline Z80ReadMem_notiming(register word where);
 extern int scan_convert[];
 
 #define debugmsg(a,b) printf(text,"%s = %04x",a,b)
 
 
-byte cycles_delay[76000];
-byte cycles_delay2[76000];
-unsigned short floating_bus[76000];
+ULATiming ula_timing;
 
-// *** NEW VIDEO VARIABLES ***
-int memwrites=0;
-int memwriteaddr[5500];
-int memwritetime[5500];
-int memwritevalue[5500];
+/* contention by T-state & 7 over the first 128 T-states of a screen
+   line: 48K/128K ULA and +2A/+3 gate array */
+static const byte delay_ula[8]  = { 6, 5, 4, 3, 2, 1, 0, 0 };
+static const byte delay_gate[8] = { 1, 0, 7, 6, 5, 4, 3, 2 };
 
-int outwrites=0;
-int outwritetime[5500];
-int outwritevalue[5500];
+/* T-states into the contended part of the frame, and the scanline they
+   are on, for ICount icount; returns 0 outside of it */
+static inline int
+ula_position (int icount, unsigned *line, unsigned *pos)
+{
+  unsigned d = ula_timing.first - icount;
+
+  if (d >= ula_timing.length)
+    return 0;
+  *line = (d * ula_timing.recip) >> 24;
+  *pos = d - *line * ula_timing.line;
+  return 1;
+}
+
+/* contention at ICount icount; the +2A/+3 gate array only contends
+   actual memory accesses */
+static inline byte
+cycles_delay (int icount)
+{
+  unsigned line, pos;
+
+  if (!ula_position (icount, &line, &pos) || pos >= 128)
+    return 0;
+  return ula_timing.delay[pos & 7];
+}
+
+#define cycles_delay2(icount)  (ula_timing.delay2 ? cycles_delay (icount) : 0)
+
+/* what an idle port reads at ICount icount: the byte the ULA fetched
+   4 T-states earlier (bitmap, attribute, bitmap, attribute, then four
+   idle T-states), 0xFF in the borders */
+static byte
+floating_bus (int icount)
+{
+  unsigned line, pos, column;
+
+  if (!ula_timing.floating_bus || !ula_position (icount + 4, &line, &pos) ||
+      pos >= 128 || (pos & 7) >= 4)
+    return 0xFF;
+  column = (pos >> 3) * 2 + ((pos & 7) >> 1);
+  if (pos & 1)
+    return Z80ReadMem_notiming (0x5800 + 32 * (line >> 3) + column);
+  return Z80ReadMem_notiming (0x4000 + scan_convert[line] + column);
+}
+
+/* ICount at which the ULA first reads screen byte where; a write at
+   or under it comes after that, and the screen has to be drawn up to
+   it first. -72000 for what it never reads */
+static inline int
+ula_first_read (word where)
+{
+  unsigned offset = where & 0x3FFF;
+
+  if (offset < 6144)
+    return ula_timing.screen -
+      (((offset >> 11) << 6) | ((offset >> 2) & 0x38) | ((offset >> 8) & 7)) *
+      ula_timing.line - 4 * (offset & 31);
+  if (offset < 6912)
+    return ula_timing.screen -
+      ((offset - 6144) >> 5) * 8 * ula_timing.line - 4 * (offset & 31);
+  return -72000;
+}
 
-int pagewrites=0;
-int pagewritetime[5500];
-int pagewritevalue[5500];
+int outwrites=0;        //OUTs to 0xFE this frame
 
-int Significance[65536];
 
 byte tape_format;
 
@@ -200,13 +253,24 @@ byte *MEMr[4]; //solid block of 16*4 = 64kb for reading
 byte *MEMw[4]; //solid block of 16*4 = 64kb for writing
 byte  MEMc[4]; //contended 16k block? 1/0
 byte  MEMs[4]; //screen 16k block? 1/0
-byte  GAME[1*1024*1024];
-byte  DSK[1*1024*1024];
-long GAME_size;   //game(s) workspace
-byte  RAM_dummy[16384*1];  //to emulate spectrum 16
-byte  ROM_dummy[16384*1];
-byte  RAM_pages[16384*16]; //up 16 pages (ZS Scorpion)
-byte  ROM_pages[16384*4];  //up  4 pages (ZX +2A/+3)
+byte *GAME;       //game(s) workspace, mapped or unpacked by snaps.c
+long GAME_size;
+
+//memory of a machine, one block each, see ZX_NewMachine
+#define MEM_RAM_PAGES  0                           //up 16 pages (ZS Scorpion)
+#define MEM_ROM_PAGES  (MEM_RAM_PAGES+16384*16)    //up  4 pages (ZX +2A/+3)
+#define MEM_RAM_DUMMY  (MEM_ROM_PAGES+16384*4)     //to emulate spectrum 16
+#define MEM_ROM_DUMMY  (MEM_RAM_DUMMY+16384*1)
+#define MEM_DSK        (MEM_ROM_DUMMY+16384*1)
+#define MEM_DRIVES     (MEM_DSK+1*1024*1024)      //t_drive A and B
+#define MEM_SIZE       (MEM_DRIVES+2*sizeof(t_drive))
+
+static byte first_memory[MEM_DRIVES];      //fdc.c has the drives
+byte *RAM_pages = &first_memory[MEM_RAM_PAGES];
+byte *ROM_pages = &first_memory[MEM_ROM_PAGES];
+byte *RAM_dummy = &first_memory[MEM_RAM_DUMMY];
+byte *ROM_dummy = &first_memory[MEM_ROM_DUMMY];
+byte *DSK       = &first_memory[MEM_DSK];
 byte  model, pagination_128, pagination_plus2a, contended_mask;
 byte  BorderColor;
 //byte  trap_rom_loading;
@@ -338,13 +402,16 @@ port_0x7ffd (byte value)
 {
   if (pagination_128 & 32) return; //if previously locked (bit 5), return
 
+  if ((value ^ pagination_128) & 8)
+    CatchUpScreen (spectrumZ80->IPeriod - spectrumZ80->ICount);
+
   // check bit 2-0: RAM0/7 -> 0xc000-0xffff
   MEMw[3]=MEMr[3]=&RAM_pages[0x4000*(value&7)-3*0x4000];
 
   //16/48/128/+2: pages 1,3,5,7 are contended (1), 0,2,4,6 not contended (0) -> so mask is 0001 (1)
   //+2A/+3:       pages 4,5,6,7 are contended (1), 0,1,2,3 not contended (0) -> so mask is 0100 (4)
   MEMc[3]=value & contended_mask;
-  MEMs[3]=2*(value==7)+(value==5);
+  MEMs[3]=2*((value&7)==7)+((value&7)==5);
 
   //locked regions
   //
@@ -356,10 +423,6 @@ port_0x7ffd (byte value)
   MEMr[0]=&ROM_pages[(value & 16 ? 0x4000 : 0 ) | ((pagination_plus2a & 5) == 4 ? 0x8000 : 0)];
 //MEMw[0]=MEMw[0];
 
-
-  pagewritetime[pagewrites]=spectrumZ80->ICount;
-  pagewritevalue[pagewrites++]=value&8;
-
   pagination_128=value;
 }
 
@@ -437,7 +500,7 @@ if(model==ZX_PLUS3) fdc_write_data(value);
 
 byte port_0x3ffd_in (void)
 {
-return (model==ZX_PLUS3 ? fdc_read_data() : floating_bus[spectrumZ80->ICount] ? Z80ReadMem_notiming(floating_bus[spectrumZ80->ICount]) : 0xFF );
+return (model==ZX_PLUS3 ? fdc_read_data() : floating_bus(spectrumZ80->ICount) );
 }
 
 
@@ -493,13 +556,13 @@ port_0xfffd_in (void)
 /*----------------------------------------------------------------*/
 extern void CreateVideoTables (void);
 
-void CreateScreenTable (int);
 
 // byte *zx_bordercolour, zx_bordercolours[240]; //one per scanline
 
 //byte *zx_tapfile,*zx_tapfile_,*zx_tapfile_eof;
 //int   zx_pressed_play=0;
-int   vram_touched=0;
+int   vram_touched=0;     //screen memory changed without SCREEN_WRITTEN
+unsigned ram_written=0;
 byte  mic_on,mic;
 
 // original:
@@ -575,9 +638,17 @@ byte port_0xbf3b_in (void)
 void port_0xff3b (byte value)
 {
    if (ula64_reg <= 63 ){
+      if (value != zx_ula64_palette[ula64_reg])
+         CatchUpColours (spectrumZ80->IPeriod - spectrumZ80->ICount);
       zx_ula64_palette[ula64_reg] = value;
       zx_palette_change = 1;
    } else if (ula64_reg == 64 ){
+      if ((value & 0x01) != zx_ula64_enabled)
+      {
+         CatchUpScreen (spectrumZ80->IPeriod - spectrumZ80->ICount);
+         CatchUpBorder (spectrumZ80->IPeriod - spectrumZ80->ICount);
+         CatchUpColours (spectrumZ80->IPeriod - spectrumZ80->ICount);
+      }
       zx_ula64_enabled = value & 0x01;
       zx_palette_change = 1;
    }
@@ -718,8 +789,7 @@ byte Z80InPort (register word port)
   if ((port & 0xFF) == 0xFF)
 
     {
-       return (floating_bus[spectrumZ80->ICount] ?
-               Z80ReadMem_notiming(floating_bus[spectrumZ80->ICount]) : 0xFF );
+       return floating_bus(spectrumZ80->ICount);
     }
 
   /*
@@ -803,10 +873,10 @@ void Z80OutPort (register word port, register byte value)
   /* change border colour */
   if (!(port & (0xFF^0xFE)))
     {
+      if ((value & 0x07) != BorderColor)
+        CatchUpBorder (spectrumZ80->IPeriod - spectrumZ80->ICount);
       BorderColor = (value & 0x07);
-
-      outwritetime[outwrites]=spectrumZ80->ICount;
-      outwritevalue[outwrites++]=value & 0x07;
+      outwrites++;
 
       #ifdef SOUND_X128
       //logSound (value & 0x10);
@@ -850,10 +920,9 @@ void
 Z80Patch (register Z80Regs * regs)
 {
   // address contributed by Ignacio Burgue�o :)
-#undef POP
-#define POP(rreg)\
-  regs->rreg.B.l = Z80ReadMem(regs->SP.W); regs->SP.W++;\
-  regs->rreg.B.h = Z80ReadMem(regs->SP.W); regs->SP.W++
+#define PATCH_POP(rreg)\
+  regs->rreg.B.l = Z80ReadMem(regs->SP.W, &regs->ICount); regs->SP.W++;\
+  regs->rreg.B.h = Z80ReadMem(regs->SP.W, &regs->ICount); regs->SP.W++
 #if 0
 
   /* OLD
@@ -890,7 +959,7 @@ Z80Patch (register Z80Regs * regs)
       // LoadTZX(regs);
       {
           if(Tape_load(regs));
-                     POP(PC);//??
+                     PATCH_POP(PC);//??
                   // byte Z80InPort (register word port)
       }
 
@@ -910,30 +979,48 @@ Z80Patch (register Z80Regs * regs)
 }
 
 void inline
-Z80WriteMem (register word where, register byte A)
+Z80WriteMem (register word where, register byte A, int *icount)
 {
-volatile word whereA;
+word whereA;
+byte *p;
 whereA=where>>14;
-if(MEMc[whereA])
-        {
-        spectrumZ80->ICount-=(cycles_delay[spectrumZ80->ICount]);
-        if(MEMs[whereA] && (Significance[where] < spectrumZ80->ICount))
-                {
-                memwriteaddr[memwrites]=(where%16384)+6912*(MEMs[whereA]-1);
-                memwritetime[memwrites]=spectrumZ80->ICount;
-                memwritevalue[memwrites++]=A;
-                }
-        }
-*((byte *)(MEMw[whereA]+(where)))=A;
-spectrumZ80->ICount-=3;
+if(MEMc[whereA]) *icount-=(cycles_delay(*icount));
+//the shown screen, where the ULA has been already
+if(MEMs[whereA]==1+((pagination_128>>3)&1) && ula_first_read(where)>=*icount)
+        CatchUpScreen(spectrumZ80->IPeriod-*icount);
+p=MEMw[whereA]+where;
+*p=A;
+ram_written|=RAM_WRITTEN(p);
+SCREEN_WRITTEN(p);
+*icount-=3;
 }
 
 void inline
 Z80WriteMem_notiming (register word where, register byte A)
 {
-volatile word whereA;
+word whereA;
+byte *p;
 whereA=where>>14;
-*((byte *)(MEMw[whereA]+(where)))=A;
+p=MEMw[whereA]+where;
+*p=A;
+ram_written|=RAM_WRITTEN(p);
+SCREEN_WRITTEN(p);
+}
+
+//the cores without contention: untimed, but icount is still where the
+//writing instruction started, so the screen is caught up as above
+void inline
+Z80WriteMem_uncontended (register word where, register byte A, int *icount)
+{
+word whereA;
+byte *p;
+whereA=where>>14;
+if(MEMs[whereA]==1+((pagination_128>>3)&1) && ula_first_read(where)>=*icount)
+        CatchUpScreen(spectrumZ80->IPeriod-*icount);
+p=MEMw[whereA]+where;
+*p=A;
+ram_written|=RAM_WRITTEN(p);
+SCREEN_WRITTEN(p);
 }
 
 void POKE(unsigned dir,unsigned char dat)
@@ -942,150 +1029,150 @@ Z80WriteMem_notiming(dir,dat);
 }
 
 byte inline
-Z80ReadMem(register word where)
+Z80ReadMem(register word where, int *icount)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
-if(MEMc[whereA]) spectrumZ80->ICount-=(cycles_delay[spectrumZ80->ICount]);
-spectrumZ80->ICount-=3;
+if(MEMc[whereA]) *icount-=(cycles_delay(*icount));
+*icount-=3;
 return *((byte *)(MEMr[whereA]+(where)));
 }
 
 byte inline
 Z80ReadMem_notiming(register word where)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
 return *((byte *)(MEMr[whereA]+(where)));
 }
 
-void inline contend_read(word where)
+void inline contend_read(word where, int *icount)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
-if(MEMc[whereA]) spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);
-spectrumZ80->ICount--;
+if(MEMc[whereA]) *icount-=(cycles_delay2(*icount));
+(*icount)--;
 }
 
-void inline contend_read_jr(void)
+void inline contend_read_jr(word *pc, int *icount)
 {
-volatile word whereA;
-whereA=spectrumZ80->PC.W>>14;
-if(MEMc[whereA]) spectrumZ80->ICount-=(cycles_delay[spectrumZ80->ICount]);
-spectrumZ80->PC.W++;
-spectrumZ80->ICount-=3;
+word whereA;
+whereA=*pc>>14;
+if(MEMc[whereA]) *icount-=(cycles_delay(*icount));
+(*pc)++;
+*icount-=3;
 }
 
-void inline contend_read_byte(void)
+void inline contend_read_byte(int *icount)
 {
-volatile byte whereA;
+byte whereA;
 whereA=spectrumZ80->I>>6;
-if(MEMc[whereA]) spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);
-spectrumZ80->ICount--;
+if(MEMc[whereA]) *icount-=(cycles_delay2(*icount));
+(*icount)--;
 }
 
-void inline contend_read_byte_x2(void)
+void inline contend_read_byte_x2(int *icount)
 {
-volatile byte whereA;
+byte whereA;
 whereA=spectrumZ80->I>>6;
 if(MEMc[whereA])
         {
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
         }
 else    {
-        spectrumZ80->ICount-=2;
+        *icount-=2;
         }
 }
 
-void inline contend_read_byte_x7(void)
+void inline contend_read_byte_x7(int *icount)
 {
-volatile byte whereA;
+byte whereA;
 whereA=spectrumZ80->I>>6;
 if(MEMc[whereA])
         {
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
         }
 else    {
-        spectrumZ80->ICount-=7;
+        *icount-=7;
         }
 }
 
-void inline contend_read_x5(word where)
+void inline contend_read_x5(word where, int *icount)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
 if(MEMc[whereA])
         {
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
         }
 else    {
-        spectrumZ80->ICount-=5;
+        *icount-=5;
         }
 }
 
-void inline contend_read_x4(word where)
+void inline contend_read_x4(word where, int *icount)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
 if(MEMc[whereA])
         {
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
         }
 else    {
-        spectrumZ80->ICount-=4;
+        *icount-=4;
         }
 }
 
-void inline contend_read_x2(word where)
+void inline contend_read_x2(word where, int *icount)
 {
-volatile word whereA;
+word whereA;
 whereA=where>>14;
 if(MEMc[whereA])
         {
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);spectrumZ80->ICount--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
+        *icount-=(cycles_delay2(*icount));(*icount)--;
         }
 else    {
-        spectrumZ80->ICount-=2;
+        *icount-=2;
         }
 }
 
-void inline ula_contend_port_early(word port)
+void inline ula_contend_port_early(word port, int *icount)
 {
 if(MEMc[port>>14])
-        spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]);
-spectrumZ80->ICount-=1;
+        *icount-=(cycles_delay2(*icount));
+*icount-=1;
 }
 
-void inline ula_contend_port_late(word port)
+void inline ula_contend_port_late(word port, int *icount)
 {
 if((contended_mask!=4)&&((port & 0x0001) == 0))
         {
-        spectrumZ80->ICount-=(cycles_delay[spectrumZ80->ICount]); spectrumZ80->ICount-=3;
+        *icount-=(cycles_delay(*icount)); *icount-=3;
         }
 else    {
 	if(MEMc[port>>14])
                 {
-                spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]); spectrumZ80->ICount-=1;
-                spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]); spectrumZ80->ICount-=1;
-                spectrumZ80->ICount-=(cycles_delay2[spectrumZ80->ICount]); spectrumZ80->ICount-=1;
+                *icount-=(cycles_delay2(*icount)); *icount-=1;
+                *icount-=(cycles_delay2(*icount)); *icount-=1;
+                *icount-=(cycles_delay2(*icount)); *icount-=1;
                 }
         else    {
-                spectrumZ80->ICount-=3;
+                *icount-=3;
                 }
         }
 }
@@ -1145,7 +1232,7 @@ void ZX_SetModel(void)
 
 void ZX_Reset(int preffered_model)
 {
- int i,j,k,k2,totalcycles,irqtime;
+ int totalcycles,irqtime;
 
 
 
@@ -1164,69 +1251,34 @@ void ZX_Reset(int preffered_model)
                     break;
  }
 
-  for(i=0;i<76000;i++) cycles_delay[i]=cycles_delay2[i]=floating_bus[i]=0;
+  /* the ULA starts fetching line 0 at T-state TIMING_48/TIMING_128 and
+     spends 128 of every line's 224/228 T-states on the paper area */
+ {
+  ula_timing.line = (model<ZX_128 ? 224 : 228);
+  ula_timing.recip = ((1 << 24) + ula_timing.line - 1) / ula_timing.line;
+  ula_timing.length = 192 * ula_timing.line;
+  ula_timing.screen = totalcycles - (model<ZX_128 ? TIMING_48 : TIMING_128);
 
  switch(model)
  {
- case ZX_16:
- case ZX_48:
- case ZX_128:
- case ZX_128_USR0:
- case ZX_PLUS2:
-
-  for(k=(model<ZX_128?TIMING_48:TIMING_128),j=0;j<192;j++,k+=(model<ZX_128?96:100))
-  {
-   extern int scan_convert[192];
-          int paper=0x4000+scan_convert[j], attr=0x5800+32*(j/8);
-
-   for(i=0;i<16;i++) //16*8=128 T states per line (main screen)
-   {
-    //k2 = 10 & 13 get FLOATSPY.TAP to work
-    // int k2=model<ZX_128? 0 : 10;
-    int k2=-4;
-
-
-/*
-
-#define TIMING_48   14335       , entre ellos dos 6
-#define TIMING_128  14361
-
-*/
-
-    floating_bus[totalcycles-k+k2]=paper;  cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=6; k++; paper++;
-    floating_bus[totalcycles-k+k2]=attr;   cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=5; k++; attr++;
-    floating_bus[totalcycles-k+k2]=paper;  cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=4; k++; paper++;
-    floating_bus[totalcycles-k+k2]=attr;   cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=3; k++; attr++;
-    floating_bus[totalcycles-k+k2]=0x0000; cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=2; k++;
-    floating_bus[totalcycles-k+k2]=0x0000; cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=1; k++;
-    floating_bus[totalcycles-k+k2]=0x0000; cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=0; k++;
-    floating_bus[totalcycles-k+k2]=0x0000; cycles_delay2[totalcycles-k]=cycles_delay[totalcycles-k]=0; k++;
-
-   }
-  }
- break;
-
  case ZX_PLUS2A:
  case ZX_PLUS3:
-              //no floating bus emulation
-
-              for(k=14365,j=0;j<192;j++,k+=100) //100 T=skip border (24+ 24+52)
-               for(i=0;i<16;i++) //16*8=128 T states per line (main screen)
-                  {
-                   cycles_delay[totalcycles-k]=1; k++;
-                   cycles_delay[totalcycles-k]=0; k++;
-                   cycles_delay[totalcycles-k]=7; k++;
-                   cycles_delay[totalcycles-k]=6; k++;
-                   cycles_delay[totalcycles-k]=5; k++;
-                   cycles_delay[totalcycles-k]=4; k++;
-                   cycles_delay[totalcycles-k]=3; k++;
-                   cycles_delay[totalcycles-k]=2; k++;
-                  }
+  //no floating bus emulation, the gate array only contends memory
+  ula_timing.first = totalcycles - 14365;
+  ula_timing.floating_bus = 0;
+  ula_timing.delay = delay_gate;
+  break;
+
+ default:
+  ula_timing.first = ula_timing.screen;
+  ula_timing.floating_bus = 1;
+  ula_timing.delay = delay_ula;
+  break;
+ }
 
-              break;
+  ula_timing.delay2 = ula_timing.floating_bus;
  }
 
- CreateScreenTable(model);
  Z80Reset (spectrumZ80, totalcycles, irqtime ); //69888 for 48k, 70908 for 128k
  Z80FlagTables ();
 
@@ -1248,6 +1300,7 @@ void ZX_Reset(int preffered_model)
  fuller=0xff;
 
  vram_touched=1;
+ ram_written=~0u;
 
  memset(ay_registers,0,16);
  ay_current_reg=0;
@@ -1313,10 +1366,12 @@ void ZX_Unpatch_ROM(){
   }
 }
 
+static int f_flash2 = 0;
+
+extern void set_emupalette();
+
 void ZX_Frame(int do_skip)
 {
- static int f_flash2 = 0;
-
  f_flash2++;
  f_flash2 %= 32;
 
@@ -1328,6 +1383,13 @@ void ZX_Frame(int do_skip)
 
  JustRun(spectrumZ80, do_skip);
 
+ //the host palette as the frame left it, Picture32 has it line by line
+ if(zx_palette_change)
+ {
+   set_emupalette();
+   zx_palette_change = 0;
+ }
+
  // zx_bordercolour=(byte *)&zx_bordercolours[0];
 
  fila[1][1] =
@@ -1344,6 +1406,214 @@ void ZX_Frame(int do_skip)
 }
 
 
+/*-----------------------------------------------------------------
+ Run-ahead.
+ ZX_RunAhead() runs a frame like ZX_Frame() and then frames more with
+ the same input, draws the last of them and puts the machine back as
+ the first frame left it, so what a key does is seen frames sooner.
+ Only the first frame is heard, the sound changes the others log are
+ dropped before Sound_Loop() gets them. Just the RAM pages the extra
+ frames wrote to are put back. The tape and the DSK aren't part of the
+ state, so with a tape inserted (the loader hook may start it in any
+ frame) it's ZX_Frame(), and so on a +3 whose disk motor runs or whose
+ controller is in a command. A write the extra frames make right after
+ starting the motor would still stay in the DSK, no +3 DOS routine does
+ that within a few frames.
+------------------------------------------------------------------*/
+void ZX_RunAhead(int frames, int do_skip)
+{
+ static byte state[ZX_STATE_MAX];
+ int keys[5][5], keys_kempston = kempston, keys_fuller = fuller;
+ int size, flash, ay_changes, beep_changes, ay_used;
+ unsigned written;
+
+ if(frames <= 0 || tape_is_tape() ||
+    (model == ZX_PLUS3 && (FDC.motor || FDC.phase != CMD_PHASE)))
+ {
+  ZX_Frame(do_skip);
+  return;
+ }
+
+ memcpy(keys, fila, sizeof(keys));
+ ZX_Frame(1);
+
+ size = ZX_StateSave(state, sizeof(state), ZX_CHUNK_ALL);
+ flash = f_flash2;
+ written = ram_written;
+ ram_written = 0;
+ ay_changes = ay_change_count;
+ beep_changes = beep_change_count;
+ ay_used = ay_is_in_use;
+
+ while(frames--)
+ {
+  //the extra frames aren't heard, they log over each other's changes
+  ay_change_count = ay_changes;
+  beep_change_count = beep_changes;
+  memcpy(fila, keys, sizeof(keys));
+  kempston = keys_kempston;
+  fuller = keys_fuller;
+  ZX_Frame(frames ? 1 : do_skip);
+ }
+
+ ZX_StateLoadChunks(state, size, (ZX_CHUNK(ZX_CHUNK_RAM0) - 1) |
+                                 (ram_written << ZX_CHUNK_RAM0 & ZX_CHUNK_ALL));
+ ram_written = written;
+ f_flash2 = flash;
+ ay_change_count = ay_changes;
+ beep_change_count = beep_changes;
+ ay_is_in_use = ay_used;
+}
+
+
+/*-----------------------------------------------------------------
+ Machines.
+ zx_vars lists the machine's globals of this file, the other modules
+ have their own lists; machine_vars() stores all of them to (or loads
+ them from) the buffer of a machine that isn't running. The write logs
+ only keep their counts, the entries are used up by the frame that
+ logged them.
+------------------------------------------------------------------*/
+MachineVar zx_vars[] =
+{
+  MACHINE_VAR(spectrumZ80),
+  MACHINE_VAR(RAM_pages), MACHINE_VAR(ROM_pages),
+  MACHINE_VAR(RAM_dummy), MACHINE_VAR(ROM_dummy), MACHINE_VAR(DSK),
+  MACHINE_VAR(MEMr), MACHINE_VAR(MEMw), MACHINE_VAR(MEMc), MACHINE_VAR(MEMs),
+  MACHINE_VAR(ula_timing),
+  MACHINE_VAR(outwrites),
+  MACHINE_VAR(model), MACHINE_VAR(pagination_128),
+  MACHINE_VAR(pagination_plus2a), MACHINE_VAR(contended_mask),
+  MACHINE_VAR(BorderColor), MACHINE_VAR(tape_format),
+  MACHINE_VAR(kempston), MACHINE_VAR(fuller), MACHINE_VAR(fila),
+  MACHINE_VAR(mouse_x), MACHINE_VAR(mouse_y), MACHINE_VAR(mouse_b),
+  MACHINE_VAR(ay_current_reg), MACHINE_VAR(ay_registers),
+  MACHINE_VAR(vram_touched), MACHINE_VAR(ram_written),
+  MACHINE_VAR(mic_on), MACHINE_VAR(mic),
+  MACHINE_VAR(zx_ula64_enabled), MACHINE_VAR(zx_ula64_palette),
+  MACHINE_VAR(ula64_reg), MACHINE_VAR(zx_palette_change),
+  MACHINE_VAR(f_flash2),
+  MACHINE_VAR(mconfig),
+  { NULL, 0 }
+};
+
+static MachineVar *machine_var_lists[] =
+{
+  zx_vars, z80_vars, graphics_vars, snaps_vars, ay_vars, fdc_vars, tape_vars,
+  rewind_vars
+};
+
+#define MACHINE_VAR_LISTS (sizeof(machine_var_lists)/sizeof(machine_var_lists[0]))
+
+struct ZXMachine
+{
+  Z80Regs regs;
+  byte *memory;                 //MEM_SIZE bytes
+  byte *vars;                   //the MachineVar globals while not selected
+};
+
+static ZXMachine first_machine;   //the host's spectrumZ80 and first_memory
+static ZXMachine *zx_machine = &first_machine;
+
+static unsigned machine_vars_size(void)
+{
+ MachineVar *var;
+ unsigned n, size = 0;
+
+ for(n=0;n<MACHINE_VAR_LISTS;n++)
+  for(var=machine_var_lists[n];var->data;var++)
+   size += var->size;
+ return size;
+}
+
+static void machine_vars(byte *buffer, int load)
+{
+ MachineVar *var;
+ unsigned n;
+
+ for(n=0;n<MACHINE_VAR_LISTS;n++)
+  for(var=machine_var_lists[n];var->data;var++)
+  {
+   if(load)
+    memcpy(var->data, buffer, var->size);
+   else
+    memcpy(buffer, var->data, var->size);
+   buffer += var->size;
+  }
+}
+
+//makes m the machine ZX_Frame and the loaders work on, returns the one
+//that was selected
+ZXMachine *ZX_SelectMachine(ZXMachine *m)
+{
+ ZXMachine *old = zx_machine;
+
+ if(m == NULL) m = &first_machine;
+ if(m == old) return old;
+
+ if(old->vars == NULL)
+ {
+  old->vars = (byte *)malloc(machine_vars_size());
+  if(old->vars == NULL) return old;
+ }
+ machine_vars(old->vars, 0);
+ machine_vars(m->vars, 1);
+ zx_machine = m;
+ return old;
+}
+
+//a new machine with the settings (mconfig, Picture) of the selected one,
+//with no tape, disk or rewind history, reset to new_model and left selected
+ZXMachine *ZX_NewMachine(int new_model)
+{
+ ZXMachine *m = (ZXMachine *)calloc(1, sizeof(ZXMachine));
+
+ if(m == NULL) return NULL;
+ m->memory = (byte *)calloc(1, MEM_SIZE);
+ m->vars = (byte *)malloc(machine_vars_size());
+ if(m->memory != NULL && m->vars != NULL)
+ {
+  machine_vars(m->vars, 0);
+  ZX_SelectMachine(m);
+ }
+ if(zx_machine != m)
+ {
+  free(m->memory); free(m->vars); free(m);
+  return NULL;
+ }
+
+ spectrumZ80 = &m->regs;
+ RAM_pages = &m->memory[MEM_RAM_PAGES];
+ ROM_pages = &m->memory[MEM_ROM_PAGES];
+ RAM_dummy = &m->memory[MEM_RAM_DUMMY];
+ ROM_dummy = &m->memory[MEM_ROM_DUMMY];
+ DSK       = &m->memory[MEM_DSK];
+ fdc_drives = (t_drive *)&m->memory[MEM_DRIVES];
+ tape_init();
+ rewind_detach();
+
+ ZX_Init();
+ ZX_Reset(new_model);        //also empties the drives
+ return m;
+}
+
+//frees a machine made by ZX_NewMachine, the first one is selected if
+//it was the selected one
+void ZX_FreeMachine(ZXMachine *m)
+{
+ ZXMachine *old;
+
+ if(m == NULL || m == &first_machine) return;
+ old = ZX_SelectMachine(m);
+ tape_finish();
+ rewind_free();
+ ZX_SelectMachine(old == m ? NULL : old);
+ free(m->vars);
+ free(m->memory);
+ free(m);
+}
+
+
 void ZX_LoadGame(int preferred_model, unsigned long crc, int quick)
 {
  if(preferred_model!=-1)
@@ -1352,6 +1622,8 @@ void ZX_LoadGame(int preferred_model, unsigned long crc, int quick)
 
  tape_format=0;
 
+ if(GAME==NULL || GAME_size<=0) return; //nothing loaded, just the reset
+
  if(GAME[0]=='Z'&&GAME[1]=='X'&&GAME[2]=='A'&&GAME[3]=='Y'&&
     GAME[4]=='E'&&GAME[5]=='M'&&GAME[6]=='U'&&GAME[7]=='L')
  {
@@ -1387,7 +1659,7 @@ void ZX_LoadGame(int preferred_model, unsigned long crc, int quick)
   }
  else if(GAME_size==49190)
   {
-  LoadSP(spectrumZ80,GAME);
+  LoadSP(spectrumZ80,GAME,&GAME[GAME_size]);
   }
  else if(GAME_size==16384)
  {
@@ -1420,6 +1692,7 @@ void ZX_LoadGame(int preferred_model, unsigned long crc, int quick)
  {
    LoadZ80(spectrumZ80,GAME,&GAME[GAME_size]);
  }
+ vram_touched=1;    //the loaders write the screens straight
 
  //exceptions
 
@@ -1546,61 +1819,362 @@ int ZX_LoadState(void *memx)
   if (model == ZX_PLUS2A || model == ZX_PLUS3) port_0x1ffd(pagination_plus2a);
 
   port_0x7ffd(pagination_128);
+  vram_touched=1;
 
   return count;
 }
 
 
-void CreateScreenTable(int model)
+
+/*-----------------------------------------------------------------
+ In-memory states.
+ ZX_StateSave() copies the chunks asked for into the caller's buffer,
+ no allocation and no file; compressing or writing it out is up to
+ the caller. The paging is kept as the MEMr/MEMw offsets from
+ RAM_pages, the same in every machine, so loading it only has to
+ reset the machine when the model changes. What the tape is doing
+ isn't saved.
+------------------------------------------------------------------*/
+#define STATE_ALIGN(n) (((n) + 3) & ~3u)
+
+typedef struct
 {
-int x,y,start,pause,memoryadd,timing,repeat;
-memoryadd=0;
-for( y=0; y<65536; y++)
-        {
-        Significance[y] = 72000;
-        }
-switch(model)
-        {
-        case ZX_16:
-        case ZX_48:
-                start=69888-TIMING_48;
-                pause=96;
-                repeat=0;
-                break;
-        case ZX_128:
-        case ZX_128_USR0:
-        case ZX_PLUS2:
-        case ZX_PLUS2A:
-        case ZX_PLUS3:
-                start=70908-TIMING_128;
-                pause=100;
-                repeat=32768;
-                break;
-        default:
-                abort();
-                break;
-        }
-timing=start;
-for(y=0;y<192;y++)
-        {
-        memoryadd=16384+scan_convert[y];
-        for(x=0;x<32;x++)
-                {
-                Significance[memoryadd+repeat]=timing;
-                Significance[memoryadd++]=timing;
-                timing-=4;
-                }
-        timing-=pause;
-        }
-timing=start-7*(pause+128);
-for(y=0;y<24;y++)
-        {
-        for(x=0;x<32;x++)
-                {
-                Significance[memoryadd+repeat]=timing;
-                Significance[memoryadd++]=timing;
-                timing-=4;
-                }
-        timing-=(pause+128)*7+pause;
-        }
+  byte model, pagination_128, pagination_plus2a, contended_mask;
+  byte border, mic_on, mic, pad;
+  byte mem_c[4], mem_s[4];
+  long mem_r[4], mem_w[4];      //from RAM_pages
+} StateULA;
+
+typedef struct
+{
+  byte registers[16], current;
+  byte sound_registers[16];     //as the generators last took them
+  unsigned tone_tick[3], tone_high[3], noise_tick;
+  unsigned tone_subcycles, env_subcycles, env_internal_tick, env_tick;
+  unsigned tone_period[3], noise_period, env_period;
+  int rng, noise_toggle, env_first, env_rev, env_counter, in_use;
+} StateAY;
+
+typedef struct
+{
+  byte enabled, reg, palette[64];
+} StateULAplus;
+
+typedef struct
+{
+  t_FDC fdc;                    //without its pointers
+  long buffer, buffer_end;      //from DSK, -1 for NULL
+  unsigned track, side, sector, flipped;
+  int active_track;             //in driveA.track[][], -1 for none
+} StateFDC;
+
+//RAM pages the model has, as a mask of ZX_CHUNK_RAM0 bits
+static unsigned state_ram_chunks(void)
+{
+ switch(model)
+ {
+  case ZX_16: return ZX_CHUNK(ZX_CHUNK_RAM0+5);
+  case ZX_48: return ZX_CHUNK(ZX_CHUNK_RAM0+5) | ZX_CHUNK(ZX_CHUNK_RAM0+6) | ZX_CHUNK(ZX_CHUNK_RAM0+7);
+ }
+ return ZX_CHUNK_ALL & ~(ZX_CHUNK(ZX_CHUNK_RAM0)-1);
+}
+
+static unsigned state_length(unsigned type)
+{
+ switch(type)
+ {
+  case ZX_CHUNK_ULA:     return sizeof(StateULA);
+  case ZX_CHUNK_CPU:     return sizeof(Z80Regs);
+  case ZX_CHUNK_AY:      return sizeof(StateAY);
+  case ZX_CHUNK_ULAPLUS: return sizeof(StateULAplus);
+  case ZX_CHUNK_FDC:     return sizeof(StateFDC);
+ }
+ return 16384;
+}
+
+//the chunks of chunks this machine can save
+static unsigned state_chunks(unsigned chunks)
+{
+ chunks &= state_ram_chunks() | (ZX_CHUNK(ZX_CHUNK_RAM0)-1);
+ if(model != ZX_PLUS3) chunks &= ~ZX_CHUNK(ZX_CHUNK_FDC);
+ return chunks;
+}
+
+static long state_offset(byte *ptr)
+{
+ return ptr ? ptr - DSK : -1;
+}
+
+static byte *state_pointer(long offset)
+{
+ return offset != -1 ? DSK + offset : NULL;
+}
+
+static void state_get(unsigned type, void *data)
+{
+ int n;
+
+ switch(type)
+ {
+  case ZX_CHUNK_ULA:
+  {
+   StateULA *ula = (StateULA *)data;
+
+   memset(ula, 0, sizeof(StateULA));
+   ula->model = model;
+   ula->pagination_128 = pagination_128;
+   ula->pagination_plus2a = pagination_plus2a;
+   ula->contended_mask = contended_mask;
+   ula->border = BorderColor;
+   ula->mic_on = mic_on;
+   ula->mic = mic;
+   for(n=0;n<4;n++)
+   {
+    ula->mem_c[n] = MEMc[n];
+    ula->mem_s[n] = MEMs[n];
+    ula->mem_r[n] = MEMr[n] - RAM_pages;
+    ula->mem_w[n] = MEMw[n] - RAM_pages;
+   }
+   break;
+  }
+
+  case ZX_CHUNK_CPU:
+   memcpy(data, spectrumZ80, sizeof(Z80Regs));
+   break;
+
+  case ZX_CHUNK_AY:
+  {
+   StateAY *ay = (StateAY *)data;
+
+   memcpy(ay->registers, ay_registers, 16);
+   ay->current = ay_current_reg;
+   memcpy(ay->sound_registers, sound_ay_registers, 16);
+   memcpy(ay->tone_tick, ay_tone_tick, sizeof(ay->tone_tick));
+   memcpy(ay->tone_high, ay_tone_high, sizeof(ay->tone_high));
+   memcpy(ay->tone_period, ay_tone_period, sizeof(ay->tone_period));
+   ay->noise_tick = ay_noise_tick;
+   ay->tone_subcycles = ay_tone_subcycles;
+   ay->env_subcycles = ay_env_subcycles;
+   ay->env_internal_tick = ay_env_internal_tick;
+   ay->env_tick = ay_env_tick;
+   ay->noise_period = ay_noise_period;
+   ay->env_period = ay_env_period;
+   ay->rng = rng;
+   ay->noise_toggle = noise_toggle;
+   ay->env_first = env_first;
+   ay->env_rev = env_rev;
+   ay->env_counter = env_counter;
+   ay->in_use = ay_is_in_use;
+   break;
+  }
+
+  case ZX_CHUNK_ULAPLUS:
+  {
+   StateULAplus *ulaplus = (StateULAplus *)data;
+
+   ulaplus->enabled = zx_ula64_enabled;
+   ulaplus->reg = ula64_reg;
+   memcpy(ulaplus->palette, zx_ula64_palette, 64);
+   break;
+  }
+
+  case ZX_CHUNK_FDC:
+  {
+   StateFDC *fdc = (StateFDC *)data;
+
+   fdc->fdc = FDC;
+   fdc->fdc.cmd_handler = NULL;
+   fdc->fdc.buffer_ptr = fdc->fdc.buffer_endptr = NULL;
+   fdc->buffer = state_offset(FDC.buffer_ptr);
+   fdc->buffer_end = state_offset(FDC.buffer_endptr);
+   fdc->track = driveA.current_track;
+   fdc->side = driveA.current_side;
+   fdc->sector = driveA.current_sector;
+   fdc->flipped = driveA.flipped;
+   fdc->active_track = active_track ? active_track - &driveA.track[0][0] : -1;
+   break;
+  }
+
+  default:
+   memcpy(data, &RAM_pages[0x4000*(type-ZX_CHUNK_RAM0)], 16384);
+   break;
+ }
+}
+
+static void state_put(unsigned type, const void *data)
+{
+ int n;
+
+ switch(type)
+ {
+  case ZX_CHUNK_ULA:
+  {
+   const StateULA *ula = (const StateULA *)data;
+
+   if(ula->model != model) ZX_Reset(ula->model);
+   pagination_128 = ula->pagination_128;
+   pagination_plus2a = ula->pagination_plus2a;
+   contended_mask = ula->contended_mask;
+   BorderColor = ula->border;
+   mic_on = ula->mic_on;
+   mic = ula->mic;
+   for(n=0;n<4;n++)
+   {
+    MEMc[n] = ula->mem_c[n];
+    MEMs[n] = ula->mem_s[n];
+    MEMr[n] = RAM_pages + ula->mem_r[n];
+    MEMw[n] = RAM_pages + ula->mem_w[n];
+   }
+   break;
+  }
+
+  case ZX_CHUNK_CPU:
+   memcpy(spectrumZ80, data, sizeof(Z80Regs));
+   break;
+
+  case ZX_CHUNK_AY:
+  {
+   const StateAY *ay = (const StateAY *)data;
+
+   //not through the ports: writing R13 would restart the envelope and
+   //log sound changes the frame never made
+   memcpy(ay_registers, ay->registers, 16);
+   ay_current_reg = ay->current;
+   memcpy(sound_ay_registers, ay->sound_registers, 16);
+   memcpy(ay_tone_tick, ay->tone_tick, sizeof(ay->tone_tick));
+   memcpy(ay_tone_high, ay->tone_high, sizeof(ay->tone_high));
+   memcpy(ay_tone_period, ay->tone_period, sizeof(ay->tone_period));
+   ay_noise_tick = ay->noise_tick;
+   ay_tone_subcycles = ay->tone_subcycles;
+   ay_env_subcycles = ay->env_subcycles;
+   ay_env_internal_tick = ay->env_internal_tick;
+   ay_env_tick = ay->env_tick;
+   ay_noise_period = ay->noise_period;
+   ay_env_period = ay->env_period;
+   rng = ay->rng;
+   noise_toggle = ay->noise_toggle;
+   env_first = ay->env_first;
+   env_rev = ay->env_rev;
+   env_counter = ay->env_counter;
+   ay_is_in_use = ay->in_use;
+   break;
+  }
+
+  case ZX_CHUNK_ULAPLUS:
+  {
+   const StateULAplus *ulaplus = (const StateULAplus *)data;
+
+   if(ulaplus->enabled != zx_ula64_enabled ||
+      memcmp(ulaplus->palette, zx_ula64_palette, 64))
+    zx_palette_change = 1;
+   zx_ula64_enabled = ulaplus->enabled;
+   ula64_reg = ulaplus->reg;
+   memcpy(zx_ula64_palette, ulaplus->palette, 64);
+   break;
+  }
+
+  case ZX_CHUNK_FDC:
+  {
+   const StateFDC *fdc = (const StateFDC *)data;
+   void (*cmd_handler)(void) = FDC.cmd_handler;
+
+   FDC = fdc->fdc;
+   FDC.cmd_handler = cmd_handler;
+   FDC.buffer_ptr = state_pointer(fdc->buffer);
+   FDC.buffer_endptr = state_pointer(fdc->buffer_end);
+   driveA.current_track = fdc->track;
+   driveA.current_side = fdc->side;
+   driveA.current_sector = fdc->sector;
+   driveA.flipped = fdc->flipped;
+   active_track = fdc->active_track >= 0 ? &driveA.track[0][0] + fdc->active_track : NULL;
+   break;
+  }
+
+  default:
+   //run-ahead puts back screens that mostly didn't change
+   if((type == ZX_CHUNK_RAM0 + 5 || type == ZX_CHUNK_RAM0 + 7) &&
+      memcmp(&RAM_pages[0x4000*(type-ZX_CHUNK_RAM0)], data, 6912))
+    vram_touched = 1;
+   memcpy(&RAM_pages[0x4000*(type-ZX_CHUNK_RAM0)], data, 16384);
+   ram_written |= 1u << (type-ZX_CHUNK_RAM0);
+   break;
+ }
 }
+
+//bytes ZX_StateSave needs for chunks, a mask of ZX_CHUNK() bits
+int ZX_StateSize(unsigned chunks)
+{
+ unsigned type;
+ int size = 0;
+
+ chunks = state_chunks(chunks);
+ for(type=0;type<ZX_CHUNKS;type++)
+  if(chunks & ZX_CHUNK(type))
+   size += sizeof(ZXChunk) + STATE_ALIGN(state_length(type));
+ return size;
+}
+
+//saves chunks of the selected machine into buffer, the ULA chunk first,
+//returns the bytes used or 0 if they don't fit
+int ZX_StateSave(void *buffer, int size, unsigned chunks)
+{
+ byte *p = (byte *)buffer;
+ ZXChunk *chunk;
+ unsigned type;
+
+ if(size < ZX_StateSize(chunks)) return 0;
+
+ chunks = state_chunks(chunks);
+ for(type=0;type<ZX_CHUNKS;type++)
+  if(chunks & ZX_CHUNK(type))
+  {
+   chunk = (ZXChunk *)p;
+   chunk->type = type;
+   chunk->length = state_length(type);
+   state_get(type, chunk+1);
+   p += sizeof(ZXChunk) + STATE_ALIGN(chunk->length);
+  }
+ return p - (byte *)buffer;
+}
+
+//puts back every chunk in buffer, returns 0 if it isn't a state
+int ZX_StateLoad(const void *buffer, int size)
+{
+ return ZX_StateLoadChunks(buffer, size, ZX_CHUNK_ALL);
+}
+
+//puts back the chunks in buffer that are in chunks, a mask of ZX_CHUNK() bits
+int ZX_StateLoadChunks(const void *buffer, int size, unsigned chunks)
+{
+ const byte *p = (const byte *)buffer, *end = p + size;
+ const ZXChunk *chunk;
+
+ while(end - p >= (int)sizeof(ZXChunk))
+ {
+  chunk = (const ZXChunk *)p;
+  if(chunk->type >= ZX_CHUNKS || chunk->length != state_length(chunk->type) ||
+     end - p < (int)(sizeof(ZXChunk) + STATE_ALIGN(chunk->length)))
+   return 0;
+  if(chunks & ZX_CHUNK(chunk->type))
+   state_put(chunk->type, chunk+1);
+  p += sizeof(ZXChunk) + STATE_ALIGN(chunk->length);
+ }
+ return p == end;
+}
+
+//the chunk of type in buffer, its data follows the header; NULL if none
+const ZXChunk *ZX_StateFind(const void *buffer, int size, unsigned type)
+{
+ const byte *p = (const byte *)buffer, *end = p + size;
+ const ZXChunk *chunk;
+
+ while(end - p >= (int)sizeof(ZXChunk))
+ {
+  chunk = (const ZXChunk *)p;
+  if(chunk->type == type) return chunk;
+  p += sizeof(ZXChunk) + STATE_ALIGN(chunk->length);
+ }
+ return NULL;
+}
+
+
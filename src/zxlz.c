@@ -0,0 +1,260 @@
+/*=====================================================================
+  zxlz.c      -> Fast LZ77 packer for save states and games.
+
+  bzip2 packs well but its block sort takes long on these machines, so
+  save states and "compress all files" use this instead. A .zxlz file is
+  ZXLZ_MAGIC and blocks of up to ZXLZ_BLOCK bytes packed on their own,
+  each after 2 bytes of its size and 2 of its packed size, bit 15 of
+  which says it's stored as is. A block of size 0 ends it. Inside a
+  block, a token byte gives in its high nibble the literal bytes that
+  follow it and in the low one the length minus 4 of a match 1-16384
+  bytes back, after the literals as 2 bytes; 15 in either goes on in
+  bytes of 255 and the one under it. The last token of a block has no
+  match. Matches are found greedily through a hash of 4 bytes.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ ======================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "zxlz.h"
+
+#define HASH_BITS       12
+#define MIN_MATCH       4
+#define STORED          0x8000
+
+#define HASH(p)         ((((p)[0] | (p)[1] << 8 | (p)[2] << 16 | (unsigned)(p)[3] << 24) \
+                          * 2654435761u) >> (32 - HASH_BITS))
+
+static void put16(unsigned char *p, int n)
+{
+ p[0] = n & 0xff;
+ p[1] = n >> 8;
+}
+
+static int get16(const unsigned char *p)
+{
+ return p[0] | p[1] << 8;
+}
+
+//a length over 14 goes on in bytes
+static unsigned char *put_length(unsigned char *op, int n)
+{
+ for(n -= 15; n >= 255; n -= 255) *op++ = 255;
+ *op++ = n;
+ return op;
+}
+
+//packs n bytes, returns 0 if that doesn't come under limit
+static int zxlz_pack(unsigned char *out, int limit, const unsigned char *in, int n)
+{
+ unsigned short table[1 << HASH_BITS];
+ const unsigned char *ip = in, *anchor = in, *end = in + n, *ref;
+ unsigned char *op = out, *oend = out + limit;
+ int lit, len;
+ unsigned h;
+
+ memset(table, 0, sizeof(table));
+ while(ip + MIN_MATCH <= end)
+ {
+  h = HASH(ip);
+  ref = in + table[h];
+  table[h] = ip - in;
+  if(ref >= ip || ref[0] != ip[0] || ref[1] != ip[1] || ref[2] != ip[2] || ref[3] != ip[3])
+  {
+   ip += 1 + ((ip - anchor) >> 6); //skip faster through what doesn't pack
+   continue;
+  }
+  for(len = MIN_MATCH; ip + len < end && ref[len] == ip[len]; len++);
+
+  lit = ip - anchor;
+  if(op + 1 + lit / 255 + 1 + lit + 2 + len / 255 + 1 > oend) return 0;
+  *op = (lit < 15 ? lit : 15) << 4 | (len - MIN_MATCH < 15 ? len - MIN_MATCH : 15);
+  op++;
+  if(lit >= 15) op = put_length(op, lit);
+  memcpy(op, anchor, lit);
+  op += lit;
+  put16(op, ip - ref);
+  op += 2;
+  if(len - MIN_MATCH >= 15) op = put_length(op, len - MIN_MATCH);
+
+  ip += len;
+  anchor = ip;
+  if(ip + MIN_MATCH <= end) table[HASH(ip - 2)] = ip - 2 - in;
+ }
+
+ lit = end - anchor;
+ if(op + 1 + lit / 255 + 1 + lit > oend) return 0;
+ *op++ = (lit < 15 ? lit : 15) << 4;
+ if(lit >= 15) op = put_length(op, lit);
+ memcpy(op, anchor, lit);
+ op += lit;
+ return op - out;
+}
+
+//unpacks length bytes into n, returns 0 if they don't make that
+static int zxlz_unpack(unsigned char *out, int n, const unsigned char *in, int length)
+{
+ const unsigned char *ip = in, *iend = in + length, *ref;
+ unsigned char *op = out, *oend = out + n;
+ int token, lit, len, c;
+
+ while(ip < iend)
+ {
+  token = *ip++;
+  lit = token >> 4;
+  if(lit == 15)
+   do
+   {
+    if(ip >= iend) return 0;
+    c = *ip++;
+    lit += c;
+   } while(c == 255);
+  if(lit > oend - op || lit > iend - ip) return 0;
+  memcpy(op, ip, lit);
+  op += lit;
+  ip += lit;
+  if(op == oend) return ip == iend;
+
+  if(iend - ip < 2) return 0;
+  ref = op - get16(ip);
+  ip += 2;
+  len = (token & 15) + MIN_MATCH;
+  if((token & 15) == 15)
+   do
+   {
+    if(ip >= iend) return 0;
+    c = *ip++;
+    len += c;
+   } while(c == 255);
+  if(ref < out || ref == op || len > oend - op) return 0;
+  while(len--) *op++ = *ref++;  //may overlap what it's writing
+ }
+ return 0;
+}
+
+/*-----------------------------------------------------------------
+ Public side.
+------------------------------------------------------------------*/
+//packs n bytes, ZXLZ_BLOCK at most, as one block; returns its size,
+//n + 4 at most
+int zxlz_block(unsigned char *out, const unsigned char *in, int n)
+{
+ int packed;
+
+ packed = zxlz_pack(out + 4, n - 1, in, n);
+ put16(out, n);
+ if(packed == 0)
+ {
+  memcpy(out + 4, in, n);
+  put16(out + 2, STORED | n);
+  return 4 + n;
+ }
+ put16(out + 2, packed);
+ return 4 + packed;
+}
+
+//the block that ends a file
+int zxlz_end(unsigned char *out)
+{
+ memset(out, 0, 4);
+ return 4;
+}
+
+//packs n bytes as a whole .zxlz file into ZXLZ_BOUND(n) bytes of out,
+//returns its size
+int zxlz_compress(unsigned char *out, const unsigned char *in, int n)
+{
+ unsigned char *op = out;
+ int k;
+
+ memcpy(op, ZXLZ_MAGIC, 4);
+ op += 4;
+ for(; n > 0; in += k, n -= k)
+ {
+  k = n < ZXLZ_BLOCK ? n : ZXLZ_BLOCK;
+  op += zxlz_block(op, in, k);
+ }
+ op += zxlz_end(op);
+ return op - out;
+}
+
+int zxlz_is(const unsigned char *in, int length)
+{
+ return length >= 4 && !memcmp(in, ZXLZ_MAGIC, 4);
+}
+
+//bytes the file unpacks to, -1 if it isn't one or is cut short
+int zxlz_size(const unsigned char *in, int length)
+{
+ const unsigned char *ip = in + 4, *iend = in + length;
+ int size = 0, n;
+
+ if(!zxlz_is(in, length)) return -1;
+ while(iend - ip >= 4)
+ {
+  n = get16(ip);
+  if(n == 0) return size;
+  if(n > ZXLZ_BLOCK) return -1;
+  size += n;
+  ip += 4 + (get16(ip + 2) & ~STORED);
+ }
+ return -1;
+}
+
+//unpacks the file into size bytes of out, what doesn't fit is left
+//out. Returns the bytes unpacked, -1 if it's broken
+int zxlz_uncompress(unsigned char *out, int size, const unsigned char *in, int length)
+{
+ const unsigned char *ip = in + 4, *iend = in + length;
+ unsigned char *op = out, *tmp;
+ int n, packed, ok;
+
+ if(!zxlz_is(in, length)) return -1;
+ while(iend - ip >= 4)
+ {
+  n = get16(ip);
+  packed = get16(ip + 2);
+  ip += 4;
+  if(n == 0) return op - out;
+  if(n > ZXLZ_BLOCK || (packed & ~STORED) > iend - ip) return -1;
+  if(op + n > out + size)
+  {
+   //the last block that fits in part goes through a whole one
+   tmp = (unsigned char *)malloc(n);
+   if(tmp == NULL) return -1;
+   if(packed & STORED)
+   {
+    ok = (packed & ~STORED) == n;
+    if(ok) memcpy(tmp, ip, n);
+   }
+   else ok = zxlz_unpack(tmp, n, ip, packed);
+   memcpy(op, tmp, out + size - op);
+   free(tmp);
+   return ok ? size : -1;
+  }
+  if(packed & STORED)
+  {
+   if((packed & ~STORED) != n) return -1;
+   memcpy(op, ip, n);
+  }
+  else if(!zxlz_unpack(op, n, ip, packed)) return -1;
+  op += n;
+  ip += packed & ~STORED;
+ }
+ return -1;
+}
@@ -33,6 +33,20 @@ int tape_playing;
 int tape_microphone;
 int tape_edge_tstates_target;
 int tape_edge_tstates_current;
+/* set when the tape starts, stops or jumps to an edge in the middle of a
+   core's run (an IN does that), so the core returns and JustRun() works
+   out the next edge again */
+int tape_reschedule;
+
+/* the tape of the selected machine, see ZX_SelectMachine */
+MachineVar tape_vars[] =
+{
+  MACHINE_VAR(tape),
+  MACHINE_VAR(tape_playing), MACHINE_VAR(tape_microphone),
+  MACHINE_VAR(tape_edge_tstates_target),
+  MACHINE_VAR(tape_edge_tstates_current),
+  { NULL, 0 }
+};
 
 
 static int
@@ -160,6 +174,8 @@ tape_play( int autoplay )
    tape_edge_tstates_target = edge_tstates;
       
    tape_edge_tstates_current=0; 
+   tstates_prev_A = spectrumZ80->IPeriod - spectrumZ80->ICount;
+   tape_reschedule = 1;
     
    if( error ) return error;
   
@@ -192,6 +208,7 @@ int tape_stop( void )
     tape_playing = 0;
     tape_edge_tstates_target=0;
     tape_edge_tstates_current=0;
+    tape_reschedule = 1;
     
     if(mconfig.flash_loading) ZX_Patch_ROM();//enable flash loading traps again
         
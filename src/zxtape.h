@@ -41,6 +41,7 @@ extern int tape_microphone;
 extern int tape_playing;
 extern int tape_edge_tstates_target;
 extern int tape_edge_tstates_current;
+extern int tape_reschedule;
 
 
 #endif